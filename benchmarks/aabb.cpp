@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+
+#include <vmmlib/aabb.hpp>
+#include <vmmlib/obb.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+std::vector< float > _points( const size_t n )
+{
+    std::vector< float > xyz( n * 3 );
+    for( size_t i = 0; i < xyz.size(); ++i )
+        xyz[ i ] = random_value( -100.f, 100.f );
+    return xyz;
+}
+
+void _merge_points( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< float > xyz = _points( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        const AABBf aabb = AABBf::fromPoints( xyz.data(), n );
+        do_not_optimize( aabb );
+    }
+}
+
+void _merge_points_parallel( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< float > xyz = _points( n );
+    const ExecutionPolicy policy = ExecutionPolicy::parallel();
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        AABBf aabb;
+        aabb.mergePoints( xyz.data(), n, 3, policy );
+        do_not_optimize( aabb );
+    }
+}
+
+void _merge_boxes( State& state )
+{
+    const size_t n = state.get_arg();
+    std::vector< AABBf > boxes( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        const Vector3f center( random_value( -100.f, 100.f ),
+                               random_value( -100.f, 100.f ),
+                               random_value( -100.f, 100.f ));
+        boxes[ i ] = AABBf( center - 1.f, center + 1.f );
+    }
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        AABBf aabb;
+        aabb.merge( boxes.data(), n );
+        do_not_optimize( aabb );
+    }
+}
+
+void _contains_points( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< float > xyz = _points( n );
+    const AABBf aabb( Vector3f( -50.f ), Vector3f( 50.f ));
+    std::vector< uint8_t > mask( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        aabb.containsPoints( xyz.data(), n, mask.data( ));
+        do_not_optimize( mask.front( ));
+    }
+}
+
+void _intersects( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< float > minimum = _points( n );
+    std::vector< float > maximum( minimum );
+    for( size_t i = 0; i < maximum.size(); ++i )
+        maximum[ i ] += 10.f;
+
+    // structure-of-arrays layout
+    std::vector< float > soa( n * 6 );
+    for( size_t i = 0; i < n; ++i )
+        for( size_t j = 0; j < 3; ++j )
+        {
+            soa[ j * n + i ] = minimum[ i * 3 + j ];
+            soa[( j + 3 ) * n + i ] = maximum[ i * 3 + j ];
+        }
+
+    const AABBf aabb( Vector3f( -50.f ), Vector3f( 50.f ));
+    std::vector< size_t > indices( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        const size_t count = aabb.intersects( &soa[ 0 ], &soa[ n ],
+                                              &soa[ 2 * n ], &soa[ 3 * n ],
+                                              &soa[ 4 * n ], &soa[ 5 * n ],
+                                              n, indices.data( ));
+        do_not_optimize( count );
+    }
+}
+
+void _obb_from_points( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< float > xyz = _points( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        const OBBf obb = OBBf::fromPoints( xyz.data(), n );
+        do_not_optimize( obb );
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "aabb_from_points", &_merge_points, { 64, 4096, 262144 } );
+VMMLIB_BENCHMARK( "aabb_from_points_parallel", &_merge_points_parallel,
+                  { 262144, 4194304 } );
+VMMLIB_BENCHMARK( "aabb_merge_boxes", &_merge_boxes, { 64, 4096 } );
+VMMLIB_BENCHMARK( "aabb_contains_points", &_contains_points, { 4096 } );
+VMMLIB_BENCHMARK( "aabb_intersects", &_intersects, { 4096 } );
+VMMLIB_BENCHMARK( "obb_from_points", &_obb_from_points, { 4096 } );
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__BENCHMARK__HPP
+#define VMMLIB__BENCHMARK__HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+/**
+ * A minimal microbenchmark harness in the style of Google Benchmark.
+ *
+ * A benchmark is a function taking a State, which times the loop
+ * while( state.keep_running( )) { ... }. Benchmarks register themselves with
+ * VMMLIB_BENCHMARK, optionally once per argument, which the function reads
+ * with State::get_arg(). The runner in main.cpp picks the number of
+ * iterations, repeats the measurement and reports ns/op and throughput.
+ */
+namespace vmml
+{
+namespace benchmark
+{
+
+class State
+{
+public:
+    State( const size_t iterations, const size_t arg )
+        : _iterations( iterations ), _remaining( iterations ), _arg( arg )
+        , _items_per_iteration( 1 ), _started( false )
+    {}
+
+    /** @return true while the timed loop should run. */
+    bool keep_running()
+    {
+        if( !_started )
+        {
+            _started = true;
+            _begin = std::chrono::steady_clock::now();
+        }
+        if( _remaining == 0 )
+        {
+            _end = std::chrono::steady_clock::now();
+            return false;
+        }
+        --_remaining;
+        return true;
+    }
+
+    size_t get_iterations() const { return _iterations; }
+
+    /** @return the registered argument, e.g., the batch size. */
+    size_t get_arg() const { return _arg; }
+
+    /** Set the number of items, e.g., batch elements, per iteration. */
+    void set_items_per_iteration( const size_t items )
+        { _items_per_iteration = items; }
+    size_t get_items_per_iteration() const { return _items_per_iteration; }
+
+    /** @return the time of the timed loop in seconds. */
+    double get_seconds() const
+        { return std::chrono::duration< double >( _end - _begin ).count(); }
+
+private:
+    const size_t _iterations;
+    size_t _remaining;
+    const size_t _arg;
+    size_t _items_per_iteration;
+    bool _started;
+    std::chrono::steady_clock::time_point _begin;
+    std::chrono::steady_clock::time_point _end;
+};
+
+typedef void ( *Function )( State& );
+
+struct Benchmark
+{
+    std::string name;
+    Function function;
+    size_t arg;
+};
+
+inline std::vector< Benchmark >& get_benchmarks()
+{
+    static std::vector< Benchmark > benchmarks;
+    return benchmarks;
+}
+
+/** Registers a benchmark at static initialization, once per argument. */
+class Registrar
+{
+public:
+    Registrar( const char* name, const Function function,
+               const std::initializer_list< size_t > args = { 0 } )
+    {
+        for( const size_t arg : args )
+        {
+            std::string fullName( name );
+            if( args.size() > 1 || arg != 0 )
+                fullName += "/" + std::to_string( arg );
+            get_benchmarks().push_back( Benchmark{ fullName, function, arg });
+        }
+    }
+};
+
+/** @return a pseudo-random value in [min, max]. */
+template< typename T > inline T random_value( const T min, const T max )
+{
+    return min + ( max - min ) * T( std::rand( )) / T( RAND_MAX );
+}
+
+/** Prevent the compiler from optimizing away or hoisting a value. */
+template< typename T > inline void do_not_optimize( T& value )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    asm volatile( "" : "+m"( value ) : : "memory" );
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast< volatile const char* >( &value );
+#endif
+}
+
+template< typename T > inline void do_not_optimize( const T& value )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    asm volatile( "" : : "m"( value ) : "memory" );
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast< volatile const char* >( &value );
+#endif
+}
+
+} // namespace benchmark
+} // namespace vmml
+
+#define VMMLIB_BENCHMARK_CONCAT_( a, b ) a ## b
+#define VMMLIB_BENCHMARK_CONCAT( a, b ) VMMLIB_BENCHMARK_CONCAT_( a, b )
+
+/**
+ * Register a benchmark: VMMLIB_BENCHMARK( name, function[, { args }] ).
+ * The function may be a template instantiation containing commas.
+ */
+#define VMMLIB_BENCHMARK( name, ... )                                   \
+    static const ::vmml::benchmark::Registrar                           \
+        VMMLIB_BENCHMARK_CONCAT( _registrar, __LINE__ )( name, __VA_ARGS__ )
+
+#endif // include protection
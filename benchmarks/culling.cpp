@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+
+#include <vmmlib/frustum.hpp>
+#include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/frustum_grid.hpp>
+#include <vmmlib/multi_frustum_culler.hpp>
+#include <vmmlib/occlusion_buffer.hpp>
+
+#include <vector>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+const Frustumf _frustum( -1.f, 1.f, -1.f, 1.f, 1.f, 100.f );
+
+Matrix4f _matrix( const float angle )
+{
+    Matrix4f view;
+    view.rotate_y( angle );
+    return _frustum.compute_matrix() * view;
+}
+
+std::vector< Vector4f > _spheres( const size_t n )
+{
+    std::vector< Vector4f > spheres( n );
+    for( size_t i = 0; i < n; ++i )
+        spheres[ i ] = Vector4f( random_value( -100.f, 100.f ),
+                                 random_value( -100.f, 100.f ),
+                                 random_value( -100.f, 100.f ),
+                                 random_value( .1f, 5.f ));
+    return spheres;
+}
+
+std::vector< AABBf > _boxes( const size_t n )
+{
+    const std::vector< Vector4f > spheres = _spheres( n );
+    std::vector< AABBf > boxes( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        const Vector3f center = spheres[ i ].get_sub_vector< 3 >();
+        boxes[ i ] = AABBf( center - spheres[ i ].w(),
+                            center + spheres[ i ].w( ));
+    }
+    return boxes;
+}
+
+void _test_spheres( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< Vector4f > spheres = _spheres( n );
+    FrustumCullerf culler;
+    culler.setup( _matrix( .5f ));
+    std::vector< Visibility > result( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        for( size_t i = 0; i < n; ++i )
+            result[ i ] = culler.test_sphere( spheres[ i ] );
+        do_not_optimize( result.front( ));
+    }
+}
+
+void _setup( State& state )
+{
+    const Matrix4f matrix = _matrix( .5f );
+    FrustumCullerf culler;
+    while( state.keep_running( ))
+    {
+        culler.setup( matrix );
+        do_not_optimize( culler );
+    }
+}
+
+template< bool exact > void _test_aabbs( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< AABBf > boxes = _boxes( n );
+    FrustumCullerf culler;
+    culler.setup( _matrix( .5f ));
+    std::vector< Visibility > result( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        culler.test_aabbs( boxes.data(), n, result.data(), exact );
+        do_not_optimize( result.front( ));
+    }
+}
+
+void _test_aabbs_projected( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< AABBf > boxes = _boxes( n );
+    FrustumCullerf culler;
+    culler.setup( _matrix( .5f ));
+    std::vector< Visibility > result( n );
+    std::vector< float > radius( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        culler.test_aabbs( boxes.data(), n, Vector2f( 1920.f, 1080.f ),
+                           result.data(), radius.data( ));
+        do_not_optimize( radius.front( ));
+    }
+}
+
+void _multi_test_aabbs( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< AABBf > boxes = _boxes( n );
+    MultiFrustumCuller< float, 8 > culler;
+    for( size_t i = 0; i < 8; ++i )
+        culler.setup( i, _matrix( float( i ) * .785f ));
+    std::vector< uint64_t > visible( n ), full( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        culler.test_aabbs( boxes.data(), n, visible.data(), full.data( ));
+        do_not_optimize( visible.front( ));
+    }
+}
+
+void _grid_ranges( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< Vector4f > spheres = _spheres( n );
+    const FrustumGridf grid( _frustum, 16, 8, 24 );
+    FrustumGridf::index3 begin, end;
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        size_t count = 0;
+        for( size_t i = 0; i < n; ++i )
+            count += grid.get_ranges( spheres[ i ], begin, end );
+        do_not_optimize( count );
+    }
+}
+
+void _occlusion( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< AABBf > boxes = _boxes( n );
+    OcclusionBufferf buffer( 256, 128 );
+    buffer.setup( _matrix( 0.f ));
+    for( size_t i = 0; i < 16; ++i )
+    {
+        const Vector3f center( random_value( -20.f, 20.f ),
+                               random_value( -20.f, 20.f ),
+                               random_value( -40.f, -10.f ));
+        buffer.add_occluder( AABBf( center - 4.f, center + 4.f ));
+    }
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        size_t count = 0;
+        for( size_t i = 0; i < n; ++i )
+            count += buffer.is_occluded( boxes[ i ] );
+        do_not_optimize( count );
+    }
+}
+
+void _occluders( State& state )
+{
+    OcclusionBufferf buffer( 256, 128 );
+    const std::vector< AABBf > boxes = _boxes( state.get_arg( ));
+    buffer.setup( _matrix( 0.f ));
+    state.set_items_per_iteration( boxes.size( ));
+    while( state.keep_running( ))
+    {
+        buffer.clear();
+        for( size_t i = 0; i < boxes.size(); ++i )
+            buffer.add_occluder( boxes[ i ] );
+        do_not_optimize( buffer );
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "frustum_culler_setup", &_setup );
+VMMLIB_BENCHMARK( "frustum_culler_test_spheres", &_test_spheres, { 4096 } );
+VMMLIB_BENCHMARK( "frustum_culler_test_aabbs", &_test_aabbs< false >,
+                  { 4096 } );
+VMMLIB_BENCHMARK( "frustum_culler_test_aabbs_exact", &_test_aabbs< true >,
+                  { 4096 } );
+VMMLIB_BENCHMARK( "frustum_culler_test_aabbs_projected",
+                  &_test_aabbs_projected, { 4096 } );
+VMMLIB_BENCHMARK( "multi_frustum_culler_test_aabbs<8>", &_multi_test_aabbs,
+                  { 4096 } );
+VMMLIB_BENCHMARK( "frustum_grid_ranges", &_grid_ranges, { 4096 } );
+VMMLIB_BENCHMARK( "occlusion_buffer_is_occluded", &_occlusion, { 4096 } );
+VMMLIB_BENCHMARK( "occlusion_buffer_add_occluders", &_occluders, { 64 } );
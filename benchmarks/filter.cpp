@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+
+#include <vmmlib/lowpass_filter.hpp>
+#include <vmmlib/lowpass_filter_bank.hpp>
+#include <vmmlib/one_euro_filter.hpp>
+#include <vmmlib/quaternion_filter.hpp>
+
+#include <vector>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+template< LowpassMode mode > void _lowpass( State& state )
+{
+    LowpassFilter< 16, Vector3f > filter( .5f, mode );
+    Vector3f sample( 1.f, 2.f, 3.f );
+    while( state.keep_running( ))
+    {
+        do_not_optimize( sample );
+        const Vector3f result = filter.add( sample );
+        do_not_optimize( result );
+    }
+}
+
+template< LowpassMode mode > void _lowpass_bank( State& state )
+{
+    const size_t n = state.get_arg();
+    LowpassFilterBank< 16, float > bank( n, .5f, mode );
+    std::vector< float > frame( n );
+    for( size_t i = 0; i < n; ++i )
+        frame[ i ] = random_value( -1.f, 1.f );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        do_not_optimize( frame.front( ));
+        const float* result = bank.add( frame.data( ));
+        do_not_optimize( *result );
+    }
+}
+
+void _quaternion_filter( State& state )
+{
+    QuaternionFilterf filter( .5f );
+    Quaternionf sample( 0.f, 0.f, .6f, .8f );
+    while( state.keep_running( ))
+    {
+        do_not_optimize( sample );
+        const Quaternionf result = filter.add( sample );
+        do_not_optimize( result );
+    }
+}
+
+void _one_euro( State& state )
+{
+    OneEuroFilter< Vector3f > filter( 1.f, .5f );
+    Vector3f sample( 1.f, 2.f, 3.f );
+    while( state.keep_running( ))
+    {
+        do_not_optimize( sample );
+        const Vector3f result = filter.add( sample, .001f );
+        do_not_optimize( result );
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "lowpass_filter_window<16>", &_lowpass< LOWPASS_WINDOW > );
+VMMLIB_BENCHMARK( "lowpass_filter_exponential",
+                  &_lowpass< LOWPASS_EXPONENTIAL > );
+VMMLIB_BENCHMARK( "lowpass_filter_bank_window<16>",
+                  &_lowpass_bank< LOWPASS_WINDOW >, { 1024 } );
+VMMLIB_BENCHMARK( "lowpass_filter_bank_exponential",
+                  &_lowpass_bank< LOWPASS_EXPONENTIAL >, { 1024 } );
+VMMLIB_BENCHMARK( "quaternion_filter", &_quaternion_filter );
+VMMLIB_BENCHMARK( "one_euro_filter<Vector3f>", &_one_euro );
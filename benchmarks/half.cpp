@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+
+#include <vmmlib/half.hpp>
+
+#include <vector>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+template< typename T > void _to_float( State& state )
+{
+    const size_t n = state.get_arg();
+    std::vector< T > in( n );
+    for( size_t i = 0; i < n; ++i )
+        in[ i ] = random_value( -100.f, 100.f );
+    std::vector< float > out( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        convert( in.data(), out.data(), n );
+        do_not_optimize( out.front( ));
+    }
+}
+
+template< typename T > void _from_float( State& state )
+{
+    const size_t n = state.get_arg();
+    std::vector< float > in( n );
+    for( size_t i = 0; i < n; ++i )
+        in[ i ] = random_value( -100.f, 100.f );
+    std::vector< T > out( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        convert( in.data(), out.data(), n );
+        do_not_optimize( out.front( ));
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "half_to_float", &_to_float< half >, { 65536 } );
+VMMLIB_BENCHMARK( "half_from_float", &_from_float< half >, { 65536 } );
+VMMLIB_BENCHMARK( "bfloat16_to_float", &_to_float< bfloat16 >, { 65536 } );
+VMMLIB_BENCHMARK( "bfloat16_from_float", &_from_float< bfloat16 >, { 65536 } );
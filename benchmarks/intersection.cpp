@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+
+#include <vmmlib/intersection.hpp>
+
+#include <vector>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+template< typename T > void _ray_spheres( State& state )
+{
+    const size_t n = state.get_arg();
+    std::vector< Vector< 4, T > > spheres( n );
+    for( size_t i = 0; i < n; ++i )
+        spheres[ i ] = Vector< 4, T >( random_value< T >( -10, 10 ),
+                                       random_value< T >( -10, 10 ),
+                                       random_value< T >( -100, -10 ),
+                                       random_value< T >( 1, 5 ));
+    const Intersection< T > ray( Vector< 3, T >::ZERO,
+                                 Vector< 3, T >( 0, 0, -1 ));
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        size_t hits = 0;
+        T t;
+        for( size_t i = 0; i < n; ++i )
+            hits += ray.test_sphere( spheres[ i ], t );
+        do_not_optimize( hits );
+    }
+}
+
+template< typename T > void _ray_aabbs( State& state )
+{
+    const size_t n = state.get_arg();
+    std::vector< AABB< T > > boxes( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        const Vector< 3, T > center( random_value< T >( -10, 10 ),
+                                     random_value< T >( -10, 10 ),
+                                     random_value< T >( -100, -10 ));
+        boxes[ i ] = AABB< T >( center - T( 2 ), center + T( 2 ));
+    }
+    const Intersection< T > ray( Vector< 3, T >::ZERO,
+                                 Vector< 3, T >( 0, 0, -1 ));
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        size_t hits = 0;
+        T t;
+        for( size_t i = 0; i < n; ++i )
+            hits += ray.test_aabb( boxes[ i ], t );
+        do_not_optimize( hits );
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "intersection_ray_spheres<float>", &_ray_spheres< float >,
+                  { 4096 } );
+VMMLIB_BENCHMARK( "intersection_ray_spheres<double>",
+                  &_ray_spheres< double >, { 4096 } );
+VMMLIB_BENCHMARK( "intersection_ray_aabbs<float>", &_ray_aabbs< float >,
+                  { 4096 } );
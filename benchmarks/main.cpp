@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+#include "statistics.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace vmml::benchmark;
+
+namespace
+{
+struct Options
+{
+    Options() : min_time( .1 ), repetitions( 5 ), margin( .1 ) {}
+
+    std::string filter;
+    std::string out;
+    std::string baseline;
+    double min_time;
+    size_t repetitions;
+    double margin;
+};
+
+struct Result
+{
+    std::string name;
+    size_t iterations;
+    size_t items_per_iteration;
+    std::vector< double > ns_per_op; // one per repetition
+    double median_ns_per_op;
+    double items_per_second;
+};
+
+void _usage( const char* name )
+{
+    std::cout
+        << "Usage: " << name << " [options]" << std::endl
+        << "  --filter=<text>     run benchmarks whose name contains text"
+        << std::endl
+        << "  --min_time=<s>      minimum time per repetition, default 0.1"
+        << std::endl
+        << "  --repetitions=<n>   measurements per benchmark, default 5"
+        << std::endl
+        << "  --out=<file>        write the results as JSON to file"
+        << std::endl
+        << "  --baseline=<file>   compare with the results in a JSON file, fail"
+        << std::endl
+        << "                      if a benchmark is significantly slower"
+        << std::endl
+        << "  --margin=<r>        tolerated slowdown, default 0.1 (10%)"
+        << std::endl
+        << "  --list              list the benchmarks and exit" << std::endl;
+}
+
+bool _parse( const std::string& arg, const std::string& option,
+             std::string& value )
+{
+    const std::string prefix = "--" + option + "=";
+    if( arg.compare( 0, prefix.size(), prefix ) != 0 )
+        return false;
+    value = arg.substr( prefix.size( ));
+    return true;
+}
+
+double _measure( const Benchmark& benchmark, const size_t iterations,
+                 size_t& items_per_iteration )
+{
+    State state( iterations, benchmark.arg );
+    benchmark.function( state );
+    items_per_iteration = state.get_items_per_iteration();
+    return state.get_seconds();
+}
+
+Result _run( const Benchmark& benchmark, const Options& options )
+{
+    Result result;
+    result.name = benchmark.name;
+
+    // grow the iteration count until one measurement takes min_time
+    size_t iterations = 1;
+    for( ;; )
+    {
+        const double seconds = _measure( benchmark, iterations,
+                                         result.items_per_iteration );
+        if( seconds >= options.min_time || iterations >= 1000000000 )
+            break;
+
+        const double scale = seconds > 0 ? options.min_time * 1.4 / seconds :
+                                           10.;
+        iterations = std::max( iterations + 1, size_t( double( iterations ) *
+                                                      std::min( scale, 10. )));
+    }
+    result.iterations = iterations;
+
+    for( size_t i = 0; i < options.repetitions; ++i )
+    {
+        const double seconds = _measure( benchmark, iterations,
+                                         result.items_per_iteration );
+        result.ns_per_op.push_back( seconds * 1e9 / double( iterations ));
+    }
+    result.median_ns_per_op = median( result.ns_per_op );
+    result.items_per_second = result.items_per_iteration * 1e9 /
+                              result.median_ns_per_op;
+    return result;
+}
+
+void _writeJSON( std::ostream& os, const std::vector< Result >& results )
+{
+    char date[ 32 ];
+    const std::time_t now = std::time( 0 );
+    std::strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%S",
+                   std::localtime( &now ));
+
+    os << std::setprecision( 10 )
+       << "{" << std::endl
+       << "  \"context\": {" << std::endl
+       << "    \"date\": \"" << date << "\"," << std::endl
+       << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ","
+       << std::endl
+#ifdef NDEBUG
+       << "    \"build_type\": \"release\"" << std::endl
+#else
+       << "    \"build_type\": \"debug\"" << std::endl
+#endif
+       << "  }," << std::endl
+       << "  \"benchmarks\": [" << std::endl;
+
+    for( size_t i = 0; i < results.size(); ++i )
+    {
+        const Result& result = results[ i ];
+        os << "    {" << std::endl
+           << "      \"name\": \"" << result.name << "\"," << std::endl
+           << "      \"iterations\": " << result.iterations << "," << std::endl
+           << "      \"items_per_iteration\": " << result.items_per_iteration
+           << "," << std::endl
+           << "      \"ns_per_op\": [";
+        for( size_t j = 0; j < result.ns_per_op.size(); ++j )
+            os << ( j ? ", " : "" ) << result.ns_per_op[ j ];
+        os << "]," << std::endl
+           << "      \"median_ns_per_op\": " << result.median_ns_per_op << ","
+           << std::endl
+           << "      \"items_per_second\": " << result.items_per_second
+           << std::endl
+           << "    }" << ( i + 1 < results.size() ? "," : "" ) << std::endl;
+    }
+    os << "  ]" << std::endl << "}" << std::endl;
+}
+
+/** Read the name and ns_per_op of all benchmarks written by _writeJSON. */
+bool _readJSON( const std::string& filename, std::vector< Result >& results )
+{
+    std::ifstream file( filename.c_str( ));
+    if( !file )
+        return false;
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string json = stream.str();
+
+    const std::string nameKey = "\"name\": \"";
+    const std::string samplesKey = "\"ns_per_op\": [";
+    size_t pos = json.find( nameKey );
+    while( pos != std::string::npos )
+    {
+        Result result;
+        pos += nameKey.size();
+        const size_t nameEnd = json.find( '"', pos );
+        const size_t samples = json.find( samplesKey, pos );
+        if( nameEnd == std::string::npos || samples == std::string::npos )
+            return false;
+        result.name = json.substr( pos, nameEnd - pos );
+
+        const size_t begin = samples + samplesKey.size();
+        const size_t end = json.find( ']', begin );
+        if( end == std::string::npos )
+            return false;
+
+        std::istringstream values( json.substr( begin, end - begin ));
+        double value;
+        char separator;
+        while( values >> value )
+        {
+            result.ns_per_op.push_back( value );
+            values >> separator;
+        }
+        results.push_back( result );
+        pos = json.find( nameKey, samples );
+    }
+    return true;
+}
+
+/** @return false if any benchmark regressed against the baseline. */
+bool _compare( const std::vector< Result >& baseline,
+               const std::vector< Result >& results, const double margin )
+{
+    std::cout << std::endl << std::left << std::setw( 48 ) << "Benchmark"
+              << std::right << std::setw( 14 ) << "baseline" << std::setw( 14 )
+              << "ns/op" << std::setw( 16 ) << "change" << "  status"
+              << std::endl << std::string( 100, '-' ) << std::endl;
+
+    bool ok = true;
+    for( const Result& result : results )
+    {
+        std::vector< Result >::const_iterator base = baseline.begin();
+        while( base != baseline.end() && base->name != result.name )
+            ++base;
+        if( base == baseline.end( ))
+        {
+            std::cout << std::left << std::setw( 48 ) << result.name
+                      << std::right << std::setw( 46 ) << "" << "  new"
+                      << std::endl;
+            continue;
+        }
+
+        const Comparison comparison( base->ns_per_op, result.ns_per_op,
+                                     margin );
+        std::ostringstream change;
+        change << std::fixed << std::setprecision( 1 ) << std::showpos
+               << comparison.change * 100. << std::noshowpos << "+-"
+               << comparison.confidence * 100. << "%";
+
+        std::cout << std::left << std::setw( 48 ) << result.name << std::right
+                  << std::fixed << std::setprecision( 2 ) << std::setw( 14 )
+                  << comparison.baseline << std::setw( 14 )
+                  << comparison.current << std::setw( 16 ) << change.str()
+                  << ( comparison.regression ? "  REGRESSION" :
+                       comparison.improvement ? "  improved" : "  ok" )
+                  << std::endl;
+        ok = ok && !comparison.regression;
+    }
+    return ok;
+}
+}
+
+int main( int argc, char* argv[] )
+{
+    Options options;
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg( argv[ i ] );
+        std::string value;
+        if( arg == "--help" || arg == "-h" )
+        {
+            _usage( argv[ 0 ] );
+            return EXIT_SUCCESS;
+        }
+        if( arg == "--list" )
+        {
+            for( const Benchmark& benchmark : get_benchmarks( ))
+                std::cout << benchmark.name << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if( _parse( arg, "filter", value ))
+            options.filter = value;
+        else if( _parse( arg, "out", value ))
+            options.out = value;
+        else if( _parse( arg, "baseline", value ))
+            options.baseline = value;
+        else if( _parse( arg, "margin", value ))
+            options.margin = std::atof( value.c_str( ));
+        else if( _parse( arg, "min_time", value ))
+            options.min_time = std::atof( value.c_str( ));
+        else if( _parse( arg, "repetitions", value ))
+            options.repetitions = std::max( 1, std::atoi( value.c_str( )));
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            _usage( argv[ 0 ] );
+            return EXIT_FAILURE;
+        }
+    }
+
+#ifndef NDEBUG
+    std::cerr << "Warning: benchmarks built without optimization" << std::endl;
+#endif
+
+    std::vector< Result > baseline;
+    if( !options.baseline.empty() && !_readJSON( options.baseline, baseline ))
+    {
+        std::cerr << "Can't read baseline " << options.baseline << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::left << std::setw( 48 ) << "Benchmark" << std::right
+              << std::setw( 14 ) << "ns/op" << std::setw( 14 ) << "items/s"
+              << std::setw( 14 ) << "iterations" << std::endl
+              << std::string( 90, '-' ) << std::endl;
+
+    std::vector< Result > results;
+    for( const Benchmark& benchmark : get_benchmarks( ))
+    {
+        if( benchmark.name.find( options.filter ) == std::string::npos )
+            continue;
+
+        results.push_back( _run( benchmark, options ));
+        const Result& result = results.back();
+        std::cout << std::left << std::setw( 48 ) << result.name << std::right
+                  << std::fixed << std::setprecision( 2 ) << std::setw( 14 )
+                  << result.median_ns_per_op << std::scientific
+                  << std::setw( 14 ) << result.items_per_second
+                  << std::setw( 14 ) << result.iterations << std::endl;
+    }
+
+    if( !options.out.empty( ))
+    {
+        std::ofstream file( options.out.c_str( ));
+        if( !file )
+        {
+            std::cerr << "Can't write " << options.out << std::endl;
+            return EXIT_FAILURE;
+        }
+        _writeJSON( file, results );
+    }
+
+    if( !options.baseline.empty() &&
+        !_compare( baseline, results, options.margin ))
+    {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+
+#include <vmmlib/matrix.hpp>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+template< size_t M, typename T > Matrix< M, M, T > _matrix()
+{
+    // diagonally dominant, hence well-conditioned and invertible
+    Matrix< M, M, T > matrix;
+    for( size_t i = 0; i < M * M; ++i )
+        matrix.array[ i ] = random_value< T >( -1, 1 );
+    for( size_t i = 0; i < M; ++i )
+        matrix.array[ i * M + i ] += T( M );
+    return matrix;
+}
+
+template< size_t M, typename T > void _multiply( State& state )
+{
+    Matrix< M, M, T > a = _matrix< M, T >();
+    Matrix< M, M, T > b = _matrix< M, T >();
+    while( state.keep_running( ))
+    {
+        do_not_optimize( a );
+        do_not_optimize( b );
+        const Matrix< M, M, T > result = a * b;
+        do_not_optimize( result );
+    }
+}
+
+template< size_t M, typename T > void _multiply_parallel( State& state )
+{
+    static Matrix< M, M, T > a = _matrix< M, T >();
+    static Matrix< M, M, T > b = _matrix< M, T >();
+    static Matrix< M, M, T > result;
+    const ExecutionPolicy policy = ExecutionPolicy::parallel();
+    while( state.keep_running( ))
+    {
+        do_not_optimize( a );
+        do_not_optimize( b );
+        result.multiply( a, b, policy );
+        do_not_optimize( result );
+    }
+}
+
+template< size_t M, typename T > void _multiply_vector( State& state )
+{
+    Matrix< M, M, T > a = _matrix< M, T >();
+    Vector< M, T > v( T( 1 ));
+    while( state.keep_running( ))
+    {
+        do_not_optimize( a );
+        do_not_optimize( v );
+        const Vector< M, T > result = a * v;
+        do_not_optimize( result );
+    }
+}
+
+template< size_t M, typename T > void _inverse( State& state )
+{
+    Matrix< M, M, T > a = _matrix< M, T >();
+    Matrix< M, M, T > result;
+    while( state.keep_running( ))
+    {
+        do_not_optimize( a );
+        const bool invertible = compute_inverse( a, result );
+        do_not_optimize( invertible );
+        do_not_optimize( result );
+    }
+}
+
+template< size_t M, typename T > void _determinant( State& state )
+{
+    Matrix< M, M, T > a = _matrix< M, T >();
+    while( state.keep_running( ))
+    {
+        do_not_optimize( a );
+        const T determinant = compute_determinant( a );
+        do_not_optimize( determinant );
+    }
+}
+
+template< size_t M, typename T > void _transpose( State& state )
+{
+    Matrix< M, M, T > a = _matrix< M, T >();
+    while( state.keep_running( ))
+    {
+        do_not_optimize( a );
+        const Matrix< M, M, T > result = transpose( a );
+        do_not_optimize( result );
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "matrix_multiply<3,float>", &_multiply< 3, float > );
+VMMLIB_BENCHMARK( "matrix_multiply<3,double>", &_multiply< 3, double > );
+VMMLIB_BENCHMARK( "matrix_multiply<4,float>", &_multiply< 4, float > );
+VMMLIB_BENCHMARK( "matrix_multiply<4,double>", &_multiply< 4, double > );
+VMMLIB_BENCHMARK( "matrix_multiply_parallel<128,float>",
+                  &_multiply_parallel< 128, float > );
+VMMLIB_BENCHMARK( "matrix_multiply_vector<3,float>",
+                  &_multiply_vector< 3, float > );
+VMMLIB_BENCHMARK( "matrix_multiply_vector<4,float>",
+                  &_multiply_vector< 4, float > );
+VMMLIB_BENCHMARK( "matrix_multiply_vector<4,double>",
+                  &_multiply_vector< 4, double > );
+VMMLIB_BENCHMARK( "matrix_inverse<2,float>", &_inverse< 2, float > );
+VMMLIB_BENCHMARK( "matrix_inverse<3,float>", &_inverse< 3, float > );
+VMMLIB_BENCHMARK( "matrix_inverse<3,double>", &_inverse< 3, double > );
+VMMLIB_BENCHMARK( "matrix_inverse<4,float>", &_inverse< 4, float > );
+VMMLIB_BENCHMARK( "matrix_inverse<4,double>", &_inverse< 4, double > );
+VMMLIB_BENCHMARK( "matrix_determinant<3,float>", &_determinant< 3, float > );
+VMMLIB_BENCHMARK( "matrix_determinant<3,double>", &_determinant< 3, double > );
+VMMLIB_BENCHMARK( "matrix_determinant<4,float>", &_determinant< 4, float > );
+VMMLIB_BENCHMARK( "matrix_determinant<4,double>", &_determinant< 4, double > );
+VMMLIB_BENCHMARK( "matrix_transpose<4,float>", &_transpose< 4, float > );
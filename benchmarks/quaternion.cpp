@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+
+#include <vmmlib/quaternion.hpp>
+#include <vmmlib/quaternion_batch.hpp>
+
+#include <vector>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+template< typename T > Quaternion< T > _quaternion()
+{
+    Quaternion< T > q( random_value< T >( -1, 1 ), random_value< T >( -1, 1 ),
+                       random_value< T >( -1, 1 ), random_value< T >( -1, 1 ));
+    q.normalize();
+    return q;
+}
+
+template< typename T >
+std::vector< Quaternion< T > > _quaternions( const size_t n )
+{
+    std::vector< Quaternion< T > > quaternions( n );
+    for( size_t i = 0; i < n; ++i )
+        quaternions[ i ] = _quaternion< T >();
+    return quaternions;
+}
+
+template< typename T > QuaternionBatch< T > _batch( const size_t n )
+{
+    QuaternionBatch< T > batch;
+    const std::vector< Quaternion< T > > quaternions = _quaternions< T >( n );
+    batch.set( quaternions.data(), n );
+    return batch;
+}
+
+template< typename T > void _multiply( State& state )
+{
+    Quaternion< T > p = _quaternion< T >();
+    Quaternion< T > q = _quaternion< T >();
+    while( state.keep_running( ))
+    {
+        do_not_optimize( p );
+        do_not_optimize( q );
+        const Quaternion< T > result = p * q;
+        do_not_optimize( result );
+    }
+}
+
+template< typename T > void _rotate( State& state )
+{
+    Quaternion< T > q = _quaternion< T >();
+    Vector< 3, T > v( 1, 2, 3 );
+    while( state.keep_running( ))
+    {
+        do_not_optimize( q );
+        do_not_optimize( v );
+        const Vector< 3, T > result = q.rotate( v );
+        do_not_optimize( result );
+    }
+}
+
+template< typename T, Quaternion< T >( *interpolate )( T,
+                                                       const Quaternion< T >&,
+                                                       const Quaternion< T >& )>
+void _interpolate( State& state )
+{
+    Quaternion< T > p = _quaternion< T >();
+    Quaternion< T > q = _quaternion< T >();
+    T a = T( .3 );
+    while( state.keep_running( ))
+    {
+        do_not_optimize( p );
+        do_not_optimize( q );
+        do_not_optimize( a );
+        const Quaternion< T > result = interpolate( a, p, q );
+        do_not_optimize( result );
+    }
+}
+
+template< typename T >
+Quaternion< T > _slerp( T a, const Quaternion< T >& p, const Quaternion< T >& q )
+{
+    return Quaternion< T >::slerp( a, p, q );
+}
+
+template< typename T, bool branchless > void _from_matrix( State& state )
+{
+    Matrix< 3, 3, T > m;
+    _quaternion< T >().get_rotation_matrix( m );
+    Quaternion< T > result;
+    while( state.keep_running( ))
+    {
+        do_not_optimize( m );
+        if( branchless )
+            result.set_branchless( m );
+        else
+            result.set( m );
+        do_not_optimize( result );
+    }
+}
+
+template< typename T > void _batch_multiply( State& state )
+{
+    const size_t n = state.get_arg();
+    const QuaternionBatch< T > p = _batch< T >( n );
+    const QuaternionBatch< T > q = _batch< T >( n );
+    QuaternionBatch< T > result( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        result.multiply( p, q );
+        do_not_optimize( *result.x( ));
+    }
+}
+
+template< typename T > void _batch_rotate( State& state )
+{
+    const size_t n = state.get_arg();
+    const QuaternionBatch< T > q = _batch< T >( n );
+    std::vector< T > x( n, 1 ), y( n, 2 ), z( n, 3 );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        q.rotate( x.data(), y.data(), z.data( ));
+        do_not_optimize( x.front( ));
+    }
+}
+
+template< typename T, bool fast > void _batch_slerp( State& state )
+{
+    const size_t n = state.get_arg();
+    const QuaternionBatch< T > p = _batch< T >( n );
+    const QuaternionBatch< T > q = _batch< T >( n );
+    std::vector< T > a( n );
+    for( size_t i = 0; i < n; ++i )
+        a[ i ] = random_value< T >( 0, 1 );
+    QuaternionBatch< T > result( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        if( fast )
+            result.fast_slerp( p, q, a.data( ));
+        else
+            result.slerp( p, q, a.data( ));
+        do_not_optimize( *result.x( ));
+    }
+}
+
+template< typename T > void _batch_from_matrices( State& state )
+{
+    const size_t n = state.get_arg();
+    std::vector< Matrix< 3, 3, T > > matrices( n );
+    for( size_t i = 0; i < n; ++i )
+        _quaternion< T >().get_rotation_matrix( matrices[ i ] );
+    QuaternionBatch< T > result( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        result.set( matrices.data(), n );
+        do_not_optimize( *result.x( ));
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "quaternion_multiply<float>", &_multiply< float > );
+VMMLIB_BENCHMARK( "quaternion_multiply<double>", &_multiply< double > );
+VMMLIB_BENCHMARK( "quaternion_rotate<float>", &_rotate< float > );
+VMMLIB_BENCHMARK( "quaternion_slerp<float>",
+                  &_interpolate< float, &_slerp< float > > );
+VMMLIB_BENCHMARK( "quaternion_nlerp<float>",
+                  &_interpolate< float, &Quaternion< float >::nlerp > );
+VMMLIB_BENCHMARK( "quaternion_fast_slerp<float>",
+                  &_interpolate< float, &Quaternion< float >::fast_slerp > );
+VMMLIB_BENCHMARK( "quaternion_from_matrix<float>",
+                  &_from_matrix< float, false > );
+VMMLIB_BENCHMARK( "quaternion_from_matrix_branchless<float>",
+                  &_from_matrix< float, true > );
+VMMLIB_BENCHMARK( "quaternion_batch_multiply<float>",
+                  &_batch_multiply< float >, { 1024 } );
+VMMLIB_BENCHMARK( "quaternion_batch_rotate<float>", &_batch_rotate< float >,
+                  { 1024 } );
+VMMLIB_BENCHMARK( "quaternion_batch_slerp<float>",
+                  &_batch_slerp< float, false >, { 1024 } );
+VMMLIB_BENCHMARK( "quaternion_batch_fast_slerp<float>",
+                  &_batch_slerp< float, true >, { 1024 } );
+VMMLIB_BENCHMARK( "quaternion_batch_from_matrices<float>",
+                  &_batch_from_matrices< float >, { 1024 } );
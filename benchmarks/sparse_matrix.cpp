@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark.hpp"
+
+#include <vmmlib/sparse_matrix.hpp>
+
+#include <vector>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+// square matrix with 16 random non-zeros per row on average
+SparseMatrixf _random_matrix( const size_t n )
+{
+    std::vector< SparseMatrixf::Triplet > triplets;
+    triplets.reserve( n * 16 );
+    for( size_t i = 0; i < n * 16; ++i )
+        triplets.push_back( SparseMatrixf::Triplet(
+            size_t( random_value( 0.f, float( n ))) % n,
+            size_t( random_value( 0.f, float( n ))) % n,
+            random_value( -1.f, 1.f )));
+    return SparseMatrixf( n, n, triplets );
+}
+
+void _multiply( State& state, const ExecutionPolicy& policy )
+{
+    const size_t n = state.get_arg();
+    const SparseMatrixf matrix = _random_matrix( n );
+    std::vector< float > x( n );
+    for( size_t i = 0; i < n; ++i )
+        x[ i ] = random_value( -1.f, 1.f );
+    std::vector< float > y( n );
+    state.set_items_per_iteration( matrix.nnz( ));
+    while( state.keep_running( ))
+    {
+        matrix.multiply( x.data(), y.data(), policy );
+        do_not_optimize( y.front( ));
+    }
+}
+
+void _multiply_sequential( State& state )
+{
+    _multiply( state, ExecutionPolicy::sequential( ));
+}
+
+void _multiply_parallel( State& state )
+{
+    _multiply( state, ExecutionPolicy::parallel( ));
+}
+
+void _multiply_transposed( State& state )
+{
+    const size_t n = state.get_arg();
+    const SparseMatrixf matrix = _random_matrix( n );
+    std::vector< float > x( n );
+    for( size_t i = 0; i < n; ++i )
+        x[ i ] = random_value( -1.f, 1.f );
+    std::vector< float > y( n );
+    state.set_items_per_iteration( matrix.nnz( ));
+    while( state.keep_running( ))
+    {
+        matrix.multiply_transposed( x.data(), y.data( ));
+        do_not_optimize( y.front( ));
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "sparse_matrix_multiply", &_multiply_sequential,
+                  { 1024, 65536 } );
+VMMLIB_BENCHMARK( "sparse_matrix_multiply_parallel", &_multiply_parallel,
+                  { 65536 } );
+VMMLIB_BENCHMARK( "sparse_matrix_multiply_transposed", &_multiply_transposed,
+                  { 1024, 65536 } );
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__BENCHMARK_STATISTICS__HPP
+#define VMMLIB__BENCHMARK_STATISTICS__HPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vmml
+{
+namespace benchmark
+{
+
+inline double median( std::vector< double > values )
+{
+    if( values.empty( ))
+        return 0.;
+
+    std::sort( values.begin(), values.end( ));
+    const size_t n = values.size();
+    return n % 2 ? values[ n / 2 ] :
+                   ( values[ n / 2 - 1 ] + values[ n / 2 ] ) * .5;
+}
+
+/** @return the median absolute deviation from the median. */
+inline double mad( const std::vector< double >& values )
+{
+    const double center = median( values );
+    std::vector< double > deviations( values.size( ));
+    for( size_t i = 0; i < values.size(); ++i )
+        deviations[ i ] = std::abs( values[ i ] - center );
+    return median( deviations );
+}
+
+/**
+ * @return the standard error of the median, estimating the standard
+ *         deviation robustly from the MAD of normally distributed samples.
+ */
+inline double median_error( const std::vector< double >& values )
+{
+    if( values.empty( ))
+        return 0.;
+    const double sigma = 1.4826 * mad( values );
+    return 1.2533 * sigma / std::sqrt( double( values.size( )));
+}
+
+/** The change of a benchmark between a baseline and a current run. */
+struct Comparison
+{
+    Comparison( const std::vector< double >& baseline_ns,
+                const std::vector< double >& current_ns, const double margin,
+                const double z = 1.96 )
+        : baseline( median( baseline_ns ))
+        , current( median( current_ns ))
+    {
+        const double baselineError = median_error( baseline_ns );
+        const double currentError = median_error( current_ns );
+        const double difference = current - baseline;
+        const double interval = z * std::sqrt( baselineError * baselineError +
+                                               currentError * currentError );
+
+        change = baseline > 0 ? difference / baseline : 0.;
+        confidence = baseline > 0 ? interval / baseline : 0.;
+
+        // slower resp. faster by more than the margin, even at the favorable
+        // end of the confidence interval
+        regression = change - confidence > margin;
+        improvement = change + confidence < -margin;
+    }
+
+    double baseline;   //!< median ns/op of the baseline
+    double current;    //!< median ns/op of the current run
+    double change;     //!< relative change of the median
+    double confidence; //!< half width of the confidence interval of change
+    bool regression;
+    bool improvement;
+};
+
+} // namespace benchmark
+} // namespace vmml
+
+#endif // include protection
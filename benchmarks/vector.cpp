@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.hpp"
+
+#include <vmmlib/vector.hpp>
+
+#include <vector>
+
+using namespace vmml;
+using namespace vmml::benchmark;
+
+namespace
+{
+template< size_t M, typename T >
+std::vector< Vector< M, T > > _vectors( const size_t n )
+{
+    std::vector< Vector< M, T > > vectors( n );
+    for( size_t i = 0; i < n; ++i )
+        for( size_t j = 0; j < M; ++j )
+            vectors[ i ][ j ] = random_value< T >( -1, 1 );
+    return vectors;
+}
+
+template< size_t M, typename T > void _dot( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< Vector< M, T > > a = _vectors< M, T >( n );
+    const std::vector< Vector< M, T > > b = _vectors< M, T >( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        T sum = 0;
+        for( size_t i = 0; i < n; ++i )
+            sum += a[ i ].dot( b[ i ] );
+        do_not_optimize( sum );
+    }
+}
+
+template< typename T > void _cross( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< Vector< 3, T > > a = _vectors< 3, T >( n );
+    const std::vector< Vector< 3, T > > b = _vectors< 3, T >( n );
+    std::vector< Vector< 3, T > > result( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        for( size_t i = 0; i < n; ++i )
+            result[ i ] = a[ i ].cross( b[ i ] );
+        do_not_optimize( result.front( ));
+    }
+}
+
+template< size_t M, typename T > void _normalize( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< Vector< M, T > > a = _vectors< M, T >( n );
+    std::vector< Vector< M, T > > result( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        for( size_t i = 0; i < n; ++i )
+            result[ i ] = vmml::normalize( a[ i ] );
+        do_not_optimize( result.front( ));
+    }
+}
+
+template< size_t M, typename T > void _add_scale( State& state )
+{
+    const size_t n = state.get_arg();
+    const std::vector< Vector< M, T > > a = _vectors< M, T >( n );
+    std::vector< Vector< M, T > > result = _vectors< M, T >( n );
+    state.set_items_per_iteration( n );
+    while( state.keep_running( ))
+    {
+        for( size_t i = 0; i < n; ++i )
+            result[ i ] += a[ i ] * T( .5 );
+        do_not_optimize( result.front( ));
+    }
+}
+}
+
+VMMLIB_BENCHMARK( "vector_dot<3,float>", &_dot< 3, float >, { 1024 } );
+VMMLIB_BENCHMARK( "vector_dot<4,float>", &_dot< 4, float >, { 1024 } );
+VMMLIB_BENCHMARK( "vector_dot<4,double>", &_dot< 4, double >, { 1024 } );
+VMMLIB_BENCHMARK( "vector_cross<float>", &_cross< float >, { 1024 } );
+VMMLIB_BENCHMARK( "vector_cross<double>", &_cross< double >, { 1024 } );
+VMMLIB_BENCHMARK( "vector_normalize<3,float>", &_normalize< 3, float >,
+                  { 1024 } );
+VMMLIB_BENCHMARK( "vector_normalize<4,double>", &_normalize< 4, double >,
+                  { 1024 } );
+VMMLIB_BENCHMARK( "vector_add_scale<3,float>", &_add_scale< 3, float >,
+                  { 1024 } );
+VMMLIB_BENCHMARK( "vector_add_scale<4,float>", &_add_scale< 4, float >,
+                  { 1024 } );
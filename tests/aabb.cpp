@@ -31,6 +31,9 @@
 #define BOOST_TEST_MODULE axisAlignedBoundingBox
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <vector>
+
 BOOST_AUTO_TEST_CASE(axisAlignedBoundingBox_base)
 {
     vmml::AABBf box1;
@@ -58,3 +61,89 @@ BOOST_AUTO_TEST_CASE(axisAlignedBoundingBox_base)
     box1.merge( box2 );
     BOOST_CHECK_EQUAL( box1, box2 );
 }
+
+BOOST_AUTO_TEST_CASE(axisAlignedBoundingBox_points)
+{
+    // odd count to exercise the remainder after the blocked reduction
+    const size_t n = 101;
+    std::vector< float > xyz( 3 * n );
+    std::vector< float > xyzw( 4 * n );
+    vmml::AABBf expected;
+    for( size_t i = 0; i < n; ++i )
+    {
+        const vmml::Vector3f point( std::sin( float( i )),
+                                    float( i % 7 ) - 3.f,
+                                    std::cos( float( i ) * .3f ) * 5.f );
+        for( size_t j = 0; j < 3; ++j )
+        {
+            xyz[ 3 * i + j ] = point[ j ];
+            xyzw[ 4 * i + j ] = point[ j ];
+        }
+        xyzw[ 4 * i + 3 ] = 1000.f;
+        expected.merge( point );
+    }
+
+    BOOST_CHECK_EQUAL( vmml::AABBf::fromPoints( xyz.data(), n ), expected );
+    BOOST_CHECK_EQUAL( vmml::AABBf::fromPoints( xyzw.data(), n, 4 ),
+                       expected );
+    BOOST_CHECK( vmml::AABBf::fromPoints( xyz.data(), 0 ).isEmpty( ));
+
+    vmml::AABBf box( vmml::Vector3f( -10.f ), vmml::Vector3f( -9.f ));
+    box.mergePoints( xyz.data(), n );
+    BOOST_CHECK_EQUAL( box.getMin(), vmml::Vector3f( -10.f ));
+    BOOST_CHECK_EQUAL( box.getMax(), expected.getMax( ));
+
+    const vmml::AABBf boxes[] = {
+        vmml::AABBf::fromPoints( xyz.data(), 50 ),
+        vmml::AABBf(),
+        vmml::AABBf::fromPoints( xyz.data() + 150, n - 50 ) };
+    vmml::AABBf merged;
+    merged.merge( boxes, 3 );
+    BOOST_CHECK_EQUAL( merged, expected );
+}
+
+BOOST_AUTO_TEST_CASE(axisAlignedBoundingBox_queries)
+{
+    const vmml::AABBf box( vmml::Vector3f( 0.f ), vmml::Vector3f( 1.f ));
+
+    const size_t n = 37;
+    std::vector< float > xyz( 3 * n );
+    std::vector< uint8_t > mask( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        xyz[ 3 * i ] = float( i % 3 ) * .5f;      // 0, .5, 1 are in
+        xyz[ 3 * i + 1 ] = float( i % 4 ) - 1.f;  // 0, 1 are in
+        xyz[ 3 * i + 2 ] = .5f;
+    }
+    box.containsPoints( xyz.data(), n, mask.data( ));
+    for( size_t i = 0; i < n; ++i )
+    {
+        const bool expected = i % 4 == 1 || i % 4 == 2;
+        BOOST_CHECK_EQUAL( mask[ i ], expected ? 1 : 0 );
+    }
+
+    BOOST_CHECK( box.intersects( box ));
+    BOOST_CHECK( box.intersects( vmml::AABBf( vmml::Vector3f( 1.f ),
+                                              vmml::Vector3f( 2.f ))));
+    BOOST_CHECK( box.intersects( vmml::AABBf( vmml::Vector3f( .2f ),
+                                              vmml::Vector3f( .3f ))));
+    BOOST_CHECK( !box.intersects( vmml::AABBf( vmml::Vector3f( .5f, .5f, 1.5f ),
+                                               vmml::Vector3f( 2.f ))));
+
+    // boxes at x = i - 2 .. i - 1.5, overlapping for i = 2, 3
+    const size_t nBoxes = 9;
+    std::vector< float > minX( nBoxes ), maxX( nBoxes );
+    const std::vector< float > minY( nBoxes, 0.f ), minZ( nBoxes, 0.f );
+    const std::vector< float > maxY( nBoxes, 1.f ), maxZ( nBoxes, 1.f );
+    for( size_t i = 0; i < nBoxes; ++i )
+    {
+        minX[ i ] = float( i ) - 2.f;
+        maxX[ i ] = float( i ) - 1.5f;
+    }
+    std::vector< size_t > indices( nBoxes );
+    BOOST_CHECK_EQUAL( box.intersects( minX.data(), minY.data(), minZ.data(),
+                                       maxX.data(), maxY.data(), maxZ.data(),
+                                       nBoxes, indices.data( )), 2 );
+    BOOST_CHECK_EQUAL( indices[ 0 ], 2 );
+    BOOST_CHECK_EQUAL( indices[ 1 ], 3 );
+}
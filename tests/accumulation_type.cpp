@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/accumulation_type.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#define BOOST_TEST_MODULE accumulation_type
+#include <boost/test/unit_test.hpp>
+
+#include <type_traits>
+
+using namespace vmml;
+
+BOOST_AUTO_TEST_CASE(accumulation_type_trait)
+{
+    BOOST_CHECK(( std::is_same< accumulation_type< float >::type,
+                                float >::value ));
+    BOOST_CHECK(( std::is_same< accumulation_type< double >::type,
+                                double >::value ));
+#ifdef __FLT16_MAX__
+    BOOST_CHECK(( std::is_same< accumulation_type< _Float16 >::type,
+                                float >::value ));
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(accumulation_type_float)
+{
+    // 1e8 + 1 is not representable as float
+    const Vector4f a( 1e8f, 1.f, -1e8f, 1.f );
+    const Vector4f ones( 1.f );
+    BOOST_CHECK_EQUAL( a.dot( ones ), 1.f );
+    BOOST_CHECK_EQUAL( a.dot< double >( ones ), 2. );
+    BOOST_CHECK_EQUAL( a.dot< float >( ones ), a.dot( ones ));
+
+    Matrix< 1, 4, float > row;
+    Matrix< 4, 1, float > column;
+    for( size_t i = 0; i < 4; ++i )
+    {
+        row.array[ i ] = a[ i ];
+        column.array[ i ] = 1.f;
+    }
+    Matrix< 1, 1, float > product;
+    product.multiply( row, column );
+    BOOST_CHECK_EQUAL( product.array[ 0 ], 1.f );
+    product.multiply< double >( row, column );
+    BOOST_CHECK_EQUAL( product.array[ 0 ], 2.f );
+    product.multiply< float >( row, column, ExecutionPolicy::sequential( ));
+    BOOST_CHECK_EQUAL( product.array[ 0 ], 1.f );
+
+    BOOST_CHECK_EQUAL( row.sum_elements(), 2. );
+    BOOST_CHECK_EQUAL( row.sum_elements< float >(), 1.f );
+    BOOST_CHECK_EQUAL( row.sum_elements< double >(), 2. );
+    BOOST_CHECK_CLOSE( row.frobenius_norm< double >(),
+                       row.frobenius_norm(), 1e-4 );
+
+    // the default convolution accumulates in double
+    Matrix< 3, 3, float > image;
+    image.fill( 1.f );
+    image.at( 1, 1 ) = 1e8f;
+    Matrix< 3, 3, float > kernel;
+    kernel.fill( 1.f );
+    kernel.at( 0, 0 ) = -1.f;
+    Matrix< 3, 3, float > convolved = image;
+    convolved.convolve( kernel );
+    Matrix< 3, 3, float > convolvedDouble = image;
+    convolvedDouble.convolve< double >( kernel );
+    BOOST_CHECK( convolved == convolvedDouble );
+    Matrix< 3, 3, float > convolvedFloat = image;
+    convolvedFloat.convolve< float >( kernel );
+    BOOST_CHECK( convolved != convolvedFloat );
+}
+
+#ifdef __FLT16_MAX__
+BOOST_AUTO_TEST_CASE(accumulation_type_half)
+{
+    typedef accumulation_type< _Float16 >::type Accumulator;
+
+    // half floats represent integers exactly only up to 2048
+    Matrix< 64, 64, _Float16 > ones;
+    ones.fill( _Float16( 1.f ));
+    BOOST_CHECK_EQUAL( ones.sum_elements< Accumulator >(), 4096.f );
+    BOOST_CHECK_EQUAL( float( ones.sum_elements< _Float16 >( )), 2048.f );
+
+    Matrix< 64, 64, _Float16 > half;
+    half.fill( _Float16( .5f ));
+    Matrix< 64, 64, _Float16 > product;
+    product.multiply< Accumulator >( half, ones );
+    BOOST_CHECK_EQUAL( float( product.at( 3, 5 )), 32.f );
+
+    Vector< 4096, _Float16 > a;
+    Vector< 4096, _Float16 > b;
+    for( size_t i = 0; i < 4096; ++i )
+    {
+        a.array[ i ] = _Float16( 1.f );
+        b.array[ i ] = _Float16( 1.f );
+    }
+    BOOST_CHECK_EQUAL( a.dot< Accumulator >( b ), 4096.f );
+}
+#endif
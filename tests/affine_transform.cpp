@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/affine_transform.hpp>
+
+#define BOOST_TEST_MODULE affine_transform
+#include <boost/test/unit_test.hpp>
+
+using namespace vmml;
+
+namespace
+{
+const double tolerance = 1e-12;
+
+Matrix< 4, 4, double > _createMatrix( const double angle,
+                                      const Vector< 3, double >& axis,
+                                      const Vector< 3, double >& translation,
+                                      const Vector< 3, double >& scale )
+{
+    Matrix< 4, 4, double > rotation;
+    rotation.rotate( angle, axis );
+    Matrix< 4, 4, double > scaling;
+    scaling.scale( scale );
+    Matrix< 4, 4, double > matrix = rotation * scaling;
+    matrix.set_translation( translation );
+    return matrix;
+}
+}
+
+BOOST_AUTO_TEST_CASE(affine_transform_base)
+{
+    const AffineTransform< double > identity_;
+    BOOST_CHECK( identity_ == AffineTransform< double >::IDENTITY );
+    BOOST_CHECK( identity_.get_matrix() == Matrix4d::IDENTITY );
+
+    const Vector< 3, double > point( 1, 2, 3 );
+    BOOST_CHECK_EQUAL( identity_.transform_point( point ), point );
+
+    const Matrix< 4, 4, double > matrix =
+        _createMatrix( .3, Vector3d( 0, 0, 1 ), Vector3d( 1, 2, 3 ),
+                       Vector3d( 2, 2, 2 ));
+    const AffineTransform< double > transform( matrix );
+    BOOST_CHECK( transform.get_matrix().equals( matrix, tolerance ));
+    BOOST_CHECK( transform.get_translation().equals( Vector3d( 1, 2, 3 )));
+    BOOST_CHECK( transform.get_scale().equals( Vector3d( 2, 2, 2 ), tolerance ));
+    BOOST_CHECK( transform.transform_point( point ).equals( matrix * point,
+                                                            tolerance ));
+
+    const Vector< 4, double > direction( -1, 4, 2, 0 );
+    const Vector< 4, double > expected = matrix * direction;
+    BOOST_CHECK( transform.transform_vector( Vector3d( -1, 4, 2 )).equals(
+                     Vector3d( expected.x(), expected.y(), expected.z( )),
+                     tolerance ));
+}
+
+BOOST_AUTO_TEST_CASE(affine_transform_compose)
+{
+    Vector3d axis( 1, 2, 3 );
+    axis.normalize();
+    const Matrix< 4, 4, double > m1 =
+        _createMatrix( .7, axis, Vector3d( -1, 2, .5 ), Vector3d( 1, 2, 3 ));
+    const Matrix< 4, 4, double > m2 =
+        _createMatrix( -1.3, Vector3d( 0, 1, 0 ), Vector3d( 4, 0, 1 ),
+                       Vector3d( .5, .5, 1 ));
+
+    const AffineTransform< double > t1( m1 );
+    const AffineTransform< double > t2( m2 );
+    BOOST_CHECK( ( t1 * t2 ).get_matrix().equals( m1 * m2, tolerance ));
+
+    AffineTransform< double > t3( t1 );
+    t3 *= t3;
+    BOOST_CHECK( t3.get_matrix().equals( m1 * m1, tolerance ));
+
+    const AffineTransform< double > left[] = { t1, t2 };
+    const AffineTransform< double > right[] = { t2, t1 };
+    AffineTransform< double > result[ 2 ];
+    multiply( left, right, result, 2 );
+    BOOST_CHECK( result[0].equals( t1 * t2, tolerance ));
+    BOOST_CHECK( result[1].equals( t2 * t1, tolerance ));
+
+    const double points[] = { 1, 2, 3, -4, 5, -6 };
+    double transformed[ 6 ];
+    t1.transform_points( points, transformed, 2 );
+    BOOST_CHECK( Vector3d( transformed ).equals(
+                     m1 * Vector3d( points ), tolerance ));
+    BOOST_CHECK( Vector3d( transformed + 3 ).equals(
+                     m1 * Vector3d( points + 3 ), tolerance ));
+}
+
+BOOST_AUTO_TEST_CASE(affine_transform_inverse)
+{
+    const Matrix< 4, 4, double > matrix =
+        _createMatrix( 1.1, Vector3d( 1, 0, 0 ), Vector3d( 3, -2, 7 ),
+                       Vector3d( 1, 2, 4 ));
+    const AffineTransform< double > transform( matrix );
+
+    AffineTransform< double > inverse;
+    BOOST_CHECK( transform.inverse( inverse ));
+    BOOST_CHECK( ( transform * inverse ).equals(
+                     AffineTransform< double >::IDENTITY, tolerance ));
+
+    Matrix< 4, 4, double > matrix_inverse;
+    BOOST_CHECK( matrix.inverse( matrix_inverse ));
+    BOOST_CHECK( inverse.get_matrix().equals( matrix_inverse, tolerance ));
+
+    const AffineTransform< double > rigid( Quaterniond( 0, 0, 1, 0 ),
+                                           Vector3d( 1, 2, 3 ));
+    BOOST_CHECK( ( rigid * rigid.get_rigid_inverse( )).equals(
+                     AffineTransform< double >::IDENTITY, tolerance ));
+
+    const AffineTransform< double > singular( Quaterniond::IDENTITY,
+                                              Vector3d::ZERO,
+                                              Vector3d( 1, 0, 1 ));
+    BOOST_CHECK( !singular.inverse( inverse ));
+}
+
+BOOST_AUTO_TEST_CASE(affine_transform_quaternion)
+{
+    Quaterniond rotation( .1, .2, .3, .9 );
+    rotation.normalize();
+    const Vector3d translation( 5, 6, 7 );
+    const Vector3d scale( 1, 2, 3 );
+
+    const AffineTransform< double > transform( rotation, translation, scale );
+    BOOST_CHECK( transform.get_scale().equals( scale, tolerance ));
+    BOOST_CHECK( transform.get_translation() == translation );
+
+    const Quaterniond result = transform.get_rotation();
+    BOOST_CHECK( std::abs( std::abs( result.dot( rotation )) - 1 ) < tolerance );
+
+    Matrix< 4, 4, double > expected;
+    rotation.get_rotation_matrix( expected );
+    Matrix< 4, 4, double > scaling;
+    scaling.scale( scale );
+    expected = expected * scaling;
+    expected.set_translation( translation );
+    BOOST_CHECK( transform.get_matrix().equals( expected, tolerance ));
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "../benchmarks/statistics.hpp"
+
+#define BOOST_TEST_MODULE benchmark_statistics
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace vmml::benchmark;
+
+namespace
+{
+std::vector< double > _values( const double* begin, const size_t n )
+{
+    return std::vector< double >( begin, begin + n );
+}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_statistics_median)
+{
+    const double odd[] = { 3., 1., 2. };
+    const double even[] = { 4., 1., 3., 2. };
+    BOOST_CHECK_EQUAL( median( _values( odd, 3 )), 2. );
+    BOOST_CHECK_EQUAL( median( _values( even, 4 )), 2.5 );
+    BOOST_CHECK_EQUAL( median( _values( odd, 1 )), 3. );
+    BOOST_CHECK_EQUAL( median( std::vector< double >( )), 0. );
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_statistics_mad)
+{
+    // median 2, deviations 1 1 0 0 2 4 7
+    const double values[] = { 1., 1., 2., 2., 4., 6., 9. };
+    BOOST_CHECK_EQUAL( mad( _values( values, 7 )), 1. );
+    BOOST_CHECK_CLOSE( median_error( _values( values, 7 )),
+                       1.2533 * 1.4826 / std::sqrt( 7. ), 1e-9 );
+
+    const double constant[] = { 5., 5., 5. };
+    BOOST_CHECK_EQUAL( mad( _values( constant, 3 )), 0. );
+    BOOST_CHECK_EQUAL( median_error( _values( constant, 3 )), 0. );
+
+    BOOST_CHECK_EQUAL( mad( std::vector< double >( )), 0. );
+    BOOST_CHECK_EQUAL( median_error( std::vector< double >( )), 0. );
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_statistics_comparison)
+{
+    // without noise, the change alone is compared to the margin
+    const double baseline[] = { 100., 100., 100. };
+    const double slower[] = { 110., 110., 110. };
+    const double faster[] = { 90., 90., 90. };
+
+    const Comparison regression( _values( baseline, 3 ),
+                                 _values( slower, 3 ), .05 );
+    BOOST_CHECK_EQUAL( regression.baseline, 100. );
+    BOOST_CHECK_EQUAL( regression.current, 110. );
+    BOOST_CHECK_CLOSE( regression.change, .1, 1e-9 );
+    BOOST_CHECK_EQUAL( regression.confidence, 0. );
+    BOOST_CHECK( regression.regression );
+    BOOST_CHECK( !regression.improvement );
+
+    const Comparison withinMargin( _values( baseline, 3 ),
+                                   _values( slower, 3 ), .15 );
+    BOOST_CHECK( !withinMargin.regression );
+
+    const Comparison improvement( _values( baseline, 3 ),
+                                  _values( faster, 3 ), .05 );
+    BOOST_CHECK( !improvement.regression );
+    BOOST_CHECK( improvement.improvement );
+
+    // noise widens the interval: the same change is no longer significant
+    const double noisyBaseline[] = { 90., 100., 110. };
+    const double noisySlower[] = { 100., 110., 120. };
+    const Comparison noisy( _values( noisyBaseline, 3 ),
+                            _values( noisySlower, 3 ), .05 );
+    const double error = 1.2533 * 1.4826 * 10. / std::sqrt( 3. );
+    BOOST_CHECK_CLOSE( noisy.change, .1, 1e-9 );
+    BOOST_CHECK_CLOSE( noisy.confidence,
+                       1.96 * std::sqrt( 2. ) * error / 100., 1e-9 );
+    BOOST_CHECK( noisy.change > .05 );
+    BOOST_CHECK( noisy.change - noisy.confidence <= .05 );
+    BOOST_CHECK( !noisy.regression );
+
+    // a lower z narrows the interval until the change is significant
+    const Comparison lowConfidence( _values( noisyBaseline, 3 ),
+                                    _values( noisySlower, 3 ), .05, .1 );
+    BOOST_CHECK( lowConfidence.change - lowConfidence.confidence > .05 );
+    BOOST_CHECK( lowConfidence.regression );
+
+    // an empty baseline never flags a change
+    const Comparison empty( std::vector< double >( ),
+                            _values( slower, 3 ), .05 );
+    BOOST_CHECK_EQUAL( empty.change, 0. );
+    BOOST_CHECK( !empty.regression );
+    BOOST_CHECK( !empty.improvement );
+}
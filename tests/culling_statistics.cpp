@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/culling_statistics.hpp>
+#include <vmmlib/frustum.hpp>
+#include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/multi_frustum_culler.hpp>
+
+#define BOOST_TEST_MODULE culling_statistics
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+Matrix4f _getMatrix()
+{
+    return Frustumf( -1.f, 1.f, -1.f, 1.f, 1.f, 100.f ).compute_matrix();
+}
+
+std::vector< AABBf > _getBoxes()
+{
+    std::vector< AABBf > boxes;
+    // fully visible, rejected by the near and by the left plane, partially
+    // visible
+    boxes.push_back( AABBf( Vector3f( -1.f, -1.f, -4.f ),
+                            Vector3f( 1.f, 1.f, -2.f )));
+    boxes.push_back( AABBf( Vector3f( -1.f, -1.f, -.5f ),
+                            Vector3f( 1.f, 1.f, 0.f )));
+    boxes.push_back( AABBf( Vector3f( -20.f, -1.f, -4.f ),
+                            Vector3f( -18.f, 1.f, -2.f )));
+    boxes.push_back( AABBf( Vector3f( -1.f, -1.f, -1.5f ),
+                            Vector3f( 1.f, 1.f, -.5f )));
+    return boxes;
+}
+}
+
+BOOST_AUTO_TEST_CASE(culling_statistics_frustum_culler)
+{
+    FrustumCullerf culler;
+    culler.setup( _getMatrix( ));
+    BOOST_CHECK( !culler.get_statistics( ));
+
+    CullingStatistics statistics;
+    culler.set_statistics( &statistics );
+    BOOST_CHECK_EQUAL( culler.get_statistics(), &statistics );
+
+    const std::vector< AABBf > boxes = _getBoxes();
+    std::vector< Visibility > visibility( boxes.size( ));
+    culler.test_aabbs( boxes.data(), boxes.size(), visibility.data( ));
+    BOOST_CHECK_EQUAL( visibility[ 0 ], VISIBILITY_FULL );
+    BOOST_CHECK_EQUAL( visibility[ 1 ], VISIBILITY_NONE );
+    BOOST_CHECK_EQUAL( visibility[ 2 ], VISIBILITY_NONE );
+    BOOST_CHECK_EQUAL( visibility[ 3 ], VISIBILITY_PARTIAL );
+
+    CullingStatistics::Counters counters = statistics.get();
+    BOOST_CHECK_EQUAL( counters.passes, 1 );
+    BOOST_CHECK_EQUAL( counters.tested, 4 );
+    BOOST_CHECK_EQUAL( counters.results[ VISIBILITY_FULL ], 1 );
+    BOOST_CHECK_EQUAL( counters.results[ VISIBILITY_PARTIAL ], 1 );
+    BOOST_CHECK_EQUAL( counters.results[ VISIBILITY_NONE ], 2 );
+    BOOST_CHECK_EQUAL( counters.plane_tests, 6 + 5 + 1 + 6 );
+
+    // the projected variants and spheres count the same way
+    const std::vector< Vector4f > spheres( 3, Vector4f( 0.f, 0.f, -10.f, 1.f ));
+    std::vector< float > radius( boxes.size( ));
+    culler.test_aabbs( boxes.data(), boxes.size(), Vector2f( 100.f, 100.f ),
+                       visibility.data(), radius.data( ));
+    culler.test_spheres( spheres.data(), spheres.size(),
+                         Vector2f( 100.f, 100.f ), visibility.data(),
+                         radius.data( ));
+    counters = statistics.get();
+    BOOST_CHECK_EQUAL( counters.passes, 3 );
+    BOOST_CHECK_EQUAL( counters.tested, 11 );
+    BOOST_CHECK_EQUAL( counters.results[ VISIBILITY_FULL ], 5 );
+    BOOST_CHECK_EQUAL( counters.plane_tests, 2 * 18 + 3 * 6 );
+
+    // single tests and cullers without statistics are not counted
+    culler.test_aabb( boxes[ 0 ] );
+    FrustumCullerf other( culler );
+    other.set_statistics( 0 );
+    other.test_aabbs( boxes.data(), boxes.size(), visibility.data( ));
+    BOOST_CHECK_EQUAL( statistics.get().tested, 11 );
+
+    statistics.reset();
+    counters = statistics.get();
+    BOOST_CHECK_EQUAL( counters.passes, 0 );
+    BOOST_CHECK_EQUAL( counters.tested, 0 );
+    BOOST_CHECK_EQUAL( counters.plane_tests, 0 );
+}
+
+BOOST_AUTO_TEST_CASE(culling_statistics_threads)
+{
+    CullingStatistics statistics;
+    FrustumCullerf culler;
+    culler.setup( _getMatrix( ));
+    culler.set_statistics( &statistics );
+
+    const std::vector< AABBf > boxes = _getBoxes();
+    const size_t nThreads = 4;
+    const size_t nPasses = 100;
+    std::vector< std::thread > threads;
+    for( size_t i = 0; i < nThreads; ++i )
+        threads.push_back( std::thread( [&]
+        {
+            std::vector< Visibility > visibility( boxes.size( ));
+            for( size_t j = 0; j < nPasses; ++j )
+                culler.test_aabbs( boxes.data(), boxes.size(),
+                                   visibility.data(), true );
+        }));
+
+    // merging while the threads cull is safe
+    BOOST_CHECK( statistics.get().tested <= nThreads * nPasses * 4 );
+    for( std::thread& thread : threads )
+        thread.join();
+
+    const CullingStatistics::Counters counters = statistics.get();
+    BOOST_CHECK_EQUAL( counters.passes, nThreads * nPasses );
+    BOOST_CHECK_EQUAL( counters.tested, nThreads * nPasses * 4 );
+    BOOST_CHECK_EQUAL( counters.results[ VISIBILITY_NONE ],
+                       nThreads * nPasses * 2 );
+    BOOST_CHECK_EQUAL( counters.plane_tests, nThreads * nPasses * 18 );
+}
+
+BOOST_AUTO_TEST_CASE(culling_statistics_multi_frustum_culler)
+{
+    MultiFrustumCuller< float, 2 > culler;
+    Matrix4f view;
+    view.rotate_y( float( M_PI ));
+    culler.setup( 0, _getMatrix( ));
+    culler.setup( 1, _getMatrix() * view );
+
+    CullingStatistics statistics;
+    culler.set_statistics( &statistics );
+
+    const std::vector< AABBf > boxes = _getBoxes();
+    std::vector< uint64_t > visible( boxes.size( ));
+    culler.test_aabbs( boxes.data(), boxes.size(), visible.data( ));
+
+    // each box is tested in both views, the second one looking away
+    const CullingStatistics::Counters counters = statistics.get();
+    BOOST_CHECK_EQUAL( counters.passes, 1 );
+    BOOST_CHECK_EQUAL( counters.tested, 8 );
+    BOOST_CHECK_EQUAL( counters.results[ VISIBILITY_FULL ], 1 );
+    BOOST_CHECK_EQUAL( counters.results[ VISIBILITY_PARTIAL ], 1 );
+    BOOST_CHECK_EQUAL( counters.results[ VISIBILITY_NONE ], 6 );
+    BOOST_CHECK_EQUAL( counters.plane_tests, 8 * 6 );
+}
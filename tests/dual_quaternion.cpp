@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/dual_quaternion.hpp>
+
+#define BOOST_TEST_MODULE dual_quaternion
+#include <boost/test/unit_test.hpp>
+
+using namespace vmml;
+
+namespace
+{
+const double tolerance = 1e-12;
+
+Quaterniond _rotation( const double angle, Vector3d axis )
+{
+    axis.normalize();
+    return Quaterniond( axis * std::sin( angle * .5 ), std::cos( angle * .5 ));
+}
+
+Matrix< 4, 4, double > _matrix( const Quaterniond& rotation,
+                                const Vector3d& translation )
+{
+    Matrix< 4, 4, double > matrix;
+    rotation.get_rotation_matrix( matrix );
+    matrix.set_translation( translation );
+    return matrix;
+}
+}
+
+BOOST_AUTO_TEST_CASE(dual_quaternion_base)
+{
+    const Quaterniond rotation = _rotation( .8, Vector3d( 1, 2, 3 ));
+    const Vector3d translation( 4, -5, 6 );
+    const DualQuaterniond dq( rotation, translation );
+    const Matrix< 4, 4, double > matrix = _matrix( rotation, translation );
+
+    BOOST_CHECK( dq.get_translation().equals( translation, tolerance ));
+    BOOST_CHECK( dq.get_matrix().equals( matrix, tolerance ));
+    BOOST_CHECK( DualQuaterniond( matrix ).equals( dq, tolerance ));
+
+    const Vector3d point( 1, -2, .5 );
+    BOOST_CHECK( dq.transform_point( point ).equals( matrix * point,
+                                                     tolerance ));
+    BOOST_CHECK( DualQuaterniond::IDENTITY.transform_point( point ) == point );
+}
+
+BOOST_AUTO_TEST_CASE(dual_quaternion_multiply)
+{
+    const Quaterniond r1 = _rotation( .8, Vector3d( 1, 2, 3 ));
+    const Quaterniond r2 = _rotation( -2.1, Vector3d( 0, 1, 0 ));
+    const Vector3d t1( 4, -5, 6 );
+    const Vector3d t2( -1, 0, 2 );
+
+    const DualQuaterniond dq = DualQuaterniond( r1, t1 ) *
+                               DualQuaterniond( r2, t2 );
+    BOOST_CHECK( dq.get_matrix().equals( _matrix( r1, t1 ) * _matrix( r2, t2 ),
+                                         tolerance ));
+    BOOST_CHECK( ( dq * dq.get_conjugate( )).equals( DualQuaterniond::IDENTITY,
+                                                     tolerance ));
+
+    DualQuaterniond scaled = dq * 3.;
+    scaled.normalize();
+    BOOST_CHECK( scaled.equals( dq, tolerance ));
+}
+
+BOOST_AUTO_TEST_CASE(dual_quaternion_sclerp)
+{
+    const DualQuaterniond p( _rotation( .3, Vector3d( 0, 0, 1 )),
+                             Vector3d( 1, 0, 0 ));
+    const DualQuaterniond q( _rotation( 1.9, Vector3d( 0, 0, 1 )),
+                             Vector3d( 1, 0, 3 ));
+
+    BOOST_CHECK( DualQuaterniond::sclerp( 0, p, q ).equals( p, tolerance ));
+    BOOST_CHECK( DualQuaterniond::sclerp( 1, p, q ).equals( q, tolerance ));
+
+    // screw motion along z: half way is half the angle and half the pitch
+    const DualQuaterniond half = DualQuaterniond::sclerp( .5, p, q );
+    const Quaterniond expected = _rotation( 1.1, Vector3d( 0, 0, 1 ));
+    Quaterniond rotation = half.real();
+    BOOST_CHECK( rotation.is_akin( expected, tolerance ));
+    BOOST_CHECK_CLOSE( half.get_translation().z(), 1.5, 1e-10 );
+
+    // pure translation
+    const DualQuaterniond t( Quaterniond::IDENTITY, Vector3d( 2, 4, 6 ));
+    BOOST_CHECK( DualQuaterniond::sclerp( .25, DualQuaterniond::IDENTITY, t )
+                     .get_translation().equals( Vector3d( .5, 1, 1.5 ),
+                                                tolerance ));
+}
+
+BOOST_AUTO_TEST_CASE(dual_quaternion_blend)
+{
+    const DualQuaterniond dqs[] = {
+        DualQuaterniond( _rotation( .4, Vector3d( 1, 0, 0 )), Vector3d( 1, 2, 3 )),
+        DualQuaterniond( _rotation( .4, Vector3d( 1, 0, 0 )), Vector3d( 1, 2, 3 )),
+        DualQuaterniond( _rotation( -1., Vector3d( 0, 1, 0 )), Vector3d( 0, 0, 1 ))
+    };
+    const double weights[] = { .5, .5 };
+
+    // equal inputs blend to themselves, also across hemispheres
+    BOOST_CHECK( DualQuaterniond::blend( dqs, weights, 2 ).equals( dqs[0],
+                                                                  tolerance ));
+    const DualQuaterniond flipped[] = { dqs[0], -dqs[1] };
+    BOOST_CHECK( DualQuaterniond::blend( flipped, weights, 2 ).equals(
+                     dqs[0], tolerance ));
+
+    const size_t indices[] = { 0, 2, 2, 1 };
+    const double batch_weights[] = { .3, .7, 1, 0 };
+    DualQuaterniond result[ 2 ];
+    DualQuaterniond::blend( dqs, indices, batch_weights, 2, result, 2 );
+
+    const DualQuaterniond first[] = { dqs[0], dqs[2] };
+    BOOST_CHECK( result[0].equals( DualQuaterniond::blend( first, batch_weights,
+                                                           2 ), tolerance ));
+    BOOST_CHECK( result[1].equals( dqs[2], tolerance ));
+    BOOST_CHECK_CLOSE( result[0].real().abs(), 1., 1e-10 );
+
+    // no influences blend to the identity, without reading the indices
+    BOOST_CHECK( DualQuaterniond::blend( dqs, weights, 0 ).equals(
+                     DualQuaterniond::IDENTITY, tolerance ));
+    DualQuaterniond::blend( dqs, 0, 0, 0, result, 2 );
+    BOOST_CHECK( result[0].equals( DualQuaterniond::IDENTITY, tolerance ));
+    BOOST_CHECK( result[1].equals( DualQuaterniond::IDENTITY, tolerance ));
+}
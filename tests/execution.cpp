@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/aabb.hpp>
+#include <vmmlib/execution.hpp>
+#include <vmmlib/frustum.hpp>
+#include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/matrix.hpp>
+
+#define BOOST_TEST_MODULE execution
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+// runs the chunks in reverse order on the calling thread
+class ReverseExecutor : public Executor
+{
+public:
+    ReverseExecutor() : calls( 0 ) {}
+
+    void run( size_t n_chunks,
+              const std::function< void( size_t ) >& task ) final
+    {
+        ++calls;
+        while( n_chunks > 0 )
+            task( --n_chunks );
+    }
+
+    size_t calls;
+};
+
+float _random()
+{
+    return std::rand() / float( RAND_MAX ) - .5f;
+}
+}
+
+BOOST_AUTO_TEST_CASE(execution_parallel_for)
+{
+    ThreadPool pool( 4 );
+    BOOST_CHECK_EQUAL( pool.get_size(), 4 );
+
+    const size_t n = 100000;
+    std::vector< int > values( n, 0 );
+    std::mutex mutex;
+    std::set< std::thread::id > threads;
+    size_t maxChunk = 0;
+    parallel_for( ExecutionPolicy::parallel( pool, 1000 ), n,
+                  [&]( const size_t begin, const size_t end )
+    {
+        for( size_t i = begin; i < end; ++i )
+            ++values[ i ];
+
+        std::lock_guard< std::mutex > lock( mutex );
+        threads.insert( std::this_thread::get_id( ));
+        maxChunk = end - begin > maxChunk ? end - begin : maxChunk;
+    });
+    for( size_t i = 0; i < n; ++i )
+        BOOST_REQUIRE_EQUAL( values[ i ], 1 );
+    BOOST_CHECK_EQUAL( maxChunk, 1000 );
+    BOOST_CHECK( threads.size() >= 1 && threads.size() <= 4 );
+
+    // nested loops run on the calling thread
+    std::vector< size_t > sums( 16, 0 );
+    parallel_for( ExecutionPolicy::parallel( pool, 1 ), sums.size(),
+                  [&]( const size_t begin, const size_t end )
+    {
+        for( size_t i = begin; i < end; ++i )
+            parallel_for( ExecutionPolicy::parallel( pool, 1 ), 100,
+                          [&]( const size_t b, const size_t e )
+            {
+                sums[ i ] += e - b;
+            });
+    });
+    for( size_t i = 0; i < sums.size(); ++i )
+        BOOST_CHECK_EQUAL( sums[ i ], 100 );
+
+    // small ranges and the sequential policy run in one call
+    ReverseExecutor executor;
+    size_t calls = 0;
+    parallel_for( ExecutionPolicy::parallel( executor ), 1000,
+                  [&]( const size_t begin, const size_t end )
+    {
+        BOOST_CHECK_EQUAL( begin, 0 );
+        BOOST_CHECK_EQUAL( end, 1000 );
+        ++calls;
+    });
+    parallel_for( ExecutionPolicy::sequential(), 1000000,
+                  [&]( const size_t, const size_t ) { ++calls; });
+    BOOST_CHECK_EQUAL( calls, 2 );
+    BOOST_CHECK_EQUAL( executor.calls, 0 );
+}
+
+BOOST_AUTO_TEST_CASE(execution_exception)
+{
+    ThreadPool pool( 4 );
+    const size_t n_chunks = 1000;
+
+    // the first exception is rethrown and the remaining chunks are skipped
+    std::atomic< size_t > started( 0 );
+    BOOST_CHECK_THROW( pool.run( n_chunks, [&]( const size_t )
+    {
+        ++started;
+        throw std::runtime_error( "chunk failed" );
+    }), std::runtime_error );
+    BOOST_CHECK_LE( started, pool.get_size( ));
+
+    started = 0;
+    BOOST_CHECK_THROW( pool.run( n_chunks, [&]( const size_t chunk )
+    {
+        ++started;
+        if( chunk == n_chunks / 2 )
+            throw std::runtime_error( "chunk failed" );
+    }), std::runtime_error );
+    BOOST_CHECK_LT( started, n_chunks );
+
+    // the pool and the calling thread are usable afterwards
+    std::mutex mutex;
+    std::set< std::thread::id > threads;
+    pool.run( 16, [&]( const size_t )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 2 ));
+        std::lock_guard< std::mutex > lock( mutex );
+        threads.insert( std::this_thread::get_id( ));
+    });
+    BOOST_CHECK_GT( threads.size(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE(execution_parallel_reduce)
+{
+    const size_t n = 100001;
+    std::vector< float > values( n );
+    for( size_t i = 0; i < n; ++i )
+        values[ i ] = _random() * 1000.f;
+
+    const auto map = [&]( const size_t begin, const size_t end )
+    {
+        float sum = 0.f;
+        for( size_t i = begin; i < end; ++i )
+            sum += values[ i ];
+        return sum;
+    };
+    const auto combine = []( const float a, const float b ) { return a + b; };
+
+    // same result, bit for bit, for any executor and thread count
+    const float expected = parallel_reduce( ExecutionPolicy::sequential(), n,
+                                            0.f, map, combine );
+    ReverseExecutor executor;
+    BOOST_CHECK_EQUAL( parallel_reduce( ExecutionPolicy::parallel( executor ),
+                                        n, 0.f, map, combine ), expected );
+    BOOST_CHECK_EQUAL( executor.calls, 1 );
+    for( size_t threads = 1; threads <= 8; threads *= 2 )
+    {
+        ThreadPool pool( threads );
+        BOOST_CHECK_EQUAL( parallel_reduce( ExecutionPolicy::parallel( pool ),
+                                            n, 0.f, map, combine ), expected );
+    }
+
+    BOOST_CHECK_EQUAL( parallel_reduce( ExecutionPolicy::parallel(), 0, 42.f,
+                                        map, combine ), 42.f );
+}
+
+BOOST_AUTO_TEST_CASE(execution_matrix)
+{
+    ThreadPool pool( 4 );
+    const ExecutionPolicy parallel = ExecutionPolicy::parallel( pool, 3 );
+
+    Matrix< 64, 48, double > left;
+    Matrix< 48, 32, double > right;
+    for( size_t i = 0; i < 64 * 48; ++i )
+        left.array[ i ] = _random();
+    for( size_t i = 0; i < 48 * 32; ++i )
+        right.array[ i ] = _random();
+
+    Matrix< 64, 32, double > expected;
+    Matrix< 64, 32, double > result;
+    expected.multiply( left, right );
+    result.multiply( left, right, parallel );
+    BOOST_CHECK( result == expected );
+
+    Matrix< 3, 3, double > kernel;
+    kernel.fill( 1. / 9. );
+    Matrix< 48, 48, double > convolved;
+    for( size_t i = 0; i < 48 * 48; ++i )
+        convolved.array[ i ] = _random();
+    Matrix< 48, 48, double > convolvedParallel = convolved;
+    convolved.convolve( kernel );
+    convolvedParallel.convolve( kernel, parallel );
+    BOOST_CHECK( convolved == convolvedParallel );
+
+    Matrix< 4, 3, double > small;
+    Matrix< 2, 2, double > factor;
+    for( size_t i = 0; i < 12; ++i )
+        small.array[ i ] = _random();
+    factor.fill( 2. );
+    Matrix< 8, 6, double > kronecker;
+    Matrix< 8, 6, double > kroneckerParallel;
+    small.kronecker_product( factor, kronecker );
+    small.kronecker_product( factor, kroneckerParallel,
+                             ExecutionPolicy::parallel( pool, 1 ));
+    BOOST_CHECK( kronecker == kroneckerParallel );
+
+    // reductions with the same grain size give the same result
+    const ExecutionPolicy sequential( 0, 3 );
+    const double sum = left.sum_elements( sequential );
+    BOOST_CHECK_CLOSE( sum, left.sum_elements(), 1e-9 );
+    BOOST_CHECK_EQUAL( left.sum_elements( parallel ), sum );
+    const double norm = left.frobenius_norm( sequential );
+    BOOST_CHECK_CLOSE( norm, left.frobenius_norm(), 1e-9 );
+    BOOST_CHECK_EQUAL( left.frobenius_norm( parallel ), norm );
+}
+
+BOOST_AUTO_TEST_CASE(execution_batches)
+{
+    ThreadPool pool( 4 );
+    const size_t n = 10000;
+    std::vector< float > xyz( 3 * n );
+    for( size_t i = 0; i < xyz.size(); ++i )
+        xyz[ i ] = _random() * 100.f;
+
+    AABBf aabb;
+    aabb.mergePoints( xyz.data(), n, 3,
+                      ExecutionPolicy::parallel( pool, 100 ));
+    BOOST_CHECK_EQUAL( aabb, AABBf::fromPoints( xyz.data(), n ));
+
+    std::vector< AABBf > boxes( n );
+    for( size_t i = 0; i < n; ++i )
+        boxes[ i ] = AABBf( xyz[ 3 * i ], xyz[ 3 * i + 1 ], xyz[ 3 * i + 2 ], 5.f );
+
+    FrustumCullerf culler;
+    culler.setup( Frustumf( -1.f, 1.f, -1.f, 1.f, 1.f, 100.f ).compute_matrix());
+    std::vector< Visibility > expected( n );
+    std::vector< Visibility > result( n );
+    culler.test_aabbs( boxes.data(), n, expected.data(), true );
+    culler.test_aabbs( boxes.data(), n, result.data(),
+                       ExecutionPolicy::parallel( pool ), true );
+    BOOST_CHECK( result == expected );
+}
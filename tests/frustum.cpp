@@ -32,6 +32,11 @@
 #define BOOST_TEST_MODULE frustum
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
 static void _testCull( const vmml::FrustumCuller< float >& fc )
 {
     const vmml::Vector< 4, float > sphereIn( 0.f, 0.f, -10.f, 1.f );
@@ -50,6 +55,17 @@ static void _testCull( const vmml::FrustumCuller< float >& fc )
     BOOST_CHECK_EQUAL( fc.test_aabb( xy, xy, zIn ), vmml::VISIBILITY_FULL );
     BOOST_CHECK_EQUAL( fc.test_aabb( xy, xy, zOut ), vmml::VISIBILITY_NONE );
     BOOST_CHECK_EQUAL( fc.test_aabb( xy, xy, zBorder ), vmml::VISIBILITY_PARTIAL );
+
+    const vmml::AABBf boxIn( vmml::Vector3f( -1.f, -1.f, -4.f ),
+                             vmml::Vector3f( 1.f, 1.f, -2.f ));
+    const vmml::AABBf boxOut( vmml::Vector3f( -1.f, -1.f, -.5f ),
+                              vmml::Vector3f( 1.f, 1.f, 0.f ));
+    const vmml::AABBf boxBorder( vmml::Vector3f( -1.f, -1.f, -1.5f ),
+                                 vmml::Vector3f( 1.f, 1.f, -.5f ));
+
+    BOOST_CHECK_EQUAL( fc.test_aabb( boxIn ), vmml::VISIBILITY_FULL );
+    BOOST_CHECK_EQUAL( fc.test_aabb( boxOut ), vmml::VISIBILITY_NONE );
+    BOOST_CHECK_EQUAL( fc.test_aabb( boxBorder ), vmml::VISIBILITY_PARTIAL );
 }
 
 
@@ -79,3 +95,220 @@ BOOST_AUTO_TEST_CASE(frustum_base)
     fc.setup( a, b, c, d, e, f, g, h );
     _testCull( fc );
 }
+
+namespace
+{
+bool _isInside( const vmml::FrustumCuller< float >& fc,
+                const vmml::Vector3f& point )
+{
+    return fc.test_sphere( vmml::Vector4f( point, 0.f )) !=
+           vmml::VISIBILITY_NONE;
+}
+}
+
+BOOST_AUTO_TEST_CASE(frustum_exact)
+{
+    // a frustum looking diagonally, so that the planes are not aligned with
+    // the boxes
+    const vmml::Frustum< float > frustum( -1.f, 1., -1.f, 1., 1.f, 10.f );
+    vmml::Matrix< 4, 4, float > view;
+    view.rotate_y( .6f );
+    view.rotate_x( .4f );
+    vmml::FrustumCuller< float > fc;
+    fc.setup( frustum.compute_matrix() * view );
+    BOOST_REQUIRE( fc.get_corners( ));
+
+    // the corners span the frustum
+    const vmml::Vector3f* corners = fc.get_corners();
+    for( size_t i = 0; i < 8; ++i )
+    {
+        const vmml::Vector4f sphere( corners[ i ], .01f );
+        BOOST_CHECK_EQUAL( fc.test_sphere( sphere ), vmml::VISIBILITY_PARTIAL );
+    }
+
+    const size_t n = 2000;
+    std::vector< vmml::AABBf > boxes( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        vmml::Vector3f center;
+        for( size_t j = 0; j < 3; ++j )
+            center[ j ] = std::rand() / float( RAND_MAX ) * 24.f - 12.f;
+        boxes[ i ] = vmml::AABBf( center - 1.f, center + 1.f );
+    }
+    std::vector< vmml::Visibility > planes( n );
+    std::vector< vmml::Visibility > exact( n );
+    fc.test_aabbs( boxes.data(), n, planes.data( ));
+    fc.test_aabbs( boxes.data(), n, exact.data(), true );
+
+    size_t refined = 0;
+    for( size_t i = 0; i < n; ++i )
+    {
+        BOOST_CHECK_EQUAL( planes[ i ], fc.test_aabb( boxes[ i ] ));
+        BOOST_CHECK_EQUAL( exact[ i ], fc.test_aabb_exact( boxes[ i ] ));
+        if( planes[ i ] == exact[ i ] )
+            continue;
+
+        // only partial results are refined, and only if no part of the box
+        // is inside
+        BOOST_CHECK_EQUAL( planes[ i ], vmml::VISIBILITY_PARTIAL );
+        BOOST_CHECK_EQUAL( exact[ i ], vmml::VISIBILITY_NONE );
+        const vmml::Vector3f& min = boxes[ i ].getMin();
+        for( float x = 0.f; x <= 2.f; x += .1f )
+            for( float y = 0.f; y <= 2.f; y += .1f )
+                for( float z = 0.f; z <= 2.f; z += .1f )
+                    BOOST_CHECK( !_isInside( fc, min +
+                                             vmml::Vector3f( x, y, z )));
+        ++refined;
+    }
+    BOOST_CHECK_GT( refined, 0 );
+
+    // the corners are computed on first use, also by concurrent tests and
+    // for copies made before
+    vmml::FrustumCuller< float > lazy;
+    lazy.setup( frustum.compute_matrix() * view );
+    const vmml::FrustumCuller< float > copy( lazy );
+    vmml::ThreadPool pool( 4 );
+    std::vector< vmml::Visibility > parallel( n );
+    lazy.test_aabbs( boxes.data(), n, parallel.data(),
+                     vmml::ExecutionPolicy::parallel( pool, 1 ), true );
+    BOOST_CHECK( parallel == exact );
+    BOOST_REQUIRE( copy.get_corners( ));
+    for( size_t i = 0; i < 8; ++i )
+        BOOST_CHECK_EQUAL( copy.get_corners()[ i ], corners[ i ] );
+}
+
+BOOST_AUTO_TEST_CASE(frustum_frustum)
+{
+    const vmml::Frustum< float > frustum( -1.f, 1., -1.f, 1., 1.f, 10.f );
+    vmml::FrustumCuller< float > fc;
+    fc.setup( frustum.compute_matrix( ));
+
+    vmml::FrustumCuller< float > others[4];
+    vmml::Matrix< 4, 4, float > view;
+
+    // same frustum, moved behind the camera, and looking back at it
+    others[0].setup( frustum.compute_matrix( ));
+    view.set_translation( vmml::Vector3f( 0.f, 0.f, -12.f ));
+    others[1].setup( frustum.compute_matrix() * view );
+    view = vmml::Matrix< 4, 4, float >();
+    view.rotate_y( float( M_PI ));
+    view.set_translation( vmml::Vector3f( 0.f, 0.f, -5.f ));
+    others[2].setup( frustum.compute_matrix() * view );
+
+    // side by side
+    view = vmml::Matrix< 4, 4, float >();
+    view.set_translation( vmml::Vector3f( 25.f, 0.f, 0.f ));
+    others[3].setup( frustum.compute_matrix() * view );
+
+    uint8_t result[4];
+    fc.test_frusta( others, 4, result );
+    BOOST_CHECK_EQUAL( result[0], 1 );
+    BOOST_CHECK_EQUAL( result[1], 0 );
+    BOOST_CHECK_EQUAL( result[2], 1 );
+    BOOST_CHECK_EQUAL( result[3], 0 );
+    for( size_t i = 0; i < 4; ++i )
+        BOOST_CHECK_EQUAL( others[i].test_frustum( fc ), result[i] == 1 );
+
+    // unknown corners are conservatively overlapping
+    BOOST_CHECK( fc.test_frustum( vmml::FrustumCuller< float >( )));
+}
+
+BOOST_AUTO_TEST_CASE(frustum_projected_size)
+{
+    // 50 pixels per unit at unit depth in both directions
+    const vmml::Frustum< float > frustum( -2.f, 2.f, -1.f, 1.f, 1.f, 100.f );
+    const vmml::Vector2f viewport( 200.f, 100.f );
+    vmml::Matrix< 4, 4, float > view, inverse;
+    view.rotate_y( .5f );
+    BOOST_REQUIRE( vmml::compute_inverse( view, inverse ));
+
+    vmml::FrustumCuller< float > fc;
+    BOOST_CHECK_EQUAL( fc.get_projected_radius( vmml::Vector4f( 0.f, 0.f,
+                                                                -10.f, 1.f ),
+                                                viewport ), 0.f );
+    fc.setup( frustum.compute_matrix() * view );
+
+    const vmml::Vector4f sphere( inverse * vmml::Vector3f( 0.f, 0.f, -10.f ),
+                                 1.f );
+    BOOST_CHECK_CLOSE( fc.get_projected_radius( sphere, viewport ), 5.f, .01f );
+
+    float radius = -1.f;
+    BOOST_CHECK_EQUAL( fc.test_sphere( sphere, viewport, radius ),
+                       vmml::VISIBILITY_FULL );
+    BOOST_CHECK_CLOSE( radius, 5.f, .01f );
+
+    // culled objects have no size, objects around the eye cover everything
+    const vmml::Vector4f behind( inverse * vmml::Vector3f( 0.f, 0.f, 10.f ),
+                                 1.f );
+    BOOST_CHECK_EQUAL( fc.test_sphere( behind, viewport, radius ),
+                       vmml::VISIBILITY_NONE );
+    BOOST_CHECK_EQUAL( radius, 0.f );
+    BOOST_CHECK_EQUAL( fc.test_sphere( vmml::Vector4f( 0.f, 0.f, 0.f, 2.f ),
+                                       viewport, radius ),
+                       vmml::VISIBILITY_PARTIAL );
+    BOOST_CHECK_EQUAL( radius, std::numeric_limits< float >::max( ));
+
+    // the size of a box is the size of its bounding sphere
+    const vmml::Vector3f center = sphere.get_sub_vector< 3 >();
+    const vmml::AABBf box( center - 2.f, center + 2.f );
+    BOOST_CHECK_EQUAL( fc.test_aabb( box, viewport, radius ),
+                       vmml::VISIBILITY_FULL );
+    BOOST_CHECK_CLOSE( radius, fc.get_projected_radius(
+                           vmml::Vector4f( center, std::sqrt( 12.f )),
+                           viewport ), .01f );
+
+    // batches match the single tests
+    const size_t n = 500;
+    std::vector< vmml::Vector4f > spheres( n );
+    std::vector< vmml::AABBf > boxes( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        vmml::Vector3f point;
+        for( size_t j = 0; j < 3; ++j )
+            point[ j ] = std::rand() / float( RAND_MAX ) * 120.f - 60.f;
+        const float size = std::rand() / float( RAND_MAX ) * 5.f;
+        spheres[ i ] = vmml::Vector4f( point, size );
+        boxes[ i ] = vmml::AABBf( point - size, point + size );
+    }
+
+    std::vector< vmml::Visibility > sphereVisibility( n ), boxVisibility( n );
+    std::vector< float > sphereRadius( n ), boxRadius( n );
+    fc.test_spheres( spheres.data(), n, viewport, sphereVisibility.data(),
+                     sphereRadius.data( ));
+    fc.test_aabbs( boxes.data(), n, viewport, boxVisibility.data(),
+                   boxRadius.data( ));
+    for( size_t i = 0; i < n; ++i )
+    {
+        BOOST_CHECK_EQUAL( sphereVisibility[ i ],
+                           fc.test_sphere( spheres[ i ], viewport, radius ));
+        BOOST_CHECK_CLOSE( sphereRadius[ i ], radius, .01f );
+        BOOST_CHECK_EQUAL( boxVisibility[ i ],
+                           fc.test_aabb( boxes[ i ], viewport, radius ));
+        BOOST_CHECK_CLOSE( boxRadius[ i ], radius, .01f );
+    }
+
+    // orthographic projections have the same size at any depth, 50 pixels
+    // per unit
+    const vmml::Frustum< float > ortho( -10.f, 10.f, -10.f, 10.f, 1.f, 100.f );
+    const vmml::Vector2f orthoViewport( 1000.f, 1000.f );
+    fc.setup( ortho.compute_ortho_matrix( ));
+    BOOST_CHECK_CLOSE( fc.get_projected_radius(
+                           vmml::Vector4f( 0.f, 0.f, -50.f, 2.f ),
+                           orthoViewport ), 100.f, .01f );
+    BOOST_CHECK_CLOSE( fc.get_projected_radius(
+                           vmml::Vector4f( 3.f, 0.f, -2.f, .5f ),
+                           orthoViewport ), 25.f, .01f );
+
+    const vmml::AABBf orthoBox( vmml::Vector3f( -1.f, -1.f, -51.f ),
+                                vmml::Vector3f( 1.f, 1.f, -49.f ));
+    BOOST_CHECK_EQUAL( fc.test_aabb( orthoBox, orthoViewport, radius ),
+                       vmml::VISIBILITY_FULL );
+    BOOST_CHECK_CLOSE( radius, std::sqrt( 3.f ) * 50.f, .01f );
+
+    fc.test_spheres( spheres.data(), n, orthoViewport, sphereVisibility.data(),
+                     sphereRadius.data( ));
+    for( size_t i = 0; i < n; ++i )
+        if( sphereVisibility[ i ] != vmml::VISIBILITY_NONE )
+            BOOST_CHECK_CLOSE( sphereRadius[ i ], spheres[ i ].w() * 50.f,
+                               .01f );
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/frustum_grid.hpp>
+
+#define BOOST_TEST_MODULE frustum_grid
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+
+using namespace vmml;
+
+namespace
+{
+double _random( const double min, const double max )
+{
+    return min + ( max - min ) * ( std::rand() / double( RAND_MAX ));
+}
+
+// the culler of one cluster, set up from its own frustum
+FrustumCullerd _getCuller( const Frustumd& frustum, const FrustumGridd& grid,
+                           const Matrix4d& modelview, const size_t x,
+                           const size_t y, const size_t z )
+{
+    const double depth = grid.get_slice_depth( z );
+    const double scale = depth / frustum.near_plane();
+    const double width = frustum.get_width() / double( grid.get_size( 0 ));
+    const double height = frustum.get_height() / double( grid.get_size( 1 ));
+    const double left = frustum.left() + width * double( x );
+    const double bottom = frustum.bottom() + height * double( y );
+
+    const Frustumd cluster( left * scale, ( left + width ) * scale,
+                            bottom * scale, ( bottom + height ) * scale,
+                            depth, grid.get_slice_depth( z + 1 ));
+    FrustumCullerd culler;
+    culler.setup( cluster.compute_matrix() * modelview );
+    return culler;
+}
+}
+
+BOOST_AUTO_TEST_CASE(frustum_grid_slices)
+{
+    const Frustumd frustum( -2., 1., -1., 1., 1., 1000. );
+    const FrustumGridd grid( frustum, 4, 3, 6 );
+
+    BOOST_CHECK_EQUAL( grid.get_size( 0 ), 4 );
+    BOOST_CHECK_EQUAL( grid.get_size( 1 ), 3 );
+    BOOST_CHECK_EQUAL( grid.get_size( 2 ), 6 );
+    BOOST_CHECK_CLOSE( grid.get_slice_depth( 0 ), 1., 1e-9 );
+    BOOST_CHECK_CLOSE( grid.get_slice_depth( 3 ), std::sqrt( 1000. ), 1e-9 );
+    BOOST_CHECK_CLOSE( grid.get_slice_depth( 6 ), 1000., 1e-9 );
+
+    BOOST_CHECK_EQUAL( grid.get_slice( .5 ), 0 );
+    BOOST_CHECK_EQUAL( grid.get_slice( 3. ), 0 );
+    BOOST_CHECK_EQUAL( grid.get_slice( 4. ), 1 );
+    BOOST_CHECK_EQUAL( grid.get_slice( 999. ), 5 );
+    BOOST_CHECK_EQUAL( grid.get_slice( 2000. ), 5 );
+
+    // the z slice table: normal along -z, at the slice depths
+    const double* planes = grid.get_planes( 2 );
+    for( size_t i = 0; i <= 6; ++i )
+    {
+        BOOST_CHECK_EQUAL( planes[ i ], 0. );
+        BOOST_CHECK_EQUAL( planes[ 7 + i ], 0. );
+        BOOST_CHECK_EQUAL( planes[ 14 + i ], -1. );
+        BOOST_CHECK_CLOSE( planes[ 21 + i ], -grid.get_slice_depth( i ),
+                           1e-9 );
+    }
+
+    // empty grids are rejected
+    FrustumGridd empty;
+    BOOST_CHECK_THROW( empty.setup( frustum, 4, 3, 0 ), vmml::exception );
+    BOOST_CHECK_THROW( empty.setup( frustum, 0, 3, 6 ), vmml::exception );
+    BOOST_CHECK_EQUAL( empty.get_size( 2 ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(frustum_grid_clusters)
+{
+    const Frustumd frustum( -1., 1., -.5, .5, 1., 100. );
+    Matrix4d modelview;
+    modelview.rotate_y( .3 );
+    modelview.set_translation( Vector3d( 1., 2., 3. ));
+    const FrustumGridd grid( frustum, 4, 3, 5, modelview );
+
+    FrustumCullerd cullers[ 4 ][ 3 ][ 5 ];
+    for( size_t x = 0; x < 4; ++x )
+        for( size_t y = 0; y < 3; ++y )
+            for( size_t z = 0; z < 5; ++z )
+                cullers[x][y][z] = _getCuller( frustum, grid, modelview,
+                                               x, y, z );
+
+    Matrix4d inverse;
+    BOOST_REQUIRE( modelview.inverse( inverse ));
+
+    for( size_t i = 0; i < 200; ++i )
+    {
+        // spheres around the frustum
+        const double depth = _random( 0., 110. );
+        const Vector3d view( _random( -1.2, 1.2 ) * depth,
+                             _random( -.7, .7 ) * depth, -depth );
+        const Vector3d center = inverse * view;
+        const Vector4d sphere( center, _random( 0., .2 * depth ));
+
+        Vector< 3, size_t > first, last;
+        const bool touched = grid.get_ranges( sphere, first, last );
+        size_t nVisible = 0;
+        for( size_t x = 0; x < 4; ++x )
+            for( size_t y = 0; y < 3; ++y )
+                for( size_t z = 0; z < 5; ++z )
+                {
+                    const Visibility visibility =
+                        grid.test_sphere( sphere, x, y, z );
+                    BOOST_CHECK_EQUAL( visibility,
+                                       cullers[x][y][z].test_sphere( sphere ));
+                    if( visibility == VISIBILITY_NONE )
+                        continue;
+
+                    // the ranges contain all touched clusters
+                    ++nVisible;
+                    BOOST_CHECK( x >= first[0] && x < last[0] );
+                    BOOST_CHECK( y >= first[1] && y < last[1] );
+                    BOOST_CHECK( z >= first[2] && z < last[2] );
+                }
+        BOOST_CHECK( touched || nVisible == 0 );
+
+        // boxes around the sphere touch at least the same clusters
+        const AABBd box( center - sphere.w(), center + sphere.w( ));
+        Vector< 3, size_t > boxFirst, boxLast;
+        if( touched )
+        {
+            BOOST_CHECK( grid.get_ranges( box, boxFirst, boxLast ));
+            for( size_t j = 0; j < 3; ++j )
+            {
+                BOOST_CHECK_LE( boxFirst[j], first[j] );
+                BOOST_CHECK_GE( boxLast[j], last[j] );
+            }
+        }
+    }
+}
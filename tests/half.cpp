@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/half.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#define BOOST_TEST_MODULE half
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+uint32_t _floatBits( const float value )
+{
+    uint32_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ));
+    return bits;
+}
+
+float _bitsFloat( const uint32_t bits )
+{
+    float value;
+    std::memcpy( &value, &bits, sizeof( value ));
+    return value;
+}
+}
+
+BOOST_AUTO_TEST_CASE(half_conversion)
+{
+    BOOST_CHECK_EQUAL( half( 1.f ).get_bits(), 0x3c00 );
+    BOOST_CHECK_EQUAL( half( -2.f ).get_bits(), 0xc000 );
+    BOOST_CHECK_EQUAL( half( 0.f ).get_bits(), 0x0000 );
+    BOOST_CHECK_EQUAL( half( -0.f ).get_bits(), 0x8000 );
+    BOOST_CHECK_EQUAL( half( 65504.f ).get_bits(), 0x7bff );
+    BOOST_CHECK_EQUAL( half( 65519.f ).get_bits(), 0x7bff );
+    BOOST_CHECK_EQUAL( half( 65520.f ).get_bits(), 0x7c00 );
+    BOOST_CHECK_EQUAL( half( -1e10f ).get_bits(), 0xfc00 );
+    BOOST_CHECK_EQUAL( half( std::ldexp( 1.f, -14 )).get_bits(), 0x0400 );
+    BOOST_CHECK_EQUAL( half( std::ldexp( 1.f, -24 )).get_bits(), 0x0001 );
+    BOOST_CHECK_EQUAL( half( std::ldexp( 1.f, -25 )).get_bits(), 0x0000 );
+    BOOST_CHECK_EQUAL( half( std::ldexp( 3.f, -26 )).get_bits(), 0x0001 );
+    BOOST_CHECK_EQUAL( half( std::ldexp( 3.f, -25 )).get_bits(), 0x0002 );
+
+    // ties round to even
+    BOOST_CHECK_EQUAL( half( 1.f + std::ldexp( 1.f, -11 )).get_bits(), 0x3c00 );
+    BOOST_CHECK_EQUAL( half( 1.f + std::ldexp( 3.f, -11 )).get_bits(), 0x3c02 );
+    BOOST_CHECK_EQUAL( half( 2049.f ).get_bits(), half( 2048.f ).get_bits( ));
+
+    BOOST_CHECK( std::isnan( float( half( std::nanf( "" )))));
+    BOOST_CHECK( std::isinf( float( half::from_bits( 0x7c00 ))));
+
+    // all halves convert to float and back unchanged
+    for( uint32_t bits = 0; bits < 0x10000; ++bits )
+    {
+        const half value = half::from_bits( uint16_t( bits ));
+        const float f = value;
+        if( std::isnan( f ))
+        {
+            BOOST_CHECK(( bits & 0x7c00 ) == 0x7c00 && ( bits & 0x3ff ));
+            continue;
+        }
+        BOOST_REQUIRE_EQUAL( half( f ).get_bits(), bits );
+    }
+
+#ifdef __FLT16_MAX__
+    // float to half rounds like the compiler's _Float16
+    for( uint64_t bits = 0; bits < 0x100000000ull; bits += 4093 )
+    {
+        const float f = _bitsFloat( uint32_t( bits ));
+        if( std::isnan( f ))
+            continue;
+        const _Float16 expected = _Float16( f );
+        uint16_t expectedBits;
+        std::memcpy( &expectedBits, &expected, sizeof( expectedBits ));
+        BOOST_REQUIRE_EQUAL( half( f ).get_bits(), expectedBits );
+    }
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(bfloat16_conversion)
+{
+    BOOST_CHECK_EQUAL( bfloat16( 1.f ).get_bits(), 0x3f80 );
+    BOOST_CHECK_EQUAL( bfloat16( -2.f ).get_bits(), 0xc000 );
+    BOOST_CHECK_EQUAL( float( bfloat16( 3e38f )), _bitsFloat( 0x7f620000 ));
+    BOOST_CHECK_EQUAL( bfloat16( std::numeric_limits< float >::max( ))
+                           .get_bits(), 0x7f80 );
+
+    // ties round to even
+    BOOST_CHECK_EQUAL( bfloat16( _bitsFloat( 0x3f808000 )).get_bits(), 0x3f80 );
+    BOOST_CHECK_EQUAL( bfloat16( _bitsFloat( 0x3f818000 )).get_bits(), 0x3f82 );
+    BOOST_CHECK_EQUAL( bfloat16( _bitsFloat( 0x3f808001 )).get_bits(), 0x3f81 );
+
+    BOOST_CHECK( std::isnan( float( bfloat16( _bitsFloat( 0x7fffffff )))));
+    BOOST_CHECK( std::isnan( float( bfloat16( _bitsFloat( 0x7f800001 )))));
+
+    for( uint32_t bits = 0; bits < 0x10000; ++bits )
+    {
+        const float f = bfloat16::from_bits( uint16_t( bits ));
+        BOOST_REQUIRE_EQUAL( _floatBits( f ), bits << 16 );
+        if( !std::isnan( f ))
+            BOOST_REQUIRE_EQUAL( bfloat16( f ).get_bits(), bits );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(half_bulk_conversion)
+{
+    const size_t n = 13;
+    std::vector< float > values( n );
+    for( size_t i = 0; i < n; ++i )
+        values[ i ] = float( i ) * .37f - 2.f;
+
+    std::vector< half > halves( n );
+    std::vector< bfloat16 > bfloats( n );
+    std::vector< float > result( n );
+    convert( values.data(), halves.data(), n );
+    convert( values.data(), bfloats.data(), n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        BOOST_CHECK_EQUAL( halves[ i ].get_bits(),
+                           half( values[ i ] ).get_bits( ));
+        BOOST_CHECK_EQUAL( bfloats[ i ].get_bits(),
+                           bfloat16( values[ i ] ).get_bits( ));
+    }
+
+    convert( halves.data(), result.data(), n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        BOOST_CHECK_EQUAL( result[ i ], float( halves[ i ] ));
+        BOOST_CHECK_CLOSE( result[ i ], values[ i ], .1f );
+    }
+    convert( bfloats.data(), result.data(), n );
+    for( size_t i = 0; i < n; ++i )
+        BOOST_CHECK_CLOSE( result[ i ], values[ i ], 1.f );
+}
+
+BOOST_AUTO_TEST_CASE(half_vector_matrix)
+{
+    BOOST_CHECK_EQUAL( sizeof( Vector3h ), 6 );
+    BOOST_CHECK_EQUAL( sizeof( Matrix4h ), 32 );
+
+    // arithmetic promotes to float, stores round once
+    half value = 1.f;
+    value += 2.5f;
+    BOOST_CHECK_EQUAL( float( value ), 3.5f );
+    BOOST_CHECK_EQUAL( float( -value * value ), -12.25f );
+    BOOST_CHECK( value > 3 && value == 3.5f );
+
+    const Vector3h a( 1.f, 2.f, 3.f );
+    const Vector3h b( .5f, .5f, .5f );
+    const Vector3h sum = a + b;
+    BOOST_CHECK_EQUAL( sum, Vector3h( 1.5f, 2.5f, 3.5f ));
+    BOOST_CHECK_EQUAL( float( a.dot( b )), 3.f );
+    BOOST_CHECK_EQUAL( a.dot< accumulation_type< half >::type >( b ), 3.f );
+
+    Vector3f af;
+    af.cast_from( a );
+    BOOST_CHECK_EQUAL( af, Vector3f( 1.f, 2.f, 3.f ));
+
+    Matrix4h scale;
+    scale.array[ 0 ] = scale.array[ 5 ] = scale.array[ 10 ] = 2.f;
+    Matrix4h product;
+    product.multiply< float >( scale, Matrix4h::IDENTITY );
+    BOOST_CHECK_EQUAL( float( product( 1, 1 )), 2.f );
+    BOOST_CHECK_EQUAL( float( product( 3, 3 )), 1.f );
+    BOOST_CHECK_EQUAL( float( product( 0, 3 )), 0.f );
+
+    std::ostringstream os;
+    os << half( 1.5f ) << " " << bfloat16( -2.f );
+    BOOST_CHECK_EQUAL( os.str(), "1.5 -2" );
+    std::istringstream is( "0.25 8" );
+    half h;
+    bfloat16 bf;
+    is >> h >> bf;
+    BOOST_CHECK_EQUAL( float( h ), .25f );
+    BOOST_CHECK_EQUAL( float( bf ), 8.f );
+
+    BOOST_CHECK_EQUAL( float( std::numeric_limits< half >::max( )), 65504.f );
+    BOOST_CHECK_EQUAL( float( std::numeric_limits< half >::epsilon( )),
+                       std::ldexp( 1.f, -10 ));
+    BOOST_CHECK_EQUAL( float( std::numeric_limits< bfloat16 >::epsilon( )),
+                       std::ldexp( 1.f, -7 ));
+    BOOST_CHECK_EQUAL( float( std::numeric_limits< bfloat16 >::min( )),
+                       std::numeric_limits< float >::min( ));
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// instrument with the built-in backends, and compile the ITT backend against
+// the ittnotify.h stubs of CMake/common
+#define VMMLIB_INSTRUMENT
+#define VMMLIB_INSTRUMENT_ITT
+#define INTEL_NO_ITTNOTIFY_API
+
+#include <vmmlib/aabb.hpp>
+#include <vmmlib/frustum.hpp>
+#include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/instrument.hpp>
+#include <vmmlib/matrix.hpp>
+
+#define BOOST_TEST_MODULE instrument
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+uint64_t _count( const char* name )
+{
+    uint64_t count = 0;
+    for( instrument::Region* region = instrument::Region::get_first(); region;
+         region = region->get_next( ))
+    {
+        if( std::strcmp( region->get_name(), name ) == 0 )
+            count += region->get_count();
+    }
+    return count;
+}
+
+class TestBackend : public instrument::Backend
+{
+public:
+    TestBackend() : depth( 0 ), calls( 0 ) {}
+
+    uint64_t begin( instrument::Region& ) final
+    {
+        ++calls;
+        return ++depth;
+    }
+
+    void end( instrument::Region&, const uint64_t token ) final
+    {
+        BOOST_CHECK_EQUAL( token, depth );
+        --depth;
+    }
+
+    uint64_t depth;
+    size_t calls;
+};
+
+void _run()
+{
+    FrustumCullerf culler;
+    culler.setup( Frustumf( -1.f, 1.f, -1.f, 1.f, 1.f, 10.f ).compute_matrix( ));
+    std::vector< AABBf > boxes( 10, AABBf( Vector3f( -1.f ), Vector3f( 1.f )));
+    std::vector< Visibility > visibility( boxes.size( ));
+    culler.test_aabbs( boxes.data(), boxes.size(), visibility.data( ));
+
+    const float points[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f };
+    AABBf::fromPoints( points, 2 );
+
+    // only large products are regions
+    const Matrix< 8, 8, float > large = Matrix< 8, 8, float >::IDENTITY;
+    const Matrix< 8, 8, float > product = large * large;
+    BOOST_CHECK_EQUAL( product, large );
+    const Matrix4f small = Matrix4f::IDENTITY * Matrix4f::IDENTITY;
+    BOOST_CHECK_EQUAL( small, Matrix4f::IDENTITY );
+}
+}
+
+BOOST_AUTO_TEST_CASE(instrument_counters)
+{
+    // the default backend ignores all regions
+    BOOST_CHECK_EQUAL( &instrument::get_backend(),
+                       &instrument::get_null_backend( ));
+    _run();
+    BOOST_CHECK_EQUAL( _count( "FrustumCuller::test_aabbs" ), 0 );
+
+    instrument::CounterBackend counters;
+    instrument::set_backend( &counters );
+    _run();
+    _run();
+    instrument::set_backend( 0 );
+    _run();
+
+    BOOST_CHECK_EQUAL( _count( "FrustumCuller::test_aabbs" ), 2 );
+    BOOST_CHECK_EQUAL( _count( "AABB::mergePoints" ), 2 );
+    BOOST_CHECK_EQUAL( _count( "Matrix::multiply" ), 2 );
+    BOOST_CHECK_EQUAL( _count( "QuaternionBatch::multiply" ), 0 );
+
+    std::ostringstream report;
+    instrument::CounterBackend::print( report );
+    BOOST_CHECK_NE( report.str().find( "AABB::mergePoints" ),
+                    std::string::npos );
+
+    instrument::CounterBackend::reset();
+    BOOST_CHECK_EQUAL( _count( "FrustumCuller::test_aabbs" ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(instrument_backends)
+{
+    TestBackend backend;
+    instrument::set_backend( &backend );
+    _run();
+    instrument::set_backend( 0 );
+
+    // test_aabbs, mergePoints and the 8x8 multiply
+    BOOST_CHECK_EQUAL( backend.calls, 3 );
+    BOOST_CHECK_EQUAL( backend.depth, 0 );
+
+    instrument::IttBackend itt;
+    instrument::set_backend( &itt );
+    _run();
+    instrument::set_backend( 0 );
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/lowpass_filter.hpp>
+#include <vmmlib/vector.hpp>
+
+#define BOOST_TEST_MODULE lowpass_filter
+#include <boost/test/unit_test.hpp>
+
+using namespace vmml;
+
+BOOST_AUTO_TEST_CASE(lowpass_filter_window)
+{
+    const double data[] = { 0, 2, 4, 8, 16 };
+    LowpassFilter< 4, double > filter( .5f );
+    BOOST_CHECK_EQUAL( filter.get_mode(), LOWPASS_WINDOW );
+
+    BOOST_CHECK_EQUAL( filter.add( data[0] ), 0. );
+    BOOST_CHECK_EQUAL( filter.add( data[1] ), 1. );
+    for( size_t i = 2; i < 5; ++i )
+        filter.add( data[i] );
+    BOOST_CHECK_EQUAL( filter.size(), 4 );
+
+    // 16, then 8, 4 and 2 blended in with weights .5, .25 and .125
+    BOOST_CHECK_EQUAL( filter.get(), 9. );
+    BOOST_CHECK_EQUAL( *filter, 9. );
+
+    // old samples leave the window
+    for( size_t i = 0; i < 4; ++i )
+        filter.add( 3. );
+    BOOST_CHECK_EQUAL( filter.get(), 3. );
+
+    filter.reset();
+    BOOST_CHECK_EQUAL( filter.size(), 0 );
+    BOOST_CHECK_EQUAL( filter.add( 5. ), 5. );
+}
+
+BOOST_AUTO_TEST_CASE(lowpass_filter_exponential)
+{
+    LowpassFilter< 4, Vector3f > filter( .75f, LOWPASS_EXPONENTIAL );
+    BOOST_CHECK_EQUAL( filter.get_mode(), LOWPASS_EXPONENTIAL );
+
+    const Vector3f first( 4.f, 8.f, 16.f );
+    BOOST_CHECK_EQUAL( filter.add( first ), first );
+    BOOST_CHECK_EQUAL( filter.add( Vector3f::ZERO ), first * .75f );
+    BOOST_CHECK_EQUAL( filter.add( Vector3f::ZERO ), first * .5625f );
+    BOOST_CHECK_EQUAL( filter->x(), 2.25f );
+
+    // converges to a constant input
+    for( size_t i = 0; i < 100; ++i )
+        filter.add( Vector3f::ONE );
+    BOOST_CHECK_CLOSE( filter->x(), 1.f, .0001f );
+    BOOST_CHECK_CLOSE( filter->z(), 1.f, .0001f );
+
+    filter.reset();
+    BOOST_CHECK_EQUAL( filter.add( first ), first );
+}
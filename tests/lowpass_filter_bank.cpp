@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/lowpass_filter_bank.hpp>
+#include <vmmlib/vector.hpp>
+
+#define BOOST_TEST_MODULE lowpass_filter_bank
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+const size_t window = 5;
+const size_t nSensors = 7;
+
+float _random( const float min, const float max )
+{
+    return min + ( max - min ) * ( std::rand() / float( RAND_MAX ));
+}
+
+void _testBank( const LowpassMode mode )
+{
+    // one Vector3f stream per sensor, three channels each
+    LowpassFilterBank< window, float > bank( nSensors * 3, .5f, mode );
+    BOOST_CHECK_EQUAL( bank.get_num_channels(), nSensors * 3 );
+    BOOST_CHECK_EQUAL( bank.get_mode(), mode );
+
+    std::vector< LowpassFilter< window, Vector3f > > filters;
+    for( size_t i = 0; i < nSensors; ++i )
+    {
+        const float factor = _random( .1f, .9f );
+        filters.push_back( LowpassFilter< window, Vector3f >( factor, mode ));
+        for( size_t j = 0; j < 3; ++j )
+            bank.set_smooth_factor( i * 3 + j, factor );
+        BOOST_CHECK_EQUAL( bank.get_smooth_factor( i * 3 ), factor );
+    }
+
+    std::vector< float > frame( nSensors * 3 );
+    for( size_t frameIndex = 0; frameIndex < 3 * window; ++frameIndex )
+    {
+        for( size_t i = 0; i < nSensors; ++i )
+        {
+            const Vector3f sample( _random( -10.f, 10.f ),
+                                   _random( -10.f, 10.f ),
+                                   _random( -10.f, 10.f ));
+            filters[ i ].add( sample );
+            for( size_t j = 0; j < 3; ++j )
+                frame[ i * 3 + j ] = sample[ j ];
+        }
+
+        const float* values = bank.add( frame.data( ));
+        BOOST_CHECK_EQUAL( values, bank.get( ));
+        for( size_t i = 0; i < nSensors; ++i )
+            for( size_t j = 0; j < 3; ++j )
+                BOOST_CHECK_SMALL( values[ i * 3 + j ] -
+                                   filters[ i ].get()[ j ], .0001f );
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(lowpass_filter_bank_window)
+{
+    _testBank( LOWPASS_WINDOW );
+}
+
+BOOST_AUTO_TEST_CASE(lowpass_filter_bank_exponential)
+{
+    _testBank( LOWPASS_EXPONENTIAL );
+}
+
+BOOST_AUTO_TEST_CASE(lowpass_filter_bank_frames)
+{
+    const double frames[] = { 0, 1,  2, 1,  4, 1,  8, 1,  16, 1 };
+    LowpassFilterBank< 4, double > bank( 2, .5 );
+
+    // same result as LowpassFilter for the same data, constant stays constant
+    bank.add( frames, 5 );
+    BOOST_CHECK_EQUAL( bank.size(), 4 );
+    BOOST_CHECK_EQUAL( bank.get( 0 ), 9. );
+    BOOST_CHECK_EQUAL( bank.get( 1 ), 1. );
+
+    bank.set_smooth_factor( 0. );
+    bank.add( frames + 2 );
+    BOOST_CHECK_EQUAL( bank.get( 0 ), 2. );
+
+    bank.reset();
+    BOOST_CHECK_EQUAL( bank.size(), 0 );
+    bank.add( frames + 6 );
+    BOOST_CHECK_EQUAL( bank.get( 0 ), 8. );
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/multi_frustum_culler.hpp>
+#include <vmmlib/frustum.hpp>
+
+#define BOOST_TEST_MODULE multi_frustum_culler
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+const size_t nViews = 8;
+typedef MultiFrustumCuller< float, nViews > MultiFrustumCuller8f;
+
+float _random( const float min, const float max )
+{
+    return min + ( max - min ) * ( std::rand() / float( RAND_MAX ));
+}
+}
+
+BOOST_AUTO_TEST_CASE(multi_frustum_culler)
+{
+    // six cube map faces, a stereo pair and an unused view
+    const Frustumf frustum( -1.f, 1.f, -1.f, 1.f, .5f, 50.f );
+    Matrix4f views[ nViews ];
+    views[ 1 ].rotate_y( float( M_PI ) * .5f );
+    views[ 2 ].rotate_y( float( M_PI ));
+    views[ 3 ].rotate_y( float( M_PI ) * 1.5f );
+    views[ 4 ].rotate_x( float( M_PI ) * .5f );
+    views[ 5 ].rotate_x( float( M_PI ) * -.5f );
+    views[ 6 ].set_translation( Vector3f( .1f, 0.f, 0.f ));
+    views[ 7 ].set_translation( Vector3f( -.1f, 0.f, 0.f ));
+
+    MultiFrustumCuller8f multiCuller;
+    FrustumCullerf cullers[ nViews ];
+    for( size_t i = 0; i < nViews - 1; ++i )
+    {
+        const Matrix4f matrix = frustum.compute_matrix() * views[ i ];
+        multiCuller.setup( i, matrix );
+        cullers[ i ].setup( matrix );
+    }
+
+    const size_t n = 500;
+    std::vector< Vector4f > spheres( n );
+    std::vector< AABBf > boxes( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        const Vector3f center( _random( -60.f, 60.f ), _random( -60.f, 60.f ),
+                               _random( -60.f, 60.f ));
+        spheres[ i ] = Vector4f( center, _random( 0.f, 10.f ));
+        boxes[ i ] = AABBf( center - _random( 0.f, 10.f ),
+                            center + _random( 0.f, 10.f ));
+    }
+
+    std::vector< uint64_t > sphereMasks( n ), sphereFull( n );
+    std::vector< uint64_t > boxMasks( n ), boxFull( n );
+    multiCuller.test_spheres( spheres.data(), n, sphereMasks.data(),
+                              sphereFull.data( ));
+    multiCuller.test_aabbs( boxes.data(), n, boxMasks.data(),
+                            boxFull.data( ));
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        BOOST_CHECK_EQUAL( multiCuller.test_sphere( spheres[ i ] ),
+                           sphereMasks[ i ] );
+        BOOST_CHECK_EQUAL( multiCuller.test_aabb( boxes[ i ] ), boxMasks[ i ]);
+
+        for( size_t j = 0; j < nViews - 1; ++j )
+        {
+            BOOST_CHECK_EQUAL( MultiFrustumCuller8f::get_visibility(
+                                   sphereMasks[ i ], sphereFull[ i ], j ),
+                               cullers[ j ].test_sphere( spheres[ i ] ));
+            BOOST_CHECK_EQUAL( MultiFrustumCuller8f::get_visibility(
+                                   boxMasks[ i ], boxFull[ i ], j ),
+                               cullers[ j ].test_aabb( boxes[ i ] ));
+        }
+
+        // the unused view sees everything
+        BOOST_CHECK( sphereFull[ i ] & ( uint64_t( 1 ) << ( nViews - 1 )));
+        BOOST_CHECK( boxFull[ i ] & ( uint64_t( 1 ) << ( nViews - 1 )));
+    }
+}
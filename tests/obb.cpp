@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/obb.hpp>
+#include <vmmlib/frustum.hpp>
+#include <vmmlib/frustum_culler.hpp>
+
+#define BOOST_TEST_MODULE obb
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+// rotation by 45 degrees around the given axis
+Matrix3d _rotation45( const size_t axis )
+{
+    const double s = std::sqrt( .5 );
+    const size_t u = ( axis + 1 ) % 3;
+    const size_t v = ( axis + 2 ) % 3;
+    Matrix3d m;
+    m( u, u ) = s;
+    m( u, v ) = -s;
+    m( v, u ) = s;
+    m( v, v ) = s;
+    return m;
+}
+}
+
+BOOST_AUTO_TEST_CASE(obb_fit)
+{
+    // points on a rotated and translated box with half extents 4, 2, 1
+    Matrix4d transform;
+    transform.rotate_z( .3 );
+    transform.rotate_x( .7 );
+    transform.set_translation( Vector3d( 1., -2., 3. ));
+
+    std::vector< double > xyz;
+    for( size_t i = 0; i < 1000; ++i )
+    {
+        const Vector3d local( std::rand() / double( RAND_MAX ) * 8. - 4.,
+                              std::rand() / double( RAND_MAX ) * 4. - 2.,
+                              std::rand() / double( RAND_MAX ) * 2. - 1. );
+        const Vector3d point = transform * local;
+        xyz.insert( xyz.end(), point.begin(), point.end( ));
+    }
+    const size_t n = xyz.size() / 3;
+
+    const OBBd obb = OBBd::fromPoints( xyz.data(), n );
+    for( size_t i = 0; i < n; ++i )
+        BOOST_CHECK( obb.isIn( Vector3d( &xyz[ 3 * i ] ) +
+                               ( Vector3d( &xyz[ 3 * i ] ) -
+                                 obb.getCenter( )) * -1e-9 ));
+
+    // orthonormal, right-handed axes along the box axes
+    const Matrix3d& axes = obb.getAxes();
+    Matrix3d identity;
+    BOOST_CHECK( ( transpose( axes ) * axes ).equals( identity, 1e-9 ));
+    BOOST_CHECK_CLOSE( obb.getAxis( 0 ).cross( obb.getAxis( 1 )).dot(
+                           obb.getAxis( 2 )), 1., 1e-6 );
+
+    const Vector3d& halfExtents = obb.getHalfExtents();
+    BOOST_CHECK_CLOSE( halfExtents.x(), 4., 10. );
+    BOOST_CHECK_CLOSE( halfExtents.y(), 2., 10. );
+    BOOST_CHECK_CLOSE( halfExtents.z(), 1., 10. );
+    BOOST_CHECK( obb.getCenter().equals( Vector3d( 1., -2., 3. ), .2 ));
+
+    const Vector3d xAxis( transform( 0, 0 ), transform( 1, 0 ),
+                          transform( 2, 0 ));
+    BOOST_CHECK_CLOSE( std::abs( obb.getAxis( 0 ).dot( xAxis )), 1., .1 );
+
+    BOOST_CHECK_EQUAL( OBBd::fromPoints( xyz.data(), 0 ), OBBd( ));
+}
+
+BOOST_AUTO_TEST_CASE(obb_transform)
+{
+    const OBBd box( AABBd( Vector3d( -1., -2., -3. ), Vector3d( 1., 2., 3. )));
+    Vector3d corners[8];
+    box.getCorners( corners );
+    BOOST_CHECK_EQUAL( corners[0], Vector3d( -1., -2., -3. ));
+    BOOST_CHECK_EQUAL( corners[7], Vector3d( 1., 2., 3. ));
+    BOOST_CHECK_EQUAL( box.getAABB(), AABBd( corners[0], corners[7] ));
+
+    Matrix4d rigid;
+    rigid.rotate_y( .5 );
+    rigid.set_translation( Vector3d( 5., 0., 0. ));
+    const OBBd moved = box.transform( rigid );
+    BOOST_CHECK( moved.getHalfExtents().equals( box.getHalfExtents(), 1e-12 ));
+    BOOST_CHECK( moved.getCenter().equals( Vector3d( 5., 0., 0. ), 1e-12 ));
+
+    Vector3d movedCorners[8];
+    moved.getCorners( movedCorners );
+    for( size_t i = 0; i < 8; ++i )
+        BOOST_CHECK( movedCorners[i].equals( rigid * corners[i], 1e-12 ));
+
+    // a shear can only be bounded
+    Matrix4d shear;
+    shear( 0, 1 ) = 1.;
+    const OBBd sheared = box.transform( shear );
+    for( size_t i = 0; i < 8; ++i )
+    {
+        const Vector3d corner = shear * corners[i];
+        BOOST_CHECK( sheared.isIn( corner + ( sheared.getCenter() - corner ) *
+                                            1e-9 ));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(obb_intersects)
+{
+    const Vector3d half( 1. );
+    const OBBd a( Vector3d::ZERO, _rotation45( 2 ), half );
+    const double s = std::sqrt( 2. );
+
+    // separated along a face axis
+    BOOST_CHECK( !a.intersects( OBBd( Vector3d( 0., 0., 2.1 ), Matrix3d(),
+                                      half )));
+    BOOST_CHECK( a.intersects( OBBd( Vector3d( 0., 0., 1.9 ), Matrix3d(),
+                                     half )));
+
+    // edge against edge, only separated along the cross product of the edges
+    const Matrix3d rotY = _rotation45( 1 );
+    BOOST_CHECK( !a.intersects( OBBd( Vector3d( 2. * s + .1, 0., 0. ), rotY,
+                                      half )));
+    BOOST_CHECK( a.intersects( OBBd( Vector3d( 2. * s - .1, 0., 0. ), rotY,
+                                     half )));
+
+    // contained
+    BOOST_CHECK( a.intersects( OBBd( Vector3d( .1, 0., 0. ), rotY,
+                                     half * .1 )));
+    BOOST_CHECK( a.intersects( a ));
+}
+
+BOOST_AUTO_TEST_CASE(obb_culling)
+{
+    const Frustumf frustum( -1.f, 1., -1.f, 1., 1.f, 100.f );
+    FrustumCullerf culler;
+    culler.setup( frustum.compute_matrix( ));
+
+    const AABBf in( Vector3f( -1.f, -1.f, -4.f ), Vector3f( 1.f, 1.f, -2.f ));
+    const AABBf out( Vector3f( -1.f, -1.f, -.5f ), Vector3f( 1.f, 1.f, 0.f ));
+    const AABBf border( Vector3f( -1.f, -1.f, -1.5f ),
+                        Vector3f( 1.f, 1.f, -.5f ));
+    BOOST_CHECK_EQUAL( culler.test_obb( OBBf( in )), VISIBILITY_FULL );
+    BOOST_CHECK_EQUAL( culler.test_obb( OBBf( out )), VISIBILITY_NONE );
+    BOOST_CHECK_EQUAL( culler.test_obb( OBBf( border )), VISIBILITY_PARTIAL );
+
+    // a thin rotated box fits where its bounding AABB does not
+    Matrix3f rotation;
+    rotation( 0, 0 ) = rotation( 2, 2 ) = std::sqrt( .5f );
+    rotation( 0, 2 ) = std::sqrt( .5f );
+    rotation( 2, 0 ) = -std::sqrt( .5f );
+    const OBBf diagonal( Vector3f( 2.f, 0.f, -5.f ), rotation,
+                         Vector3f( 3.f, .1f, .1f ));
+    BOOST_CHECK_EQUAL( culler.test_obb( diagonal ), VISIBILITY_FULL );
+    BOOST_CHECK_EQUAL( culler.test_aabb( diagonal.getAABB( )),
+                       VISIBILITY_PARTIAL );
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/occlusion_buffer.hpp>
+#include <vmmlib/frustum.hpp>
+
+#define BOOST_TEST_MODULE occlusion_buffer
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+float _random( const float min, const float max )
+{
+    return min + ( max - min ) * ( std::rand() / float( RAND_MAX ));
+}
+
+AABBf _box( const float x, const float y, const float z, const float size )
+{
+    return AABBf( Vector3f( x - size, y - size, z - size ),
+                  Vector3f( x + size, y + size, z + size ));
+}
+}
+
+BOOST_AUTO_TEST_CASE(occlusion_buffer)
+{
+    const Frustumf frustum( -1.f, 1.f, -1.f, 1.f, 1.f, 100.f );
+    const Matrix4f matrix = frustum.compute_matrix();
+    OcclusionBufferf buffer( 64, 48 );
+    buffer.setup( matrix );
+    BOOST_CHECK_EQUAL( buffer.get_num_tile_rows(), 6 );
+
+    // nothing is occluded by an empty buffer
+    BOOST_CHECK( !buffer.is_occluded( _box( 0.f, 0.f, -20.f, 2.f )));
+
+    // a wall covering the central half of the viewport
+    const float wall[] = { -5.f, -5.f, -10.f,   5.f, -5.f, -10.f,
+                           5.f, 5.f, -10.f,     -5.f, 5.f, -10.f };
+    const unsigned indices[] = { 0, 1, 2,  0, 2, 3 };
+    buffer.add_occluders( wall, indices, 2 );
+
+    BOOST_CHECK_LT( buffer.get_depth( 32, 24 ), 1.f );
+    BOOST_CHECK_EQUAL( buffer.get_depth( 2, 2 ), 1.f );
+
+    BOOST_CHECK( buffer.is_occluded( _box( 0.f, 0.f, -20.f, 2.f )));
+    BOOST_CHECK( buffer.is_occluded( _box( 6.f, -6.f, -40.f, 2.f )));
+    BOOST_CHECK( !buffer.is_occluded( _box( 0.f, 0.f, -7.f, 1.f )));
+    BOOST_CHECK( !buffer.is_occluded( _box( 10.f, 0.f, -20.f, 2.f )));
+    BOOST_CHECK( !buffer.is_occluded( _box( 14.f, 0.f, -20.f, 2.f )));
+    BOOST_CHECK( !buffer.is_occluded( _box( 0.f, 0.f, -10.f, 1.f )));
+    BOOST_CHECK( !buffer.is_occluded( _box( 0.f, 0.f, 0.f, 2.f )));
+
+    // as second stage after frustum culling
+    FrustumCullerf culler;
+    culler.setup( matrix );
+    BOOST_CHECK_EQUAL( buffer.test_aabb( culler, _box( 0.f, 0.f, -20.f, 2.f )),
+                       VISIBILITY_NONE );
+    BOOST_CHECK_EQUAL( buffer.test_aabb( culler, _box( 0.f, 0.f, -7.f, 1.f )),
+                       VISIBILITY_FULL );
+    BOOST_CHECK_EQUAL( buffer.test_aabb( culler, _box( 0.f, 0.f, 20.f, 1.f )),
+                       VISIBILITY_NONE );
+    BOOST_CHECK_EQUAL( buffer.test_aabb( culler, _box( 14.f, 0.f, -20.f, 2.f )),
+                       VISIBILITY_FULL );
+
+    // a box occluder hides everything behind it, clear() removes it
+    buffer.clear();
+    buffer.add_occluder( _box( 0.f, 0.f, -20.f, 8.f ));
+    BOOST_CHECK( buffer.is_occluded( _box( 1.f, 1.f, -40.f, 4.f )));
+    BOOST_CHECK( !buffer.is_occluded( _box( 1.f, 1.f, -5.f, 1.f )));
+    buffer.clear();
+    BOOST_CHECK( !buffer.is_occluded( _box( 1.f, 1.f, -40.f, 4.f )));
+}
+
+BOOST_AUTO_TEST_CASE(occlusion_buffer_bands)
+{
+    const Frustumf frustum( -1.f, 1.f, -1.f, 1.f, 1.f, 100.f );
+    OcclusionBufferf full( 100, 75 );
+    OcclusionBufferf banded( 100, 75 );
+    full.setup( frustum.compute_matrix( ));
+    banded.setup( frustum.compute_matrix( ));
+
+    const size_t n = 100;
+    std::vector< float > xyz( n * 9 );
+    std::vector< unsigned > indices( n * 3 );
+    for( size_t i = 0; i < n; ++i )
+    {
+        const float z = _random( -80.f, -2.f );
+        for( size_t j = 0; j < 3; ++j )
+        {
+            xyz[ 9 * i + 3 * j ] = _random( -.5f, .5f ) * -z;
+            xyz[ 9 * i + 3 * j + 1 ] = _random( -.5f, .5f ) * -z;
+            xyz[ 9 * i + 3 * j + 2 ] = z + _random( -1.f, 1.f );
+            indices[ 3 * i + j ] = unsigned( 3 * i + j );
+        }
+    }
+
+    // disjoint tile row bands write disjoint parts of the buffer
+    full.add_occluders( xyz.data(), indices.data(), n );
+    const size_t rows = banded.get_num_tile_rows();
+    banded.add_occluders( xyz.data(), indices.data(), n, rows / 2, rows );
+    banded.add_occluders( xyz.data(), indices.data(), n, 0, 1 );
+    banded.add_occluders( xyz.data(), indices.data(), n, 1, rows / 2 );
+
+    for( size_t y = 0; y < full.get_height(); ++y )
+        for( size_t x = 0; x < full.get_width(); ++x )
+            BOOST_CHECK_EQUAL( full.get_depth( x, y ),
+                               banded.get_depth( x, y ));
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        const AABBf box = _box( _random( -20.f, 20.f ), _random( -20.f, 20.f ),
+                                _random( -90.f, -5.f ), _random( .1f, 3.f ));
+        BOOST_CHECK_EQUAL( full.is_occluded( box ), banded.is_occluded( box ));
+    }
+
+    // bands rasterized concurrently by a thread pool
+    ThreadPool pool( 4 );
+    OcclusionBufferf parallel( 100, 75 );
+    parallel.setup( frustum.compute_matrix( ));
+    parallel.add_occluders( xyz.data(), indices.data(), n,
+                            ExecutionPolicy::parallel( pool, 1 ));
+    for( size_t y = 0; y < full.get_height(); ++y )
+        for( size_t x = 0; x < full.get_width(); ++x )
+            BOOST_CHECK_EQUAL( full.get_depth( x, y ),
+                               parallel.get_depth( x, y ));
+
+    OcclusionBufferf automatic( 100, 75 );
+    automatic.setup( frustum.compute_matrix( ));
+    automatic.add_occluders( xyz.data(), indices.data(), n,
+                             ExecutionPolicy::parallel( pool ));
+    for( size_t y = 0; y < full.get_height(); ++y )
+        for( size_t x = 0; x < full.get_width(); ++x )
+            BOOST_CHECK_EQUAL( full.get_depth( x, y ),
+                               automatic.get_depth( x, y ));
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/one_euro_filter.hpp>
+
+#define BOOST_TEST_MODULE one_euro_filter
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace vmml;
+
+namespace
+{
+const float dt = .01f; // 100 Hz
+
+float _noise()
+{
+    return ( std::rand() / float( RAND_MAX ) - .5f ) * .02f;
+}
+}
+
+BOOST_AUTO_TEST_CASE(one_euro_filter_scalar)
+{
+    OneEuroFilter< float > filter( 1.f, .5f );
+    BOOST_CHECK_EQUAL( filter.add( 2.f, dt ), 2.f );
+    BOOST_CHECK_EQUAL( filter.get_speed(), 0.f );
+    BOOST_CHECK_EQUAL( filter.add( 5.f, 0.f ), 2.f );
+
+    // at rest: jitter is reduced
+    filter.reset();
+    float maxError = 0.f;
+    for( size_t i = 0; i < 200; ++i )
+    {
+        filter.add( 1.f + _noise(), dt );
+        if( i > 100 )
+            maxError = std::max( maxError, std::abs( *filter - 1.f ));
+    }
+    BOOST_CHECK_LT( maxError, .005f );
+
+    // fast motion: the adaptive filter lags much less than a fixed one
+    OneEuroFilter< float > fixed( 1.f, 0.f );
+    fixed.add( 0.f, dt );
+    filter.reset();
+    filter.add( 0.f, dt );
+    for( size_t i = 1; i <= 50; ++i )
+    {
+        fixed.add( float( i ), dt );
+        filter.add( float( i ), dt );
+    }
+    BOOST_CHECK_GT( filter.get_speed(), 10.f );
+    BOOST_CHECK_LT( 50.f - filter.get(), ( 50.f - fixed.get( )) * .25f );
+}
+
+BOOST_AUTO_TEST_CASE(one_euro_filter_noise_at_rest)
+{
+    // zero-mean jitter averages out in the derivative, keeping the cutoff low
+    OneEuroFilter< float > filter( 1.f, 1.f );
+    OneEuroFilter< Vector3f > vectorFilter( 1.f, 1.f );
+    float maxCutoff = 0.f;
+    float maxVectorCutoff = 0.f;
+    for( size_t i = 0; i < 1000; ++i )
+    {
+        filter.add( 1.f + _noise() * 5.f, dt );
+        vectorFilter.add( Vector3f( _noise(), _noise(), _noise( )) * 5.f, dt );
+        if( i > 100 )
+        {
+            maxCutoff = std::max( maxCutoff, filter.get_cutoff( ));
+            maxVectorCutoff = std::max( maxVectorCutoff,
+                                        vectorFilter.get_cutoff( ));
+        }
+    }
+    BOOST_CHECK_LT( maxCutoff, 2.f );
+    BOOST_CHECK_LT( maxVectorCutoff, 2.f );
+}
+
+BOOST_AUTO_TEST_CASE(one_euro_filter_vector)
+{
+    OneEuroFilter< Vector3f > filter( 1.f, 1.f );
+    const Vector3f start( 1.f, 2.f, 3.f );
+    BOOST_CHECK_EQUAL( filter.add( start, dt ), start );
+
+    // the speed is the distance per second
+    const Vector3f step( 0.f, .03f, .04f );
+    for( size_t i = 1; i <= 500; ++i )
+        filter.add( start + step * float( i ), dt );
+    BOOST_CHECK_CLOSE( filter.get_speed(), 5.f, 1.f );
+    BOOST_CHECK_LT(( filter.get() - ( start + step * 500.f )).length(), .15f );
+}
+
+BOOST_AUTO_TEST_CASE(one_euro_filter_quaternion)
+{
+    OneEuroFilter< Quaterniond, double > filter( 1., .5 );
+
+    // rotating at one radian per second around the z axis
+    for( size_t i = 0; i <= 500; ++i )
+    {
+        const double angle = i * dt;
+        filter.add( Quaterniond( 0., 0., std::sin( angle * .5 ),
+                                 std::cos( angle * .5 )), dt );
+    }
+    BOOST_CHECK_CLOSE( filter.get_speed(), 1., 1. );
+    BOOST_CHECK_CLOSE( filter.get_derivative().z(), 1., 1. );
+    BOOST_CHECK_CLOSE( filter->abs(), 1., 1e-6 );
+
+    // q and -q are the same orientation
+    const Quaterniond last = *filter;
+    filter.add( -last, dt );
+    BOOST_CHECK_SMALL( std::abs( std::abs( filter->dot( last )) - 1. ), 1e-6 );
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/quantized_aabb.hpp>
+#include <vmmlib/frustum.hpp>
+#include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/intersection.hpp>
+
+#define BOOST_TEST_MODULE quantized_aabb
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+float _random( const float min, const float max )
+{
+    return min + ( max - min ) * ( std::rand() / float( RAND_MAX ));
+}
+
+AABBf _random( const AABBf& parent )
+{
+    Vector3f a, b;
+    for( size_t i = 0; i < 3; ++i )
+    {
+        a[ i ] = _random( parent.getMin()[ i ], parent.getMax()[ i ] );
+        b[ i ] = _random( parent.getMin()[ i ], parent.getMax()[ i ] );
+    }
+    AABBf box;
+    box.merge( a );
+    box.merge( b );
+    return box;
+}
+
+bool _contains( const AABBf& outer, const AABBf& inner )
+{
+    for( size_t i = 0; i < 3; ++i )
+        if( outer.getMin()[ i ] > inner.getMin()[ i ] ||
+            outer.getMax()[ i ] < inner.getMax()[ i ] )
+        {
+            return false;
+        }
+    return true;
+}
+
+template< typename Q > void _testEncoding( const AABBf& parent )
+{
+    const size_t n = 1000;
+    const Vector3f step = parent.getDimension() /
+                          float( QuantizedAABB< float, Q >::STEPS );
+
+    std::vector< QuantizedAABB< float, Q > > boxes( n );
+    std::vector< AABBf > originals( n );
+    for( size_t i = 0; i < n; ++i )
+    {
+        originals[ i ] = _random( parent );
+        boxes[ i ].set( originals[ i ], parent );
+
+        // conservative and at most one step larger on each side
+        const AABBf decoded = boxes[ i ].decode( parent );
+        BOOST_CHECK( _contains( decoded, originals[ i ] ));
+        BOOST_CHECK( _contains( parent, decoded ));
+        const Vector3f slack = decoded.getDimension() -
+                               originals[ i ].getDimension();
+        for( size_t j = 0; j < 3; ++j )
+            BOOST_CHECK_LE( slack[ j ], 2.01f * step[ j ] );
+    }
+
+    std::vector< AABBf > decoded( n );
+    std::vector< float > minX( n ), minY( n ), minZ( n );
+    std::vector< float > maxX( n ), maxY( n ), maxZ( n );
+    QuantizedAABB< float, Q >::decode( boxes.data(), n, parent,
+                                       decoded.data( ));
+    QuantizedAABB< float, Q >::decode( boxes.data(), n, parent, minX.data(),
+                                       minY.data(), minZ.data(), maxX.data(),
+                                       maxY.data(), maxZ.data( ));
+    for( size_t i = 0; i < n; ++i )
+    {
+        BOOST_CHECK_EQUAL( decoded[ i ], boxes[ i ].decode( parent ));
+        BOOST_CHECK_EQUAL( decoded[ i ],
+                           AABBf( Vector3f( minX[i], minY[i], minZ[i] ),
+                                  Vector3f( maxX[i], maxY[i], maxZ[i] )));
+    }
+
+    // the parent itself is reproduced exactly
+    const QuantizedAABB< float, Q > whole( parent, parent );
+    BOOST_CHECK_EQUAL( whole.decode( parent ), parent );
+}
+}
+
+BOOST_AUTO_TEST_CASE(quantized_aabb_encoding)
+{
+    BOOST_CHECK_EQUAL( sizeof( QuantizedAABBf ), 12 );
+    BOOST_CHECK_EQUAL( sizeof( QuantizedAABB< float, uint8_t > ), 6 );
+
+    const AABBf parent( Vector3f( -1000.3f, 12.f, .001f ),
+                        Vector3f( 2000.f, 12.5f, 1.f ));
+    _testEncoding< uint16_t >( parent );
+    _testEncoding< uint8_t >( parent );
+
+    // degenerate parent axes decode to the parent bounds
+    const AABBf flat( Vector3f( 0.f, 0.f, 1.f ), Vector3f( 1.f, 1.f, 1.f ));
+    const AABBf box( Vector3f( .2f, .3f, 1.f ), Vector3f( .4f, .5f, 1.f ));
+    BOOST_CHECK( _contains( QuantizedAABBf( box, flat ).decode( flat ), box ));
+}
+
+BOOST_AUTO_TEST_CASE(quantized_aabb_culling)
+{
+    const AABBf parent( Vector3f( -10.f ), Vector3f( 10.f ));
+    const AABBf box( Vector3f( -1.f, -1.f, -4.f ), Vector3f( 1.f, 1.f, -2.f ));
+    const AABBf decoded = QuantizedAABB< float, uint8_t >( box, parent ).decode(
+                              parent );
+
+    const Frustumf frustum( -1.f, 1., -1.f, 1., 1.f, 100.f );
+    FrustumCullerf culler;
+    culler.setup( frustum.compute_matrix( ));
+    BOOST_CHECK_EQUAL( culler.test_aabb( box ), VISIBILITY_FULL );
+    BOOST_CHECK_NE( culler.test_aabb( decoded ), VISIBILITY_NONE );
+
+    float t = 0.f;
+    const Intersection< float > hit( Vector3f( 0.f, 0.f, 5.f ),
+                                     Vector3f( 0.f, 0.f, -1.f ));
+    BOOST_CHECK( hit.test_aabb( box, t ));
+    BOOST_CHECK_CLOSE( t, 7.f, 1e-4f );
+    BOOST_CHECK( hit.test_aabb( decoded, t ));
+    BOOST_CHECK_LE( t, 7.f );
+
+    const Intersection< float > inside( Vector3f( 0.f, 0.f, -3.f ),
+                                        Vector3f( 1.f, 0.f, 0.f ));
+    BOOST_CHECK( inside.test_aabb( box, t ));
+    BOOST_CHECK_CLOSE( t, 1.f, 1e-4f );
+
+    const Intersection< float > miss( Vector3f( 0.f, 2.f, 5.f ),
+                                      Vector3f( 0.f, 0.f, -1.f ));
+    BOOST_CHECK( !miss.test_aabb( box, t ));
+    const Intersection< float > behind( Vector3f( 0.f, 0.f, -5.f ),
+                                        Vector3f( 0.f, 0.f, -1.f ));
+    BOOST_CHECK( !behind.test_aabb( box, t ));
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/quaternion_batch.hpp>
+
+#define BOOST_TEST_MODULE quaternion_batch
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+
+using namespace vmml;
+
+namespace
+{
+const double tolerance = 1e-12;
+
+Quaterniond _random()
+{
+    Quaterniond q( std::rand() / double( RAND_MAX ) - .5,
+                   std::rand() / double( RAND_MAX ) - .5,
+                   std::rand() / double( RAND_MAX ) - .5,
+                   std::rand() / double( RAND_MAX ) - .5 );
+    q.normalize();
+    return q;
+}
+
+bool _equals( const Quaterniond& a, const Quaterniond& b )
+{
+    return std::abs( a.x() - b.x( )) < tolerance &&
+           std::abs( a.y() - b.y( )) < tolerance &&
+           std::abs( a.z() - b.z( )) < tolerance &&
+           std::abs( a.w() - b.w( )) < tolerance;
+}
+
+// angle of the rotation from a to b
+double _angle( const Quaterniond& a, const Quaterniond& b )
+{
+    const double d = a.x() * b.x() + a.y() * b.y() + a.z() * b.z() +
+                     a.w() * b.w();
+    return 2. * std::acos( std::min( 1., std::abs( d )));
+}
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_batch_multiply)
+{
+    const size_t count = 37;
+    QuaternionBatchd left( count );
+    QuaternionBatchd right( count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        left.set( i, _random( ));
+        right.set( i, _random( ));
+    }
+
+    QuaternionBatchd result;
+    result.multiply( left, right );
+    BOOST_CHECK_EQUAL( result.size(), count );
+    for( size_t i = 0; i < count; ++i )
+        BOOST_CHECK( _equals( result.get( i ), left.get( i ) * right.get( i )));
+
+    left.multiply( left, right );
+    for( size_t i = 0; i < count; ++i )
+        BOOST_CHECK( _equals( left.get( i ), result.get( i )));
+
+    const QuaternionBatchd shorter( count - 1 );
+    BOOST_CHECK_THROW( result.multiply( left, shorter ), vmml::exception );
+    BOOST_CHECK_THROW( result.slerp( left, shorter, 0 ), vmml::exception );
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_batch_normalize)
+{
+    const Quaterniond input[] = { Quaterniond( 1, 2, 3, 4 ),
+                                  Quaterniond( 0, 0, 0, 0 ),
+                                  Quaterniond( 0, -5, 0, 0 ) };
+    QuaternionBatchd batch;
+    batch.set( input, 3 );
+    batch.normalize();
+
+    BOOST_CHECK( _equals( batch.get( 0 ), input[0].get_normalized( )));
+    BOOST_CHECK( _equals( batch.get( 1 ), input[1] ));
+    BOOST_CHECK( _equals( batch.get( 2 ), Quaterniond( 0, -1, 0, 0 )));
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_batch_rotate)
+{
+    const size_t count = 21;
+    QuaternionBatchd batch( count );
+    std::vector< double > x( count ), y( count ), z( count );
+    std::vector< Vector3d > expected( count );
+
+    const Quaterniond single = _random();
+    std::vector< double > sx( count ), sy( count ), sz( count );
+    std::vector< Vector3d > single_expected( count );
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        const Quaterniond q = _random();
+        batch.set( i, q );
+        x[i] = sx[i] = double( i );
+        y[i] = sy[i] = 1. - double( i );
+        z[i] = sz[i] = .5 * double( i );
+
+        const Vector3d v( x[i], y[i], z[i] );
+        expected[i] = q.get_rotation_matrix() * v;
+        single_expected[i] = single.get_rotation_matrix() * v;
+        BOOST_CHECK( q.rotate( v ).equals( expected[i], tolerance * 100 ));
+    }
+
+    batch.rotate( x.data(), y.data(), z.data( ));
+    rotate( single, sx.data(), sy.data(), sz.data(), count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        BOOST_CHECK( Vector3d( x[i], y[i], z[i] ).equals( expected[i],
+                                                          tolerance * 100 ));
+        BOOST_CHECK( Vector3d( sx[i], sy[i], sz[i] ).equals(
+                         single_expected[i], tolerance * 100 ));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_batch_matrices)
+{
+    const size_t count = 9;
+    QuaternionBatchd batch( count );
+    for( size_t i = 0; i < count; ++i )
+        batch.set( i, _random( ));
+
+    std::vector< Matrix< 3, 3, double > > m3( count );
+    std::vector< Matrix< 4, 4, double > > m4( count );
+    batch.get_rotation_matrices( m3.data( ));
+    batch.get_rotation_matrices( m4.data( ));
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        Matrix< 4, 4, double > expected;
+        batch.get( i ).get_rotation_matrix( expected );
+        BOOST_CHECK( m3[i].equals( batch.get( i ).get_rotation_matrix(),
+                                   tolerance ));
+        BOOST_CHECK( m4[i].equals( expected, tolerance ));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_slerp)
+{
+    const size_t count = 101;
+    QuaternionBatchd p( count );
+    QuaternionBatchd q( count );
+    std::vector< double > a( count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        p.set( i, _random( ));
+        q.set( i, _random( ));
+        a[i] = double( i ) / double( count - 1 );
+    }
+    // identical and opposite inputs
+    q.set( 0, p.get( 0 ));
+    q.set( 1, -p.get( 1 ));
+
+    QuaternionBatchd exact;
+    QuaternionBatchd fast;
+    exact.slerp( p, q, a.data( ));
+    fast.fast_slerp( p, q, a.data( ));
+    BOOST_CHECK_EQUAL( exact.size(), count );
+    BOOST_CHECK_EQUAL( fast.size(), count );
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        const Quaterniond slerp = Quaterniond::slerp( a[i], p.get( i ),
+                                                      q.get( i ));
+        const Quaterniond fastSlerp = Quaterniond::fast_slerp( a[i],
+                                                      p.get( i ), q.get( i ));
+        const Quaterniond nlerp = Quaterniond::nlerp( a[i], p.get( i ),
+                                                      q.get( i ));
+
+        BOOST_CHECK_SMALL( _angle( exact.get( i ), slerp ), 1e-6 );
+        BOOST_CHECK_SMALL( _angle( fast.get( i ), fastSlerp ), 1e-6 );
+        BOOST_CHECK_SMALL( _angle( fastSlerp, slerp ), 8e-4 );
+        BOOST_CHECK_SMALL( _angle( nlerp, slerp ), .15 );
+    }
+
+    // end points are exact
+    BOOST_CHECK_SMALL( _angle( fast.get( 0 ), p.get( 0 )), 1e-6 );
+    BOOST_CHECK_SMALL( _angle( fast.get( count - 1 ), q.get( count - 1 )),
+                       1e-6 );
+
+    // aliased input
+    QuaternionBatchd aliased = p;
+    aliased.fast_slerp( aliased, q, a.data( ));
+    for( size_t i = 0; i < count; ++i )
+        BOOST_CHECK( _equals( aliased.get( i ), fast.get( i )));
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_from_matrix)
+{
+    // one rotation for each case of Quaternion::set( Matrix ): large trace,
+    // and (almost) half turns around axes close to x, y and z
+    const Vector3d axes[] = { Vector3d( 1., 2., 3. ), Vector3d( 1., .2, .3 ),
+                              Vector3d( .2, 1., .3 ), Vector3d( .2, .3, 1. ),
+                              Vector3d( .3, .2, 1. ) };
+    const double angles[] = { .5, M_PI - 1e-3, M_PI - 1e-3, M_PI - 1e-3, M_PI };
+    const size_t count = 5;
+
+    std::vector< Matrix< 3, 3, double > > m3( count );
+    std::vector< Matrix< 4, 4, double > > m4( count );
+    std::vector< Quaterniond > expected( count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        Vector3d axis = axes[i];
+        axis.normalize();
+        const Quaterniond q( axis * std::sin( angles[i] * .5 ),
+                             std::cos( angles[i] * .5 ));
+        m3[i] = q.get_rotation_matrix();
+        q.get_rotation_matrix( m4[i] );
+
+        const Quaterniond branching( m3[i] );
+        Quaterniond branchless;
+        branchless.set_branchless( m3[i] );
+
+        BOOST_CHECK( branching.get_rotation_matrix().equals( m3[i],
+                                                             tolerance ));
+        BOOST_CHECK( branchless.get_rotation_matrix().equals( m3[i],
+                                                              tolerance ));
+        BOOST_CHECK( _equals( branchless, branching ) ||
+                     _equals( branchless, -branching ));
+        expected[i] = branchless;
+    }
+
+    QuaternionBatchd batch3;
+    QuaternionBatchd batch4;
+    batch3.set( m3.data(), count );
+    batch4.set( m4.data(), count );
+    BOOST_CHECK_EQUAL( batch3.size(), count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        BOOST_CHECK( _equals( batch3.get( i ), expected[i] ));
+        BOOST_CHECK( _equals( batch4.get( i ), expected[i] ));
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/quaternion_filter.hpp>
+
+#define BOOST_TEST_MODULE quaternion_filter
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vmml;
+
+namespace
+{
+// rotation around the z axis
+Quaterniond _rotation( const double angle )
+{
+    return Quaterniond( 0., 0., std::sin( angle * .5 ), std::cos( angle * .5 ));
+}
+
+// angle of the rotation from a to b
+double _angle( const Quaterniond& a, const Quaterniond& b )
+{
+    return 2. * std::acos( std::min( 1., std::abs( a.dot( b ))));
+}
+}
+
+BOOST_AUTO_TEST_CASE(quaternion_filter)
+{
+    QuaternionFilterd filter( .5 );
+    BOOST_CHECK_EQUAL( filter.get_smooth_factor(), .5 );
+
+    const Quaterniond start = _rotation( 0. );
+    BOOST_CHECK_EQUAL( filter.add( start ), start );
+
+    // the distance to a constant target halves with each sample
+    const Quaterniond target = _rotation( 1. );
+    for( size_t i = 1; i < 8; ++i )
+    {
+        filter.add( target );
+        BOOST_CHECK_SMALL( _angle( *filter, _rotation( 1. - std::pow( .5, i ))),
+                           1e-3 );
+        BOOST_CHECK_CLOSE( filter->abs(), 1., 1e-6 );
+    }
+
+    // q and -q are the same orientation
+    filter.reset();
+    filter.add( target );
+    filter.add( -target );
+    BOOST_CHECK_SMALL( _angle( filter.get(), target ), 1e-6 );
+
+    // blending across the hemispheres uses the shorter arc
+    filter.reset();
+    filter.add( _rotation( 3. ));
+    filter.add( _rotation( -3. ));
+    BOOST_CHECK_SMALL( _angle( filter.get(), _rotation( M_PI )), 1e-3 );
+
+    filter.set_smooth_factor( 0. );
+    BOOST_CHECK_SMALL( _angle( filter.add( target ), target ), 1e-6 );
+}
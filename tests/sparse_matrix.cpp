@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vmmlib/sparse_matrix.hpp>
+
+#define BOOST_TEST_MODULE sparse_matrix
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace vmml;
+
+namespace
+{
+template< size_t M, size_t N >
+Matrix< M, N, double > _sparseMatrix()
+{
+    // about a third of the elements are non-zero
+    std::srand( 42 );
+    Matrix< M, N, double > matrix;
+    for( size_t i = 0; i < M * N; ++i )
+        matrix.array[ i ] = std::rand() % 3 == 0 ?
+                                double( std::rand() % 100 ) / 10.0 - 5.0 : 0.0;
+    return matrix;
+}
+}
+
+BOOST_AUTO_TEST_CASE( construct_from_matrix )
+{
+    Matrix< 3, 4, float > dense;
+    dense( 0, 0 ) = 1.f; dense( 0, 1 ) = 0.f;  dense( 0, 2 ) = 0.05f;
+    dense( 0, 3 ) = 0.f; dense( 1, 0 ) = 0.f;  dense( 1, 1 ) = 0.f;
+    dense( 1, 2 ) = 0.f; dense( 1, 3 ) = 0.f;  dense( 2, 0 ) = -2.f;
+    dense( 2, 1 ) = 3.f; dense( 2, 2 ) = 0.f;  dense( 2, 3 ) = -0.05f;
+
+    const SparseMatrixf all( dense );
+    BOOST_CHECK_EQUAL( all.get_rows(), 3 );
+    BOOST_CHECK_EQUAL( all.get_columns(), 4 );
+    BOOST_CHECK_EQUAL( all.nnz(), dense.nnz( ));
+
+    const SparseMatrixf sparse( dense, 0.1f );
+    BOOST_CHECK_EQUAL( sparse.nnz(), dense.nnz( 0.1f ));
+    BOOST_CHECK_EQUAL( sparse.nnz(), 3 );
+    BOOST_CHECK_EQUAL( sparse.get( 0, 0 ), 1.f );
+    BOOST_CHECK_EQUAL( sparse.get( 0, 2 ), 0.f );
+    BOOST_CHECK_EQUAL( sparse.get( 1, 1 ), 0.f );
+    BOOST_CHECK_EQUAL( sparse.get( 2, 0 ), -2.f );
+    BOOST_CHECK_EQUAL( sparse.get( 2, 1 ), 3.f );
+
+    const size_t offsets[] = { 0, 1, 1, 3 };
+    const size_t indices[] = { 0, 0, 1 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( sparse.get_row_offsets().begin(),
+                                   sparse.get_row_offsets().end(),
+                                   offsets, offsets + 4 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( sparse.get_column_indices().begin(),
+                                   sparse.get_column_indices().end(),
+                                   indices, indices + 3 );
+
+    Matrix< 3, 4, float > thresholded( dense );
+    thresholded.threshold( 0.1f );
+    Matrix< 3, 4, float > result;
+    sparse.get_dense( result );
+    BOOST_CHECK_EQUAL( result, thresholded );
+}
+
+BOOST_AUTO_TEST_CASE( construct_from_triplets )
+{
+    std::vector< SparseMatrixd::Triplet > triplets;
+    triplets.push_back( SparseMatrixd::Triplet( 2, 3, 1.0 ));
+    triplets.push_back( SparseMatrixd::Triplet( 0, 1, 2.0 ));
+    triplets.push_back( SparseMatrixd::Triplet( 2, 0, 3.0 ));
+    triplets.push_back( SparseMatrixd::Triplet( 0, 1, 4.0 ));
+    triplets.push_back( SparseMatrixd::Triplet( 2, 3, -1.0 ));
+
+    const SparseMatrixd sparse( 3, 4, triplets );
+    BOOST_CHECK_EQUAL( sparse.nnz(), 3 );
+    BOOST_CHECK_EQUAL( sparse.get( 0, 1 ), 6.0 );
+    BOOST_CHECK_EQUAL( sparse.get( 2, 0 ), 3.0 );
+    BOOST_CHECK_EQUAL( sparse.get( 2, 3 ), 0.0 ); // summed, but stored
+    BOOST_CHECK_EQUAL( sparse.get( 1, 2 ), 0.0 );
+
+    const size_t indices[] = { 1, 0, 3 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( sparse.get_column_indices().begin(),
+                                   sparse.get_column_indices().end(),
+                                   indices, indices + 3 );
+
+    // out of bounds
+    triplets.push_back( SparseMatrixd::Triplet( 3, 0, 1.0 ));
+    BOOST_CHECK_THROW( SparseMatrixd( 3, 4, triplets ), vmml::exception );
+    triplets.back() = SparseMatrixd::Triplet( 0, 4, 1.0 );
+    BOOST_CHECK_THROW( SparseMatrixd( 3, 4, triplets ), vmml::exception );
+
+    const SparseMatrixd empty( 5, 2 );
+    BOOST_CHECK_EQUAL( empty.nnz(), 0 );
+    BOOST_CHECK_EQUAL( empty.get( 4, 1 ), 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( get_transposed )
+{
+    const Matrix< 7, 5, double > dense = _sparseMatrix< 7, 5 >();
+    const SparseMatrixd sparse( dense );
+    const SparseMatrixd transposed = sparse.get_transposed();
+
+    BOOST_CHECK_EQUAL( transposed.get_rows(), 5 );
+    BOOST_CHECK_EQUAL( transposed.get_columns(), 7 );
+    BOOST_CHECK_EQUAL( transposed.nnz(), sparse.nnz( ));
+
+    Matrix< 5, 7, double > result;
+    transposed.get_dense( result );
+    BOOST_CHECK_EQUAL( result, transpose( dense ));
+}
+
+BOOST_AUTO_TEST_CASE( multiply_vector )
+{
+    const Matrix< 7, 5, double > dense = _sparseMatrix< 7, 5 >();
+    const SparseMatrixd sparse( dense );
+    Vector< 5, double > x;
+    for( size_t i = 0; i < 5; ++i )
+        x[ i ] = double( i ) * 1.5 - 2.0;
+
+    Vector< 7, double > result;
+    sparse.multiply( x, result );
+    const Vector< 7, double > expected = dense * x;
+    for( size_t i = 0; i < 7; ++i )
+        BOOST_CHECK_CLOSE( result[ i ] + 1.0, expected[ i ] + 1.0, 1e-10 );
+
+    Vector< 7, double > y;
+    for( size_t i = 0; i < 7; ++i )
+        y[ i ] = double( i + 1 );
+    Vector< 5, double > transposedResult;
+    sparse.multiply_transposed( y, transposedResult );
+    const Vector< 5, double > transposedExpected = transpose( dense ) * y;
+    for( size_t i = 0; i < 5; ++i )
+        BOOST_CHECK_CLOSE( transposedResult[ i ] + 1.0,
+                           transposedExpected[ i ] + 1.0, 1e-10 );
+
+    Vector< 5, double > viaTransposed;
+    sparse.get_transposed().multiply( y, viaTransposed );
+    for( size_t i = 0; i < 5; ++i )
+        BOOST_CHECK_CLOSE( viaTransposed[ i ] + 1.0,
+                           transposedExpected[ i ] + 1.0, 1e-10 );
+}
+
+BOOST_AUTO_TEST_CASE( multiply_matrix )
+{
+    const Matrix< 7, 5, double > dense = _sparseMatrix< 7, 5 >();
+    const SparseMatrixd sparse( dense );
+
+    Matrix< 5, 3, double > right;
+    for( size_t i = 0; i < 15; ++i )
+        right.array[ i ] = double( i ) - 7.0;
+
+    Matrix< 7, 3, double > result;
+    sparse.multiply( right, result );
+    const Matrix< 7, 3, double > expected = dense * right;
+    for( size_t i = 0; i < 21; ++i )
+        BOOST_CHECK_CLOSE( result.array[ i ] + 1.0,
+                           expected.array[ i ] + 1.0, 1e-10 );
+}
+
+BOOST_AUTO_TEST_CASE( multiply_parallel )
+{
+    const size_t size = 2000;
+    std::srand( 7 );
+    std::vector< SparseMatrixf::Triplet > triplets;
+    for( size_t i = 0; i < size * 16; ++i )
+        triplets.push_back( SparseMatrixf::Triplet(
+            std::rand() % size, std::rand() % size,
+            float( std::rand() % 100 ) / 100.f ));
+    const SparseMatrixf sparse( size, size, triplets );
+
+    std::vector< float > x( size );
+    for( size_t i = 0; i < size; ++i )
+        x[ i ] = float( i % 10 ) - 4.5f;
+
+    std::vector< float > sequential( size );
+    sparse.multiply( x.data(), sequential.data( ));
+
+    // rows are independent, so any partition gives the same result
+    ThreadPool pool( 4 );
+    std::vector< float > parallel( size );
+    sparse.multiply( x.data(), parallel.data(),
+                     ExecutionPolicy::parallel( pool, 16 ));
+    BOOST_CHECK( parallel == sequential );
+
+    std::vector< float > transposed( size );
+    std::vector< float > viaTransposed( size );
+    sparse.multiply_transposed( x.data(), transposed.data( ));
+    sparse.get_transposed().multiply( x.data(), viaTransposed.data(),
+                                      ExecutionPolicy::parallel( pool ));
+    for( size_t i = 0; i < size; ++i )
+        BOOST_CHECK_CLOSE( transposed[ i ] + 100.f,
+                           viaTransposed[ i ] + 100.f, 1e-3f );
+}
@@ -32,7 +32,10 @@
 #ifndef VMMLIB__AXIS_ALIGNED_BOUNDING_BOX__HPP
 #define VMMLIB__AXIS_ALIGNED_BOUNDING_BOX__HPP
 
+#include <vmmlib/execution.hpp>
+#include <vmmlib/instrument.hpp>
 #include <vmmlib/vector.hpp>
+#include <cstdint>
 #include <limits>
 
 namespace vmml
@@ -59,6 +62,29 @@ public:
     bool isIn2d( const Vector< 3, T >& pos ); // only x and y components are checked
     bool isIn( const Vector< 4, T >& sphere );
 
+    /**
+     * Test n points given as xyz coordinates, stride elements apart.
+     *
+     * Sets mask[i] to 1 if the point is inside or on the box, to 0 otherwise.
+     * The test is branch-free and vectorizes for densely packed points.
+     */
+    void containsPoints( const T* xyz, size_t n, uint8_t* mask,
+                         size_t stride = 3 ) const;
+
+    /** @return true if the two boxes overlap or touch. */
+    bool intersects( const AABB< T >& aabb ) const;
+
+    /**
+     * Test n boxes given as separate arrays of their min and max coordinates.
+     *
+     * Writes the indices of all boxes overlapping or touching this box to
+     * indices, which needs room for n entries.
+     * @return the number of overlapping boxes.
+     */
+    size_t intersects( const T* minX, const T* minY, const T* minZ,
+                       const T* maxX, const T* maxY, const T* maxZ, size_t n,
+                       size_t* indices ) const;
+
     void set( const Vector< 3, T >& pMin, const Vector< 3, T >& pMax );
     void set( T cx, T cy, T cz, T size );
     void setMin( const Vector< 3, T >& pMin );
@@ -72,6 +98,21 @@ public:
     void merge( const AABB< T >& aabb );
     void merge( const Vector< 3, T >& point );
 
+    /** Merge count bounding boxes into this one. */
+    void merge( const AABB< T >* boxes, size_t count );
+
+    /**
+     * Merge n points given as xyz coordinates, stride elements apart.
+     *
+     * Densely packed points (stride 3) are reduced with independent
+     * accumulators per block, which the compiler vectorizes.
+     */
+    void mergePoints( const T* xyz, size_t n, size_t stride = 3 );
+
+    /** Merge n points like mergePoints(), in chunks run by the policy. */
+    void mergePoints( const T* xyz, size_t n, size_t stride,
+                      const ExecutionPolicy& policy );
+
     void setEmpty();
     bool isEmpty() const;
 
@@ -95,6 +136,9 @@ public:
 
     static AABB< T > makeUnitBox();
 
+    /** @return the bounding box of n points, see mergePoints(). */
+    static AABB< T > fromPoints( const T* xyz, size_t n, size_t stride = 3 );
+
 protected:
     Vector< 3, T > _min;
     Vector< 3, T > _max;
@@ -185,6 +229,53 @@ inline bool AABB< T >::isIn2d( const Vector< 3, T >& pos )
     return true;
 }
 
+template< typename T >
+void AABB< T >::containsPoints( const T* xyz, const size_t n, uint8_t* mask,
+                                const size_t stride ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "AABB::containsPoints" );
+    const T minX = _min.x(), minY = _min.y(), minZ = _min.z();
+    const T maxX = _max.x(), maxY = _max.y(), maxZ = _max.z();
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        const T* point = xyz + i * stride;
+        mask[ i ] = ( point[0] >= minX ) & ( point[0] <= maxX ) &
+                    ( point[1] >= minY ) & ( point[1] <= maxY ) &
+                    ( point[2] >= minZ ) & ( point[2] <= maxZ );
+    }
+}
+
+template< typename T >
+inline bool AABB< T >::intersects( const AABB< T >& aabb ) const
+{
+    return ( _min.x() <= aabb._max.x( )) & ( aabb._min.x() <= _max.x( )) &
+           ( _min.y() <= aabb._max.y( )) & ( aabb._min.y() <= _max.y( )) &
+           ( _min.z() <= aabb._max.z( )) & ( aabb._min.z() <= _max.z( ));
+}
+
+template< typename T >
+size_t AABB< T >::intersects( const T* minX, const T* minY, const T* minZ,
+                              const T* maxX, const T* maxY, const T* maxZ,
+                              const size_t n, size_t* indices ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "AABB::intersects" );
+    const T x0 = _min.x(), y0 = _min.y(), z0 = _min.z();
+    const T x1 = _max.x(), y1 = _max.y(), z1 = _max.z();
+
+    // always write the index, but only advance past hits
+    size_t nHits = 0;
+    for( size_t i = 0; i < n; ++i )
+    {
+        const bool hit = ( x0 <= maxX[i] ) & ( minX[i] <= x1 ) &
+                         ( y0 <= maxY[i] ) & ( minY[i] <= y1 ) &
+                         ( z0 <= maxZ[i] ) & ( minZ[i] <= z1 );
+        indices[ nHits ] = i;
+        nHits += hit;
+    }
+    return nHits;
+}
+
 template< typename T >
 inline void AABB< T >::set( const Vector< 3, T >& pMin,
                             const Vector< 3, T >& pMax )
@@ -360,6 +451,86 @@ void AABB< T >::merge( const Vector< 3, T >& point )
         _max.z() = point.z();
 }
 
+template< typename T >
+void AABB< T >::merge( const AABB< T >* boxes, const size_t count )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "AABB::merge" );
+    for( size_t i = 0; i < count; ++i )
+    {
+        const Vector< 3, T >& min = boxes[ i ].getMin();
+        const Vector< 3, T >& max = boxes[ i ].getMax();
+        for( size_t j = 0; j < 3; ++j )
+        {
+            _min[ j ] = min[ j ] < _min[ j ] ? min[ j ] : _min[ j ];
+            _max[ j ] = max[ j ] > _max[ j ] ? max[ j ] : _max[ j ];
+        }
+    }
+}
+
+template< typename T >
+void AABB< T >::mergePoints( const T* xyz, const size_t n,
+                             const size_t stride )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "AABB::mergePoints" );
+    size_t i = 0;
+    if( stride == 3 )
+    {
+        // Reduce blocks of points into as many accumulators, the interleaved
+        // coordinates stay in place since the block size is a multiple of 3
+        const size_t nPoints = 16;
+        const size_t size = 3 * nPoints;
+        T lo[ size ];
+        T hi[ size ];
+        for( size_t j = 0; j < size; ++j )
+        {
+            lo[ j ] = _min[ j % 3 ];
+            hi[ j ] = _max[ j % 3 ];
+        }
+
+        for( ; i + nPoints <= n; i += nPoints )
+        {
+            const T* block = xyz + 3 * i;
+            for( size_t j = 0; j < size; ++j )
+            {
+                lo[ j ] = block[ j ] < lo[ j ] ? block[ j ] : lo[ j ];
+                hi[ j ] = block[ j ] > hi[ j ] ? block[ j ] : hi[ j ];
+            }
+        }
+
+        for( size_t j = 0; j < size; ++j )
+        {
+            _min[ j % 3 ] = lo[ j ] < _min[ j % 3 ] ? lo[ j ] : _min[ j % 3 ];
+            _max[ j % 3 ] = hi[ j ] > _max[ j % 3 ] ? hi[ j ] : _max[ j % 3 ];
+        }
+    }
+
+    for( ; i < n; ++i )
+    {
+        const T* point = xyz + i * stride;
+        for( size_t j = 0; j < 3; ++j )
+        {
+            _min[ j ] = point[ j ] < _min[ j ] ? point[ j ] : _min[ j ];
+            _max[ j ] = point[ j ] > _max[ j ] ? point[ j ] : _max[ j ];
+        }
+    }
+}
+
+template< typename T >
+void AABB< T >::mergePoints( const T* xyz, const size_t n, const size_t stride,
+                             const ExecutionPolicy& policy )
+{
+    merge( parallel_reduce( policy, n, AABB< T >(),
+        [&]( const size_t begin, const size_t end )
+        {
+            return fromPoints( xyz + begin * stride, end - begin, stride );
+        },
+        []( AABB< T > result, const AABB< T >& aabb )
+        {
+            result.merge( aabb );
+            return result;
+        }, 2 ));
+}
+
 template< typename T >inline
 void AABB< T >::setEmpty()
 {
@@ -380,6 +551,15 @@ AABB< T > AABB< T >::makeUnitBox()
     return AABB( Vector< 3, T >::ZERO, Vector< 3, T >::ONE );
 }
 
+template< typename T >
+AABB< T > AABB< T >::fromPoints( const T* xyz, const size_t n,
+                                 const size_t stride )
+{
+    AABB< T > aabb;
+    aabb.mergePoints( xyz, n, stride );
+    return aabb;
+}
+
 } //namespace vmml
 
 #endif
@@ -0,0 +1,473 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__AFFINE_TRANSFORM__HPP
+#define VMMLIB__AFFINE_TRANSFORM__HPP
+
+#include <vmmlib/vmmlib_config.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/quaternion.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// - declaration - //
+
+namespace vmml
+{
+
+/**
+ * A compact affine transformation.
+ *
+ * Only the upper 3x4 part of the equivalent homogeneous 4x4 matrix is stored,
+ * the last row is implicitly [ 0 0 0 1 ]. This saves a quarter of the memory
+ * and of the arithmetic of a Matrix< 4, 4, T > for composition and point
+ * transformation. The storage is column by column like in Matrix, with the
+ * translation in the last column.
+ */
+template< typename T > class AffineTransform
+{
+public:
+    typedef Vector< 3, T > vec3;
+
+    /** Create an identity transformation. */
+    AffineTransform();
+
+    /** Create from the upper 3x4 part of the given matrix. */
+    explicit AffineTransform( const Matrix< 4, 4, T >& matrix_ );
+
+    AffineTransform( const Matrix< 3, 3, T >& linear_,
+                     const vec3& translation_ );
+
+    /** Create a rotation, followed by a translation, of a scaled object. */
+    AffineTransform( const Quaternion< T >& rotation_,
+                     const vec3& translation_,
+                     const vec3& scale_ = vec3::ONE );
+
+    inline T& operator()( size_t row_index, size_t col_index );
+    inline const T& operator()( size_t row_index, size_t col_index ) const;
+
+    bool operator==( const AffineTransform& other ) const;
+    bool operator!=( const AffineTransform& other ) const;
+    bool equals( const AffineTransform& other,
+                 T tolerance = std::numeric_limits< T >::epsilon( )) const;
+
+    void identity();
+
+    void set( const Matrix< 4, 4, T >& matrix_ );
+    void set( const Matrix< 3, 3, T >& linear_, const vec3& translation_ );
+    void set( const Quaternion< T >& rotation_, const vec3& translation_,
+              const vec3& scale_ = vec3::ONE );
+
+    // (this) = left * right, i.e. right is applied first. The result may not
+    // alias left or right.
+    void multiply( const AffineTransform& left, const AffineTransform& right );
+
+    AffineTransform operator*( const AffineTransform& other ) const;
+    void operator*=( const AffineTransform& other );
+
+    // the return value indicates if the transformation is invertible.
+    bool inverse( AffineTransform& inverse_,
+                  T tolerance = std::numeric_limits< T >::epsilon( )) const;
+
+    // inverse of a transformation without scale and shear, i.e. with an
+    // orthonormal linear part. Much cheaper than the general inverse().
+    AffineTransform get_rigid_inverse() const;
+
+    // transform a position, i.e. with an implicit w = 1
+    inline vec3 transform_point( const vec3& point ) const;
+    // transform a direction, i.e. with an implicit w = 0
+    inline vec3 transform_vector( const vec3& vector_ ) const;
+
+    // transform count xyz triples from in to out; in and out may be equal.
+    void transform_points( const T* in, T* out, size_t count ) const;
+    void transform_vectors( const T* in, T* out, size_t count ) const;
+
+    vec3 get_translation() const;
+    void set_translation( const vec3& translation_ );
+
+    Matrix< 3, 3, T > get_linear() const;
+    void get_linear( Matrix< 3, 3, T >& linear_ ) const;
+
+    Matrix< 4, 4, T > get_matrix() const;
+    void get_matrix( Matrix< 4, 4, T >& matrix_ ) const;
+
+    // scale and rotation of the linear part, assuming it has no shear
+    vec3 get_scale() const;
+    Quaternion< T > get_rotation() const;
+
+    friend std::ostream& operator << ( std::ostream& os,
+                                       const AffineTransform& transform )
+    {
+        return os << transform.get_matrix();
+    }
+
+    T array[ 12 ]; //!< column by column storage of the upper 3x4 part
+
+    static const AffineTransform IDENTITY;
+
+}; // class AffineTransform
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef AffineTransform< float >  AffineTransformf;
+typedef AffineTransform< double > AffineTransformd;
+#endif
+
+/**
+ * Compose count transformations pairwise, result[i] = left[i] * right[i], e.g.
+ * to propagate parent transformations to their children in a scene graph.
+ */
+template< typename T >
+void multiply( const AffineTransform< T >* left,
+               const AffineTransform< T >* right,
+               AffineTransform< T >* result, size_t count );
+
+// - implementation - //
+
+template< typename T >
+const AffineTransform< T > AffineTransform< T >::IDENTITY;
+
+template< typename T >
+AffineTransform< T >::AffineTransform()
+{
+    identity();
+}
+
+template< typename T >
+AffineTransform< T >::AffineTransform( const Matrix< 4, 4, T >& matrix_ )
+{
+    set( matrix_ );
+}
+
+template< typename T >
+AffineTransform< T >::AffineTransform( const Matrix< 3, 3, T >& linear_,
+                                       const vec3& translation_ )
+{
+    set( linear_, translation_ );
+}
+
+template< typename T >
+AffineTransform< T >::AffineTransform( const Quaternion< T >& rotation_,
+                                       const vec3& translation_,
+                                       const vec3& scale_ )
+{
+    set( rotation_, translation_, scale_ );
+}
+
+template< typename T >
+inline T& AffineTransform< T >::operator()( size_t row_index,
+                                            size_t col_index )
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if( row_index >= 3 || col_index >= 4 )
+        VMMLIB_ERROR( "index out of bounds", VMMLIB_HERE );
+#endif
+    return array[ col_index * 3 + row_index ];
+}
+
+template< typename T >
+inline const T& AffineTransform< T >::operator()( size_t row_index,
+                                                  size_t col_index ) const
+{
+#ifdef VMMLIB_SAFE_ACCESSORS
+    if( row_index >= 3 || col_index >= 4 )
+        VMMLIB_ERROR( "index out of bounds", VMMLIB_HERE );
+#endif
+    return array[ col_index * 3 + row_index ];
+}
+
+template< typename T >
+bool AffineTransform< T >::operator==( const AffineTransform& other ) const
+{
+    for( size_t i = 0; i < 12; ++i )
+        if( array[ i ] != other.array[ i ] )
+            return false;
+    return true;
+}
+
+template< typename T >
+bool AffineTransform< T >::operator!=( const AffineTransform& other ) const
+{
+    return !( *this == other );
+}
+
+template< typename T >
+bool AffineTransform< T >::equals( const AffineTransform& other,
+                                   T tolerance ) const
+{
+    for( size_t i = 0; i < 12; ++i )
+        if( std::abs( array[ i ] - other.array[ i ] ) > tolerance )
+            return false;
+    return true;
+}
+
+template< typename T >
+void AffineTransform< T >::identity()
+{
+    for( size_t i = 0; i < 12; ++i )
+        array[ i ] = 0;
+    array[ 0 ] = array[ 4 ] = array[ 8 ] = 1;
+}
+
+template< typename T >
+void AffineTransform< T >::set( const Matrix< 4, 4, T >& matrix_ )
+{
+    for( size_t col = 0; col < 4; ++col )
+        for( size_t row = 0; row < 3; ++row )
+            array[ col * 3 + row ] = matrix_( row, col );
+}
+
+template< typename T >
+void AffineTransform< T >::set( const Matrix< 3, 3, T >& linear_,
+                                const vec3& translation_ )
+{
+    // both are stored column by column
+    memcpy( array, linear_.array, 9 * sizeof( T ));
+    set_translation( translation_ );
+}
+
+template< typename T >
+void AffineTransform< T >::set( const Quaternion< T >& rotation_,
+                                const vec3& translation_,
+                                const vec3& scale_ )
+{
+    Matrix< 3, 3, T > rotation_matrix;
+    rotation_.get_rotation_matrix( rotation_matrix );
+
+    for( size_t col = 0; col < 3; ++col )
+        for( size_t row = 0; row < 3; ++row )
+            array[ col * 3 + row ] = rotation_matrix( row, col ) * scale_[ col ];
+    set_translation( translation_ );
+}
+
+template< typename T >
+void AffineTransform< T >::multiply( const AffineTransform& left,
+                                     const AffineTransform& right )
+{
+    const T* l = left.array;
+    const T* r = right.array;
+
+    // linear part: L * R, translation: L * t_r + t_l
+    for( size_t col = 0; col < 4; ++col )
+    {
+        const T r0 = r[ col * 3 ];
+        const T r1 = r[ col * 3 + 1 ];
+        const T r2 = r[ col * 3 + 2 ];
+        const T w = col == 3 ? 1 : 0;
+
+        array[ col * 3 ]     = l[0] * r0 + l[3] * r1 + l[6] * r2 + l[ 9] * w;
+        array[ col * 3 + 1 ] = l[1] * r0 + l[4] * r1 + l[7] * r2 + l[10] * w;
+        array[ col * 3 + 2 ] = l[2] * r0 + l[5] * r1 + l[8] * r2 + l[11] * w;
+    }
+}
+
+template< typename T >
+AffineTransform< T >
+AffineTransform< T >::operator*( const AffineTransform& other ) const
+{
+    AffineTransform result;
+    result.multiply( *this, other );
+    return result;
+}
+
+template< typename T >
+void AffineTransform< T >::operator*=( const AffineTransform& other )
+{
+    AffineTransform result;
+    result.multiply( *this, other );
+    *this = result;
+}
+
+template< typename T >
+bool AffineTransform< T >::inverse( AffineTransform& inverse_,
+                                    T tolerance ) const
+{
+    Matrix< 3, 3, T > linear_inverse;
+    if( !compute_inverse( get_linear(), linear_inverse, tolerance ))
+        return false;
+
+    inverse_.set( linear_inverse, -( linear_inverse * get_translation( )));
+    return true;
+}
+
+template< typename T >
+AffineTransform< T > AffineTransform< T >::get_rigid_inverse() const
+{
+    AffineTransform result;
+    T* r = result.array;
+
+    // transposed linear part
+    r[0] = array[0]; r[3] = array[1]; r[6] = array[2];
+    r[1] = array[3]; r[4] = array[4]; r[7] = array[5];
+    r[2] = array[6]; r[5] = array[7]; r[8] = array[8];
+
+    // -R^T * t
+    r[ 9] = -( r[0] * array[9] + r[3] * array[10] + r[6] * array[11] );
+    r[10] = -( r[1] * array[9] + r[4] * array[10] + r[7] * array[11] );
+    r[11] = -( r[2] * array[9] + r[5] * array[10] + r[8] * array[11] );
+    return result;
+}
+
+template< typename T >
+inline Vector< 3, T >
+AffineTransform< T >::transform_point( const vec3& p ) const
+{
+    return vec3( array[0] * p.x() + array[3] * p.y() + array[6] * p.z() + array[ 9],
+                 array[1] * p.x() + array[4] * p.y() + array[7] * p.z() + array[10],
+                 array[2] * p.x() + array[5] * p.y() + array[8] * p.z() + array[11] );
+}
+
+template< typename T >
+inline Vector< 3, T >
+AffineTransform< T >::transform_vector( const vec3& v ) const
+{
+    return vec3( array[0] * v.x() + array[3] * v.y() + array[6] * v.z(),
+                 array[1] * v.x() + array[4] * v.y() + array[7] * v.z(),
+                 array[2] * v.x() + array[5] * v.y() + array[8] * v.z() );
+}
+
+template< typename T >
+void AffineTransform< T >::transform_points( const T* in, T* out,
+                                             size_t count ) const
+{
+    // copy to locals, so the compiler knows they do not alias out
+    const T m0 = array[0], m1 = array[1], m2  = array[2],  m3  = array[3];
+    const T m4 = array[4], m5 = array[5], m6  = array[6],  m7  = array[7];
+    const T m8 = array[8], m9 = array[9], m10 = array[10], m11 = array[11];
+
+    for( size_t i = 0; i < count; ++i, in += 3, out += 3 )
+    {
+        const T x = in[0], y = in[1], z = in[2];
+        out[0] = m0 * x + m3 * y + m6 * z + m9;
+        out[1] = m1 * x + m4 * y + m7 * z + m10;
+        out[2] = m2 * x + m5 * y + m8 * z + m11;
+    }
+}
+
+template< typename T >
+void AffineTransform< T >::transform_vectors( const T* in, T* out,
+                                              size_t count ) const
+{
+    const T m0 = array[0], m1 = array[1], m2 = array[2], m3 = array[3];
+    const T m4 = array[4], m5 = array[5], m6 = array[6], m7 = array[7];
+    const T m8 = array[8];
+
+    for( size_t i = 0; i < count; ++i, in += 3, out += 3 )
+    {
+        const T x = in[0], y = in[1], z = in[2];
+        out[0] = m0 * x + m3 * y + m6 * z;
+        out[1] = m1 * x + m4 * y + m7 * z;
+        out[2] = m2 * x + m5 * y + m8 * z;
+    }
+}
+
+template< typename T >
+Vector< 3, T > AffineTransform< T >::get_translation() const
+{
+    return vec3( array[ 9 ], array[ 10 ], array[ 11 ] );
+}
+
+template< typename T >
+void AffineTransform< T >::set_translation( const vec3& translation_ )
+{
+    array[  9 ] = translation_.x();
+    array[ 10 ] = translation_.y();
+    array[ 11 ] = translation_.z();
+}
+
+template< typename T >
+Matrix< 3, 3, T > AffineTransform< T >::get_linear() const
+{
+    Matrix< 3, 3, T > linear_;
+    get_linear( linear_ );
+    return linear_;
+}
+
+template< typename T >
+void AffineTransform< T >::get_linear( Matrix< 3, 3, T >& linear_ ) const
+{
+    memcpy( linear_.array, array, 9 * sizeof( T ));
+}
+
+template< typename T >
+Matrix< 4, 4, T > AffineTransform< T >::get_matrix() const
+{
+    Matrix< 4, 4, T > matrix_;
+    get_matrix( matrix_ );
+    return matrix_;
+}
+
+template< typename T >
+void AffineTransform< T >::get_matrix( Matrix< 4, 4, T >& matrix_ ) const
+{
+    for( size_t col = 0; col < 4; ++col )
+    {
+        for( size_t row = 0; row < 3; ++row )
+            matrix_( row, col ) = array[ col * 3 + row ];
+        matrix_( 3, col ) = col == 3 ? 1 : 0;
+    }
+}
+
+template< typename T >
+Vector< 3, T > AffineTransform< T >::get_scale() const
+{
+    return vec3(
+        std::sqrt( array[0] * array[0] + array[1] * array[1] + array[2] * array[2] ),
+        std::sqrt( array[3] * array[3] + array[4] * array[4] + array[5] * array[5] ),
+        std::sqrt( array[6] * array[6] + array[7] * array[7] + array[8] * array[8] ));
+}
+
+template< typename T >
+Quaternion< T > AffineTransform< T >::get_rotation() const
+{
+    const vec3 scale_ = get_scale();
+    Matrix< 3, 3, T > rotation_matrix;
+    for( size_t col = 0; col < 3; ++col )
+        for( size_t row = 0; row < 3; ++row )
+            rotation_matrix( row, col ) = array[ col * 3 + row ] / scale_[ col ];
+    return Quaternion< T >( rotation_matrix );
+}
+
+template< typename T >
+void multiply( const AffineTransform< T >* left,
+               const AffineTransform< T >* right,
+               AffineTransform< T >* result, size_t count )
+{
+    for( size_t i = 0; i < count; ++i )
+        result[ i ].multiply( left[ i ], right[ i ] );
+}
+
+} // namespace vmml
+
+#endif
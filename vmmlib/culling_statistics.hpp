@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__CULLING_STATISTICS__HPP
+#define VMMLIB__CULLING_STATISTICS__HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// - declaration -
+
+namespace vmml
+{
+
+/**
+ * Operation counters and timings of the batch culling functions.
+ *
+ * Cullers given a CullingStatistics with set_statistics() count the objects
+ * and plane tests of each batch call locally, and add them once per call to an
+ * accumulator owned by the calling thread. Concurrent culling passes therefore
+ * do not contend, and get() merges the accumulators of all threads on demand.
+ * The single-object test functions are not counted.
+ */
+class CullingStatistics
+{
+public:
+    struct Counters
+    {
+        Counters();
+
+        Counters& operator += ( const Counters& rhs );
+
+        uint64_t passes;      //!< number of batch calls
+        uint64_t tested;      //!< number of tested objects
+        uint64_t results[ 3 ];//!< number of results indexed by Visibility
+        uint64_t plane_tests; //!< number of evaluated frustum planes
+        uint64_t nanoseconds; //!< cumulative time of the batch calls
+
+        friend std::ostream& operator << ( std::ostream& os,
+                                           const Counters& counters )
+        {
+            return os << counters.tested << " tested in " << counters.passes
+                      << " passes, " << counters.results[ 2 ] << " full, "
+                      << counters.results[ 1 ] << " partial, "
+                      << counters.results[ 0 ] << " none, "
+                      << counters.plane_tests << " plane tests, "
+                      << counters.nanoseconds * 1e-6 << " ms";
+        }
+    };
+
+    /**
+     * Counts one batch call of the calling thread, adding its counters and
+     * duration to the statistics when destroyed.
+     */
+    class Pass
+    {
+    public:
+        explicit Pass( CullingStatistics& statistics );
+        ~Pass();
+
+        /** Count one tested object. */
+        void add( size_t visibility, size_t plane_tests )
+        {
+            ++_counters.results[ visibility ];
+            _counters.plane_tests += plane_tests;
+        }
+
+        /** Count n tested objects with the same number of plane tests each. */
+        void add( size_t visibility, size_t plane_tests, size_t n );
+
+    private:
+        Pass( const Pass& ) = delete;
+        Pass& operator = ( const Pass& ) = delete;
+
+        CullingStatistics& _statistics;
+        Counters _counters;
+        const std::chrono::steady_clock::time_point _start;
+    };
+
+    CullingStatistics();
+
+    /** Add the counters of one pass to the accumulator of this thread. */
+    void add( const Counters& counters );
+
+    /** @return the merged counters of all threads. */
+    Counters get() const;
+
+    /** Reset the counters of all threads. */
+    void reset();
+
+private:
+    CullingStatistics( const CullingStatistics& ) = delete;
+    CullingStatistics& operator = ( const CullingStatistics& ) = delete;
+
+    struct Accumulator
+    {
+        std::thread::id thread;
+        mutable std::mutex mutex; // only contended by get() and reset()
+        Counters counters;
+    };
+
+    Accumulator& _get_accumulator();
+    static uint64_t _next_id();
+
+    const uint64_t _id; // unlike the address, never reused by a new instance
+    mutable std::mutex _mutex;
+    std::deque< Accumulator > _accumulators;
+};
+
+// - implementation - //
+
+inline CullingStatistics::Counters::Counters()
+    : passes( 0 )
+    , tested( 0 )
+    , plane_tests( 0 )
+    , nanoseconds( 0 )
+{
+    results[ 0 ] = results[ 1 ] = results[ 2 ] = 0;
+}
+
+inline CullingStatistics::Counters&
+CullingStatistics::Counters::operator += ( const Counters& rhs )
+{
+    passes += rhs.passes;
+    tested += rhs.tested;
+    for( size_t i = 0; i < 3; ++i )
+        results[ i ] += rhs.results[ i ];
+    plane_tests += rhs.plane_tests;
+    nanoseconds += rhs.nanoseconds;
+    return *this;
+}
+
+inline CullingStatistics::Pass::Pass( CullingStatistics& statistics )
+    : _statistics( statistics )
+    , _start( std::chrono::steady_clock::now( ))
+{
+    _counters.passes = 1;
+}
+
+inline CullingStatistics::Pass::~Pass()
+{
+    _counters.tested = _counters.results[ 0 ] + _counters.results[ 1 ] +
+                       _counters.results[ 2 ];
+    _counters.nanoseconds =
+        std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::steady_clock::now() - _start ).count();
+    _statistics.add( _counters );
+}
+
+inline void CullingStatistics::Pass::add( const size_t visibility,
+                                          const size_t plane_tests,
+                                          const size_t n )
+{
+    _counters.results[ visibility ] += n;
+    _counters.plane_tests += plane_tests * n;
+}
+
+inline CullingStatistics::CullingStatistics()
+    : _id( _next_id( ))
+{}
+
+inline uint64_t CullingStatistics::_next_id()
+{
+    static std::atomic< uint64_t > id( 0 );
+    return ++id;
+}
+
+inline CullingStatistics::Accumulator& CullingStatistics::_get_accumulator()
+{
+    // cache the accumulator of the last statistics used by this thread
+    struct Cache
+    {
+        uint64_t id;
+        Accumulator* accumulator;
+    };
+    static thread_local Cache cache = { 0, 0 };
+    if( cache.id == _id )
+        return *cache.accumulator;
+
+    const std::thread::id thread = std::this_thread::get_id();
+    std::lock_guard< std::mutex > lock( _mutex );
+    Accumulator* accumulator = 0;
+    for( Accumulator& candidate : _accumulators )
+        if( candidate.thread == thread )
+            accumulator = &candidate;
+
+    if( !accumulator )
+    {
+        _accumulators.emplace_back();
+        accumulator = &_accumulators.back();
+        accumulator->thread = thread;
+    }
+    cache.id = _id;
+    cache.accumulator = accumulator;
+    return *accumulator;
+}
+
+inline void CullingStatistics::add( const Counters& counters )
+{
+    Accumulator& accumulator = _get_accumulator();
+    std::lock_guard< std::mutex > lock( accumulator.mutex );
+    accumulator.counters += counters;
+}
+
+inline CullingStatistics::Counters CullingStatistics::get() const
+{
+    Counters counters;
+    std::lock_guard< std::mutex > lock( _mutex );
+    for( const Accumulator& accumulator : _accumulators )
+    {
+        std::lock_guard< std::mutex > accumulatorLock( accumulator.mutex );
+        counters += accumulator.counters;
+    }
+    return counters;
+}
+
+inline void CullingStatistics::reset()
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    for( Accumulator& accumulator : _accumulators )
+    {
+        std::lock_guard< std::mutex > accumulatorLock( accumulator.mutex );
+        accumulator.counters = Counters();
+    }
+}
+
+} // namespace vmml
+
+#endif // include protection
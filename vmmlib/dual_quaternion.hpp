@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__DUAL_QUATERNION__HPP
+#define VMMLIB__DUAL_QUATERNION__HPP
+
+#include <vmmlib/vmmlib_config.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/quaternion.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// - declaration - //
+
+namespace vmml
+{
+
+/**
+ * A unit dual quaternion representing a rigid transformation.
+ *
+ * The real part holds the rotation, the dual part half the translation
+ * multiplied by the rotation: q = r + e * ( t * r ) / 2. With eight values a
+ * dual quaternion is half the size of a Matrix< 4, 4, T > and can be blended
+ * linearly without the candy-wrapper artifacts of linearly blended matrices.
+ */
+template< typename T > class DualQuaternion
+{
+public:
+    typedef Vector< 3, T >  vec3;
+    typedef Quaternion< T > quat;
+
+    /** Create an identity transformation. */
+    DualQuaternion();
+    DualQuaternion( const quat& real_, const quat& dual_ );
+
+    /** Create a rotation followed by a translation. */
+    DualQuaternion( const quat& rotation, const vec3& translation );
+
+    /** Create from the rotation and translation of a rigid 4x4 matrix. */
+    explicit DualQuaternion( const Matrix< 4, 4, T >& matrix_ );
+
+    void identity();
+    void set( const quat& rotation, const vec3& translation );
+    void set( const Matrix< 4, 4, T >& matrix_ );
+
+    const quat& real() const { return _real; }
+    const quat& dual() const { return _dual; }
+    quat& real() { return _real; }
+    quat& dual() { return _dual; }
+
+    bool operator==( const DualQuaternion& other ) const;
+    bool operator!=( const DualQuaternion& other ) const;
+    bool equals( const DualQuaternion& other,
+                 T tolerance = std::numeric_limits< T >::epsilon( )) const;
+
+    // caution: a * q != q * a in general. q is applied first.
+    DualQuaternion operator*( const DualQuaternion& q ) const;
+    void operator*=( const DualQuaternion& q );
+
+    DualQuaternion operator*( T scalar ) const;
+    DualQuaternion operator+( const DualQuaternion& q ) const;
+    void operator+=( const DualQuaternion& q );
+    DualQuaternion operator-() const;
+
+    // the quaternion conjugate, i.e. the inverse for unit dual quaternions
+    DualQuaternion get_conjugate() const;
+
+    // makes the real part unit length and the dual part orthogonal to it
+    void normalize();
+    DualQuaternion get_normalized() const;
+
+    quat get_rotation() const { return _real; }
+    vec3 get_translation() const;
+
+    Matrix< 4, 4, T > get_matrix() const;
+    void get_matrix( Matrix< 4, 4, T >& matrix_ ) const;
+
+    vec3 transform_point( const vec3& point ) const;
+    vec3 transform_vector( const vec3& vector_ ) const;
+
+    /**
+     * Screw linear interpolation. Interpolates with constant speed along the
+     * screw motion from p to q, the rigid equivalent of slerp.
+     */
+    static DualQuaternion sclerp( T a, const DualQuaternion& p,
+                                  const DualQuaternion& q );
+
+    /**
+     * Dual quaternion linear blending (DLB) of count weighted dual
+     * quaternions. All inputs are flipped to the hemisphere of the first one.
+     */
+    static DualQuaternion blend( const DualQuaternion* dqs, const T* weights,
+                                 size_t count );
+
+    /**
+     * Batched DLB, e.g. for skinning: result[i] blends the influences
+     * dqs[ indices[ i * influences + j ]] weighted by
+     * weights[ i * influences + j ] for j < influences. Without influences,
+     * all results are the identity.
+     */
+    static void blend( const DualQuaternion* dqs, const size_t* indices,
+                       const T* weights, size_t influences,
+                       DualQuaternion* result, size_t count );
+
+    friend std::ostream& operator << ( std::ostream& os,
+                                       const DualQuaternion& q )
+    {
+        return os << q._real << "+ e " << q._dual;
+    }
+
+    static const DualQuaternion IDENTITY;
+
+private:
+    quat _real;
+    quat _dual;
+
+}; // class DualQuaternion
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef DualQuaternion< float >  DualQuaternionf;
+typedef DualQuaternion< double > DualQuaterniond;
+#endif
+
+// - implementation - //
+
+template< typename T >
+const DualQuaternion< T > DualQuaternion< T >::IDENTITY;
+
+template< typename T >
+DualQuaternion< T >::DualQuaternion()
+    : _real( 0, 0, 0, 1 )
+    , _dual( 0, 0, 0, 0 )
+{}
+
+template< typename T >
+DualQuaternion< T >::DualQuaternion( const quat& real_, const quat& dual_ )
+    : _real( real_ )
+    , _dual( dual_ )
+{}
+
+template< typename T >
+DualQuaternion< T >::DualQuaternion( const quat& rotation,
+                                     const vec3& translation )
+{
+    set( rotation, translation );
+}
+
+template< typename T >
+DualQuaternion< T >::DualQuaternion( const Matrix< 4, 4, T >& matrix_ )
+{
+    set( matrix_ );
+}
+
+template< typename T >
+void DualQuaternion< T >::identity()
+{
+    _real.set( 0, 0, 0, 1 );
+    _dual.set( 0, 0, 0, 0 );
+}
+
+template< typename T >
+void DualQuaternion< T >::set( const quat& rotation, const vec3& t )
+{
+    _real = rotation;
+
+    // dual = 0.5 * ( t, 0 ) * rotation
+    const quat& r = rotation;
+    _dual.set(  0.5 * (  t.x() * r.w() + t.y() * r.z() - t.z() * r.y( )),
+                0.5 * ( -t.x() * r.z() + t.y() * r.w() + t.z() * r.x( )),
+                0.5 * (  t.x() * r.y() - t.y() * r.x() + t.z() * r.w( )),
+               -0.5 * (  t.x() * r.x() + t.y() * r.y() + t.z() * r.z( )));
+}
+
+template< typename T >
+void DualQuaternion< T >::set( const Matrix< 4, 4, T >& matrix_ )
+{
+    set( quat( matrix_ ), matrix_.get_translation( ));
+}
+
+template< typename T >
+bool DualQuaternion< T >::operator==( const DualQuaternion& other ) const
+{
+    return _real == other._real && _dual == other._dual;
+}
+
+template< typename T >
+bool DualQuaternion< T >::operator!=( const DualQuaternion& other ) const
+{
+    return !( *this == other );
+}
+
+template< typename T >
+bool DualQuaternion< T >::equals( const DualQuaternion& other,
+                                  T tolerance ) const
+{
+    for( size_t i = 0; i < 4; ++i )
+        if( std::abs( _real( i ) - other._real( i )) > tolerance ||
+            std::abs( _dual( i ) - other._dual( i )) > tolerance )
+        {
+            return false;
+        }
+    return true;
+}
+
+template< typename T >
+DualQuaternion< T >
+DualQuaternion< T >::operator*( const DualQuaternion& q ) const
+{
+    return DualQuaternion( _real * q._real,
+                           _real * q._dual + _dual * q._real );
+}
+
+template< typename T >
+void DualQuaternion< T >::operator*=( const DualQuaternion& q )
+{
+    *this = *this * q;
+}
+
+template< typename T >
+DualQuaternion< T > DualQuaternion< T >::operator*( const T scalar ) const
+{
+    return DualQuaternion( _real * scalar, _dual * scalar );
+}
+
+template< typename T >
+DualQuaternion< T >
+DualQuaternion< T >::operator+( const DualQuaternion& q ) const
+{
+    return DualQuaternion( _real + q._real, _dual + q._dual );
+}
+
+template< typename T >
+void DualQuaternion< T >::operator+=( const DualQuaternion& q )
+{
+    _real += q._real;
+    _dual += q._dual;
+}
+
+template< typename T >
+DualQuaternion< T > DualQuaternion< T >::operator-() const
+{
+    return DualQuaternion( -_real, -_dual );
+}
+
+template< typename T >
+DualQuaternion< T > DualQuaternion< T >::get_conjugate() const
+{
+    return DualQuaternion( _real.get_conjugate(), _dual.get_conjugate( ));
+}
+
+template< typename T >
+void DualQuaternion< T >::normalize()
+{
+    const T length = _real.abs();
+    if( length == 0 )
+        return;
+
+    const T inv_length = 1 / length;
+    _real *= inv_length;
+    _dual *= inv_length;
+
+    // remove the component of the dual part along the real part
+    _dual -= _real * _real.dot( _dual );
+}
+
+template< typename T >
+DualQuaternion< T > DualQuaternion< T >::get_normalized() const
+{
+    DualQuaternion result( *this );
+    result.normalize();
+    return result;
+}
+
+template< typename T >
+Vector< 3, T > DualQuaternion< T >::get_translation() const
+{
+    // t = 2 * dual * conjugate( real )
+    const quat& r = _real;
+    const quat& d = _dual;
+    return vec3( 2 * ( -d.w() * r.x() + d.x() * r.w() - d.y() * r.z() + d.z() * r.y( )),
+                 2 * ( -d.w() * r.y() + d.x() * r.z() + d.y() * r.w() - d.z() * r.x( )),
+                 2 * ( -d.w() * r.z() - d.x() * r.y() + d.y() * r.x() + d.z() * r.w( )));
+}
+
+template< typename T >
+Matrix< 4, 4, T > DualQuaternion< T >::get_matrix() const
+{
+    Matrix< 4, 4, T > matrix_;
+    get_matrix( matrix_ );
+    return matrix_;
+}
+
+template< typename T >
+void DualQuaternion< T >::get_matrix( Matrix< 4, 4, T >& matrix_ ) const
+{
+    _real.get_rotation_matrix( matrix_ );
+    const vec3& t = get_translation();
+    matrix_( 0, 3 ) = t.x();
+    matrix_( 1, 3 ) = t.y();
+    matrix_( 2, 3 ) = t.z();
+    matrix_( 3, 0 ) = matrix_( 3, 1 ) = matrix_( 3, 2 ) = 0;
+    matrix_( 3, 3 ) = 1;
+}
+
+template< typename T >
+Vector< 3, T > DualQuaternion< T >::transform_vector( const vec3& v ) const
+{
+    // v' = v + 2 * r.xyz x ( r.xyz x v + r.w * v )
+    const vec3 r( _real.x(), _real.y(), _real.z( ));
+    const vec3 tmp = r.cross( v ) + v * _real.w();
+    return v + r.cross( tmp ) * 2;
+}
+
+template< typename T >
+Vector< 3, T > DualQuaternion< T >::transform_point( const vec3& p ) const
+{
+    return transform_vector( p ) + get_translation();
+}
+
+template< typename T >
+DualQuaternion< T > DualQuaternion< T >::sclerp( const T a,
+                                                 const DualQuaternion& p,
+                                                 const DualQuaternion& q )
+{
+    // relative motion from p to q along the shortest path
+    DualQuaternion diff = p.get_conjugate() * q;
+    if( diff._real.w() < 0 )
+        diff = -diff;
+
+    const vec3 axis( diff._real.x(), diff._real.y(), diff._real.z( ));
+    const T sin_half = axis.length();
+    const vec3 translation = diff.get_translation();
+
+    // pure translation, screw axis undefined
+    if( sin_half < std::numeric_limits< T >::epsilon() * 16 )
+        return p * DualQuaternion( quat::IDENTITY, translation * a );
+
+    // screw parameters: direction, moment, angle and pitch
+    const vec3 direction = axis / sin_half;
+    const T angle = 2 * std::atan2( sin_half, diff._real.w( ));
+    const T pitch = translation.dot( direction );
+    const vec3 moment = ( translation.cross( direction ) +
+                          ( translation - direction * pitch ) *
+                          ( diff._real.w() / sin_half )) * 0.5;
+
+    // diff^a
+    const T half_angle = a * angle * 0.5;
+    const T half_pitch = a * pitch * 0.5;
+    const T sine = std::sin( half_angle );
+    const T cosine = std::cos( half_angle );
+
+    const quat real_( direction * sine, cosine );
+    const quat dual_( moment * sine + direction * ( half_pitch * cosine ),
+                      -half_pitch * sine );
+    return p * DualQuaternion( real_, dual_ );
+}
+
+template< typename T >
+DualQuaternion< T > DualQuaternion< T >::blend( const DualQuaternion* dqs,
+                                                const T* weights,
+                                                const size_t count )
+{
+    if( count == 0 )
+        return IDENTITY;
+
+    const quat& pivot = dqs[0]._real;
+    DualQuaternion result( quat( 0, 0, 0, 0 ), quat( 0, 0, 0, 0 ));
+    for( size_t i = 0; i < count; ++i )
+    {
+        const DualQuaternion& dq = dqs[ i ];
+        const T weight = pivot.dot( dq._real ) < 0 ? -weights[ i ]
+                                                    : weights[ i ];
+        result += dq * weight;
+    }
+    result.normalize();
+    return result;
+}
+
+template< typename T >
+void DualQuaternion< T >::blend( const DualQuaternion* dqs,
+                                 const size_t* indices, const T* weights,
+                                 const size_t influences,
+                                 DualQuaternion* result, const size_t count )
+{
+    if( influences == 0 )
+    {
+        std::fill( result, result + count, IDENTITY );
+        return;
+    }
+
+    for( size_t i = 0; i < count; ++i, indices += influences,
+                                        weights += influences )
+    {
+        // accumulate in plain arrays to keep the inner loop free of temporaries
+        T sum[ 8 ] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        const quat& pivot = dqs[ indices[0] ]._real;
+
+        for( size_t j = 0; j < influences; ++j )
+        {
+            const DualQuaternion& dq = dqs[ indices[ j ]];
+            const T weight = pivot.dot( dq._real ) < 0 ? -weights[ j ]
+                                                        : weights[ j ];
+            for( size_t k = 0; k < 4; ++k )
+            {
+                sum[ k ]     += dq._real( k ) * weight;
+                sum[ k + 4 ] += dq._dual( k ) * weight;
+            }
+        }
+
+        DualQuaternion& out = result[ i ];
+        out._real.set( sum[0], sum[1], sum[2], sum[3] );
+        out._dual.set( sum[4], sum[5], sum[6], sum[7] );
+        out.normalize();
+    }
+}
+
+} // namespace vmml
+
+#endif
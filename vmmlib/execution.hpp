@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__EXECUTION__HPP
+#define VMMLIB__EXECUTION__HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// - declaration -
+
+namespace vmml
+{
+
+/**
+ * Interface of the executors running the chunks of parallel operations.
+ *
+ * Implement it to run vmmlib operations on an existing task system, or use the
+ * built-in ThreadPool.
+ */
+class Executor
+{
+public:
+    virtual ~Executor() {}
+
+    /**
+     * Run task( i ) for all i in [0, n_chunks) and return when all are done.
+     * Chunks may run concurrently and in any order. If a chunk throws, the
+     * chunks not yet started are skipped and the first exception is rethrown
+     * once no chunk is running.
+     */
+    virtual void run( size_t n_chunks,
+                      const std::function< void( size_t ) >& task ) = 0;
+};
+
+/**
+ * A fixed set of worker threads running one chunked task at a time.
+ *
+ * The workers and the calling thread claim the chunks of a task from a shared
+ * counter, so threads finishing early take over the remaining chunks of slower
+ * ones. Tasks started from within a task, or while another thread's task is
+ * running, run on the calling thread.
+ */
+class ThreadPool : public Executor
+{
+public:
+    /** Create a pool using n_threads threads, including the calling one. */
+    explicit ThreadPool( size_t n_threads =
+                             std::thread::hardware_concurrency( ));
+    ~ThreadPool();
+
+    void run( size_t n_chunks,
+              const std::function< void( size_t ) >& task ) final;
+
+    /** @return the number of threads running a task. */
+    size_t get_size() const { return _workers.size() + 1; }
+
+    /**
+     * @return the pool used by ExecutionPolicy::parallel(), with a thread per
+     *         hardware thread, created on first use.
+     */
+    static ThreadPool& get_default();
+
+private:
+    ThreadPool( const ThreadPool& ) = delete;
+    ThreadPool& operator = ( const ThreadPool& ) = delete;
+
+    void _work();
+    void _run_chunks( const std::function< void( size_t ) >& task,
+                      size_t n_chunks );
+    static bool& _is_busy();
+
+    std::vector< std::thread > _workers;
+    std::mutex _run_mutex; // one task at a time
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _finish;
+
+    const std::function< void( size_t ) >* _task;
+    size_t _n_chunks;
+    std::atomic< size_t > _next_chunk;
+    size_t _n_running;
+    uint64_t _generation;
+    std::exception_ptr _exception; // first exception thrown by a chunk
+    bool _stop;
+};
+
+/**
+ * How an operation runs: sequentially on the calling thread, the default, or
+ * split into chunks of at least grain_size items on an executor. Operations
+ * smaller than one chunk always run sequentially.
+ */
+struct ExecutionPolicy
+{
+    ExecutionPolicy() : executor( 0 ), grain_size( 0 ) {}
+    ExecutionPolicy( Executor* executor_, const size_t grain_size_ )
+        : executor( executor_ ), grain_size( grain_size_ ) {}
+
+    /** @return the policy running on the calling thread. */
+    static ExecutionPolicy sequential() { return ExecutionPolicy(); }
+
+    /**
+     * @return a policy running on the default ThreadPool.
+     * @param grain_size the minimum number of items per chunk, or 0 to choose
+     *        it from the cost of the items
+     */
+    static ExecutionPolicy parallel( size_t grain_size = 0 )
+        { return ExecutionPolicy( &ThreadPool::get_default(), grain_size ); }
+
+    /** @return a policy running on the given executor. */
+    static ExecutionPolicy parallel( Executor& executor,
+                                     size_t grain_size = 0 )
+        { return ExecutionPolicy( &executor, grain_size ); }
+
+    /**
+     * @return the number of items per chunk for items costing about cost
+     *         multiply-adds each.
+     */
+    size_t get_grain_size( size_t cost ) const;
+
+    Executor* executor; //!< executor of the chunks, 0 for sequential
+    size_t grain_size;  //!< minimum items per chunk, 0 for automatic
+
+    /** Multiply-adds per chunk with automatic grain size. */
+    static const size_t MIN_CHUNK_COST = 32768;
+};
+
+/**
+ * Call fn( begin, end ) for consecutive ranges covering [0, n), using the
+ * policy's executor for more than one chunk.
+ * @param cost the approximate number of multiply-adds per item
+ */
+template< class F >
+void parallel_for( const ExecutionPolicy& policy, size_t n, F fn,
+                   size_t cost = 1 );
+
+/**
+ * @return combine( ... combine( combine( init, map( 0, e0 )),
+ *         map( e0, e1 )) ..., map( ek, n )) for the chunks of [0, n).
+ *
+ * The chunks only depend on n, cost and the policy's grain size, and are
+ * combined in order on the calling thread, so the result is the same for the
+ * sequential policy and any executor or thread count.
+ */
+template< class R, class M, class C >
+R parallel_reduce( const ExecutionPolicy& policy, size_t n, R init, M map,
+                   C combine, size_t cost = 1 );
+
+// - implementation - //
+
+inline ThreadPool::ThreadPool( const size_t n_threads )
+    : _task( 0 )
+    , _n_chunks( 0 )
+    , _next_chunk( 0 )
+    , _n_running( 0 )
+    , _generation( 0 )
+    , _stop( false )
+{
+    for( size_t i = 1; i < n_threads; ++i )
+        _workers.push_back( std::thread( &ThreadPool::_work, this ));
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        _stop = true;
+    }
+    _start.notify_all();
+    for( std::thread& worker : _workers )
+        worker.join();
+}
+
+inline ThreadPool& ThreadPool::get_default()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+inline bool& ThreadPool::_is_busy()
+{
+    static thread_local bool busy = false;
+    return busy;
+}
+
+inline void ThreadPool::_run_chunks(
+    const std::function< void( size_t ) >& task, const size_t n_chunks )
+{
+    try
+    {
+        for( size_t i = _next_chunk++; i < n_chunks; i = _next_chunk++ )
+            task( i );
+    }
+    catch( ... )
+    {
+        // skip the remaining chunks, run() rethrows after all have stopped
+        std::lock_guard< std::mutex > lock( _mutex );
+        if( !_exception )
+            _exception = std::current_exception();
+        _next_chunk = n_chunks;
+    }
+}
+
+inline void ThreadPool::_work()
+{
+    _is_busy() = true;
+    uint64_t generation = 0;
+    std::unique_lock< std::mutex > lock( _mutex );
+    for( ;; )
+    {
+        _start.wait( lock, [&] { return _stop || _generation != generation; });
+        if( _stop )
+            return;
+
+        // skip tasks finished before this worker woke up
+        generation = _generation;
+        if( !_task )
+            continue;
+
+        const std::function< void( size_t ) >& task = *_task;
+        const size_t n_chunks = _n_chunks;
+        ++_n_running;
+        lock.unlock();
+        _run_chunks( task, n_chunks );
+        lock.lock();
+        if( --_n_running == 0 )
+            _finish.notify_all();
+    }
+}
+
+inline void ThreadPool::run( const size_t n_chunks,
+                             const std::function< void( size_t ) >& task )
+{
+    std::unique_lock< std::mutex > runLock( _run_mutex, std::defer_lock );
+    if( _workers.empty() || n_chunks < 2 || _is_busy() || !runLock.try_lock( ))
+    {
+        for( size_t i = 0; i < n_chunks; ++i )
+            task( i );
+        return;
+    }
+
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        _task = &task;
+        _n_chunks = n_chunks;
+        _next_chunk = 0;
+        ++_generation;
+    }
+    _start.notify_all();
+
+    _is_busy() = true;
+    _run_chunks( task, n_chunks );
+    _is_busy() = false;
+
+    // wait for the workers still running a chunk of this task
+    std::unique_lock< std::mutex > lock( _mutex );
+    _finish.wait( lock, [&] { return _n_running == 0; });
+    _task = 0;
+    _n_chunks = 0;
+
+    std::exception_ptr exception;
+    std::swap( exception, _exception );
+    lock.unlock();
+    if( exception )
+        std::rethrow_exception( exception );
+}
+
+inline size_t ExecutionPolicy::get_grain_size( const size_t cost ) const
+{
+    if( grain_size > 0 )
+        return grain_size;
+    return cost >= MIN_CHUNK_COST ? 1 : MIN_CHUNK_COST / ( cost ? cost : 1 );
+}
+
+template< class F >
+void parallel_for( const ExecutionPolicy& policy, const size_t n, F fn,
+                   const size_t cost )
+{
+    const size_t grain = policy.get_grain_size( cost );
+    if( !policy.executor || n <= grain )
+    {
+        fn( size_t( 0 ), n );
+        return;
+    }
+
+    const size_t n_chunks = ( n + grain - 1 ) / grain;
+    policy.executor->run( n_chunks, [&]( const size_t chunk )
+    {
+        const size_t begin = chunk * grain;
+        fn( begin, begin + grain < n ? begin + grain : n );
+    });
+}
+
+template< class R, class M, class C >
+R parallel_reduce( const ExecutionPolicy& policy, const size_t n, R init,
+                   M map, C combine, const size_t cost )
+{
+    const size_t grain = policy.get_grain_size( cost );
+    const size_t n_chunks = n == 0 ? 0 : ( n + grain - 1 ) / grain;
+    std::vector< R > results( n_chunks, init );
+    const auto task = [&]( const size_t chunk )
+    {
+        const size_t begin = chunk * grain;
+        results[ chunk ] = map( begin, begin + grain < n ? begin + grain : n );
+    };
+
+    if( policy.executor && n_chunks > 1 )
+        policy.executor->run( n_chunks, task );
+    else
+        for( size_t i = 0; i < n_chunks; ++i )
+            task( i );
+
+    for( size_t i = 0; i < n_chunks; ++i )
+        init = combine( init, results[ i ] );
+    return init;
+}
+
+} // namespace vmml
+
+#endif // include protection
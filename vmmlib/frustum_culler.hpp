@@ -33,9 +33,17 @@
 #ifndef VMMLIB__FRUSTUM_CULLER__HPP
 #define VMMLIB__FRUSTUM_CULLER__HPP
 
+#include <vmmlib/aabb.hpp>
+#include <vmmlib/culling_statistics.hpp>
+#include <vmmlib/execution.hpp>
+#include <vmmlib/instrument.hpp>
+#include <vmmlib/obb.hpp>
 #include <vmmlib/vector.hpp>
 #include <vmmlib/matrix.hpp>
 
+#include <atomic>
+#include <thread>
+
 // - declaration -
 
 namespace vmml
@@ -65,7 +73,8 @@ public:
     typedef Vector< 4, T >    vec4;
 
     // contructors
-    FrustumCuller() {}
+    FrustumCuller() : _w_row( 0, 0, 0, 1 ), _scale( 0, 0 ),
+                      _statistics( 0 ) {}
     ~FrustumCuller(){}
 
     /** Set up the culling state using a 4x4 projection*modelView matrix. */
@@ -82,6 +91,100 @@ public:
 
     Visibility test_sphere( const vec4& sphere ) const;
     Visibility test_aabb( const vec2& x, const vec2& y, const vec2& z ) const;
+    Visibility test_aabb( const AABB< T >& aabb ) const;
+    Visibility test_obb( const OBB< T >& obb ) const;
+
+    /**
+     * Test an AABB like test_aabb(), refining partial results with the
+     * separating axis test against the frustum corners. Boxes near the frustum
+     * edges which the plane tests report as partially visible are found
+     * invisible. Falls back to test_aabb() if the corners are unknown, i.e.,
+     * the matrix given to setup() is not invertible.
+     */
+    Visibility test_aabb_exact( const AABB< T >& aabb ) const;
+
+    /**
+     * Test n AABBs, writing their visibility to result.
+     * @param exact use test_aabb_exact() instead of test_aabb()
+     */
+    void test_aabbs( const AABB< T >* aabbs, size_t n, Visibility* result,
+                     bool exact = false ) const;
+
+    /**
+     * Test n AABBs like test_aabbs() in chunks run by the policy. With
+     * statistics, each chunk counts as one pass.
+     */
+    void test_aabbs( const AABB< T >* aabbs, size_t n, Visibility* result,
+                     const ExecutionPolicy& policy, bool exact = false ) const;
+
+    /**
+     * @return the approximate radius in pixels of the projected sphere for
+     *         the given viewport size, the largest value of T if the sphere
+     *         contains the eye, or 0 if the culler was set up from corners.
+     *         The area in pixels is pi times its square.
+     */
+    T get_projected_radius( const vec4& sphere, const vec2& viewport ) const;
+
+    /**
+     * Test a sphere like test_sphere(), also computing its projected radius
+     * for the given viewport, which is 0 if the sphere is not visible.
+     */
+    Visibility test_sphere( const vec4& sphere, const vec2& viewport,
+                            T& radius ) const;
+
+    /**
+     * Test an AABB like test_aabb(), also computing the projected radius of
+     * its bounding sphere for the given viewport, which is 0 if the box is not
+     * visible.
+     */
+    Visibility test_aabb( const AABB< T >& aabb, const vec2& viewport,
+                          T& radius ) const;
+
+    /**
+     * Test n spheres, writing their visibility and projected radius for the
+     * given viewport to the result arrays.
+     */
+    void test_spheres( const vec4* spheres, size_t n, const vec2& viewport,
+                       Visibility* visibility, T* radius ) const;
+
+    /**
+     * Test n AABBs, writing their visibility and the projected radius of
+     * their bounding sphere for the given viewport to the result arrays.
+     */
+    void test_aabbs( const AABB< T >* aabbs, size_t n, const vec2& viewport,
+                     Visibility* visibility, T* radius ) const;
+
+    /**
+     * @return true if the two frusta overlap, using the separating axis test
+     *         on the frustum corners. Conservatively true if the corners of
+     *         either frustum are unknown.
+     */
+    bool test_frustum( const FrustumCuller& other ) const;
+
+    /**
+     * Test n frusta against this one, writing 1 for overlapping and 0 for
+     * separated frusta to result.
+     */
+    void test_frusta( const FrustumCuller* frusta, size_t n,
+                      uint8_t* result ) const;
+
+    /**
+     * @return the eight frustum corners in the order of the setup()
+     *         parameters, or 0 if they are unknown. After a setup() from a
+     *         matrix, they are computed by the first call to this, to
+     *         test_aabb_exact() or to test_frustum().
+     */
+    const vec3* get_corners() const { return _get_corners(); }
+
+    /**
+     * Set the statistics counting the batch tests of spheres and AABBs, or 0
+     * to disable counting. The statistics are not owned by the culler.
+     */
+    void set_statistics( CullingStatistics* statistics )
+        { _statistics = statistics; }
+
+    /** @return the statistics counting the batch tests, or 0. */
+    CullingStatistics* get_statistics() const { return _statistics; }
 
     friend std::ostream& operator << (std::ostream& os, const FrustumCuller& f)
     {
@@ -98,6 +201,19 @@ private:
     inline void _normalize_plane( vec4& plane ) const;
     inline Visibility _test_aabb( const vec4& plane, const vec3& middle,
                                   const vec3& size_2 ) const;
+    inline Visibility _test_sphere( const vec4& sphere,
+                                    size_t& plane_tests ) const;
+    inline Visibility _test_box( const vec3& middle, const vec3& extent,
+                                 size_t& plane_tests ) const;
+    inline Visibility _test_aabb( const AABB< T >& aabb,
+                                  size_t& plane_tests ) const;
+    Visibility _test_aabb_exact( const AABB< T >& aabb,
+                                 size_t& plane_tests ) const;
+    inline vec3 _edge( size_t index ) const;
+    inline void _project( const vec3& axis, T& min, T& max ) const;
+    bool _separates( const vec3& axis, const FrustumCuller& other ) const;
+    inline T _get_projection_scale( const vec2& viewport ) const;
+    inline T _project_radius( const vec4& sphere, T scale ) const;
 
     vec4    _left_plane;
     vec4    _right_plane;
@@ -106,6 +222,33 @@ private:
     vec4    _near_plane;
     vec4    _far_plane;
 
+    // The corners of a setup() from a matrix are computed on first use by
+    // _get_corners(), also from concurrent const calls: the first call
+    // computes them while the others wait.
+    struct Corners
+    {
+        enum State { UNKNOWN, COMPUTING, KNOWN };
+
+        Corners() : valid( false ), state( KNOWN ) {}
+        Corners( const Corners& from ) : valid( false ), state( KNOWN )
+            { *this = from; }
+        Corners& operator = ( const Corners& from );
+
+        vec3 points[ 8 ];
+        bool valid;
+        std::atomic< int > state;
+    };
+
+    const vec3* _get_corners() const;
+
+    Matrix< 4, 4, T > _matrix; // of setup(), for computing the corners
+    mutable Corners _corners;
+
+    vec4    _w_row; // last matrix row, the view depth for perspective
+    vec2    _scale; // length of the x and y rows of the rotation part
+
+    CullingStatistics* _statistics;
+
 }; // class frustum_culler
 
 
@@ -157,6 +300,13 @@ void FrustumCuller< T >::setup( const Matrix< 4, 4, T >& proj_modelview )
     _normalize_plane( _top_plane );
     _normalize_plane( _near_plane );
     _normalize_plane( _far_plane );
+
+    _w_row = row3;
+    _scale = vec2( row0.template get_sub_vector< 3 >().length(),
+                   row1.template get_sub_vector< 3 >().length( ));
+
+    _matrix = proj_modelview;
+    _corners.state = Corners::UNKNOWN;
 }
 
 template < class T >
@@ -177,6 +327,20 @@ void FrustumCuller< T >::setup( const vec3& a, const vec3& b,
     _top_plane    = compute_plane( a, b, f );
     _near_plane   = compute_plane( b, a, c );
     _far_plane    = compute_plane( g, e, f );
+
+    _corners.points[ 0 ] = a;
+    _corners.points[ 1 ] = b;
+    _corners.points[ 2 ] = c;
+    _corners.points[ 3 ] = d;
+    _corners.points[ 4 ] = e;
+    _corners.points[ 5 ] = f;
+    _corners.points[ 6 ] = g;
+    _corners.points[ 7 ] = h;
+    _corners.valid = true;
+    _corners.state = Corners::KNOWN;
+
+    _w_row = vec4( 0, 0, 0, 1 );
+    _scale = vec2( 0, 0 );
 }
 
 template < class T >
@@ -194,6 +358,14 @@ FrustumCuller< T >::_normalize_plane( Vector< 4, T >& plane ) const
 
 template < class T > Visibility
 FrustumCuller< T >::test_sphere( const Vector< 4, T >& sphere ) const
+{
+    size_t plane_tests;
+    return _test_sphere( sphere, plane_tests );
+}
+
+template < class T > inline Visibility
+FrustumCuller< T >::_test_sphere( const vec4& sphere,
+                                  size_t& plane_tests ) const
 {
     Visibility visibility = VISIBILITY_FULL;
 
@@ -203,50 +375,18 @@ FrustumCuller< T >::test_sphere( const Vector< 4, T >& sphere ) const
     // - if sphere behind plane: not visible
     // - if sphere intersects one plane: partially visible
     // - else: fully visible
-
-    T distance = _left_plane.x() * sphere.x() + _left_plane.y() * sphere.y() +
-                 _left_plane.z() * sphere.z() + _left_plane.w();
-    if( distance <= -sphere.w() )
-        return VISIBILITY_NONE;
-    if( distance < sphere.w() )
-        visibility = VISIBILITY_PARTIAL;
-
-    distance = _right_plane.x() * sphere.x() + _right_plane.y() * sphere.y() +
-               _right_plane.z() * sphere.z() + _right_plane.w();
-    if( distance <= -sphere.w() )
-        return VISIBILITY_NONE;
-    if( distance < sphere.w() )
-        visibility = VISIBILITY_PARTIAL;
-
-    distance = _bottom_plane.x() * sphere.x() + _bottom_plane.y() * sphere.y() +
-               _bottom_plane.z() * sphere.z() + _bottom_plane.w();
-    if( distance <= -sphere.w() )
-        return VISIBILITY_NONE;
-    if( distance < sphere.w() )
-        visibility = VISIBILITY_PARTIAL;
-
-    distance = _top_plane.x() * sphere.x() + _top_plane.y() * sphere.y() +
-               _top_plane.z() * sphere.z() + _top_plane.w();
-    if( distance <= -sphere.w() )
-        return VISIBILITY_NONE;
-    if( distance < sphere.w() )
-        visibility = VISIBILITY_PARTIAL;
-
-    distance = _near_plane.x() * sphere.x() + _near_plane.y() * sphere.y() +
-               _near_plane.z() * sphere.z() + _near_plane.w();
-
-    if( distance <= -sphere.w() )
-        return VISIBILITY_NONE;
-    if( distance < sphere.w() )
-        visibility = VISIBILITY_PARTIAL;
-
-    distance = _far_plane.x() * sphere.x() + _far_plane.y() * sphere.y() +
-               _far_plane.z() * sphere.z() + _far_plane.w();
-    if( distance <= -sphere.w() )
-        return VISIBILITY_NONE;
-    if( distance < sphere.w() )
-        visibility = VISIBILITY_PARTIAL;
-
+    const vec4* planes[] = { &_left_plane, &_right_plane, &_bottom_plane,
+                             &_top_plane, &_near_plane, &_far_plane };
+    for( plane_tests = 0; plane_tests < 6; )
+    {
+        const vec4& plane = *planes[ plane_tests++ ];
+        const T distance = plane.x() * sphere.x() + plane.y() * sphere.y() +
+                           plane.z() * sphere.z() + plane.w();
+        if( distance <= -sphere.w() )
+            return VISIBILITY_NONE;
+        if( distance < sphere.w() )
+            visibility = VISIBILITY_PARTIAL;
+    }
     return visibility;
 }
 
@@ -268,57 +408,422 @@ Visibility FrustumCuller< T >::_test_aabb( const vec4& plane,
     return VISIBILITY_NONE;
 }
 
+template < class T >
+inline Visibility FrustumCuller< T >::_test_box( const vec3& middle,
+                                                const vec3& extent,
+                                                size_t& plane_tests ) const
+{
+    const vec4* planes[] = { &_left_plane, &_right_plane, &_bottom_plane,
+                             &_top_plane, &_near_plane, &_far_plane };
+    Visibility result = VISIBILITY_FULL;
+    for( plane_tests = 0; plane_tests < 6; )
+    {
+        switch( _test_aabb( *planes[ plane_tests++ ], middle, extent ))
+        {
+            case VISIBILITY_FULL: break;
+            case VISIBILITY_PARTIAL: result = VISIBILITY_PARTIAL; break;
+            case VISIBILITY_NONE: return VISIBILITY_NONE;
+        }
+    }
+    return result;
+}
+
 template < class T >
 Visibility FrustumCuller< T >::test_aabb( const vec2& x, const vec2& y,
                                            const vec2& z ) const
 {
-    Visibility result = VISIBILITY_FULL;
     const vec3& middle = vec3( x[0] + x[1], y[0] + y[1], z[0] + z[1] ) * .5;
     const vec3& extent = vec3( fabs(x[1] - x[0]), fabs(y[1] - y[0]),
                                fabs(z[1] - z[0]) ) * .5;
-    switch( _test_aabb( _left_plane, middle, extent ))
+    size_t plane_tests;
+    return _test_box( middle, extent, plane_tests );
+}
+
+template < class T >
+inline Visibility FrustumCuller< T >::_test_aabb( const AABB< T >& aabb,
+                                                 size_t& plane_tests ) const
+{
+    const vec3& min = aabb.getMin();
+    const vec3& max = aabb.getMax();
+    const vec3& middle = ( min + max ) * .5;
+    const vec3& extent = vec3( fabs( max.x() - min.x( )),
+                               fabs( max.y() - min.y( )),
+                               fabs( max.z() - min.z( ))) * .5;
+    return _test_box( middle, extent, plane_tests );
+}
+
+template < class T >
+Visibility FrustumCuller< T >::test_aabb( const AABB< T >& aabb ) const
+{
+    size_t plane_tests;
+    return _test_aabb( aabb, plane_tests );
+}
+
+template < class T >
+Visibility FrustumCuller< T >::test_obb( const OBB< T >& obb ) const
+{
+    // like _test_aabb, with the extent projected onto the box axes
+    const vec4* planes[] = { &_left_plane, &_right_plane, &_bottom_plane,
+                             &_top_plane, &_near_plane, &_far_plane };
+    const vec3& center = obb.getCenter();
+    const vec3& halfExtents = obb.getHalfExtents();
+    const vec3 axes[3] = { obb.getAxis( 0 ), obb.getAxis( 1 ),
+                           obb.getAxis( 2 ) };
+
+    Visibility result = VISIBILITY_FULL;
+    for( size_t i = 0; i < 6; ++i )
     {
-        case VISIBILITY_FULL: break;
-        case VISIBILITY_PARTIAL: result = VISIBILITY_PARTIAL; break;
-        case VISIBILITY_NONE: return VISIBILITY_NONE;
+        const vec4& plane = *planes[ i ];
+        const vec3 normal( plane.x(), plane.y(), plane.z( ));
+        const T d = normal.dot( center ) + plane.w();
+        const T n = halfExtents.x() * fabs( normal.dot( axes[0] )) +
+                    halfExtents.y() * fabs( normal.dot( axes[1] )) +
+                    halfExtents.z() * fabs( normal.dot( axes[2] ));
+
+        if( d + n <= 0 )
+            return VISIBILITY_NONE;
+        if( d - n < 0 )
+            result = VISIBILITY_PARTIAL;
     }
+    return result;
+}
 
-    switch( _test_aabb( _right_plane, middle, extent ))
+template < class T > typename FrustumCuller< T >::Corners&
+FrustumCuller< T >::Corners::operator = ( const Corners& from )
+{
+    // corners being computed by another thread are computed again
+    if( from.state.load( std::memory_order_acquire ) == KNOWN )
     {
-        case VISIBILITY_FULL: break;
-        case VISIBILITY_PARTIAL: result = VISIBILITY_PARTIAL; break;
-        case VISIBILITY_NONE: return VISIBILITY_NONE;
+        std::copy( from.points, from.points + 8, points );
+        valid = from.valid;
+        state = KNOWN;
     }
+    else
+        state = UNKNOWN;
+    return *this;
+}
 
-    switch( _test_aabb( _bottom_plane, middle, extent ))
+template < class T > const typename FrustumCuller< T >::vec3*
+FrustumCuller< T >::_get_corners() const
+{
+    int state = _corners.state.load( std::memory_order_acquire );
+    if( state == Corners::UNKNOWN &&
+        _corners.state.compare_exchange_strong( state, Corners::COMPUTING,
+                                                std::memory_order_acquire ))
     {
-        case VISIBILITY_FULL: break;
-        case VISIBILITY_PARTIAL: result = VISIBILITY_PARTIAL; break;
-        case VISIBILITY_NONE: return VISIBILITY_NONE;
+        // the unit cube corners in normalized device coordinates
+        Matrix< 4, 4, T > inverse;
+        bool valid = compute_inverse( _matrix, inverse );
+        for( size_t i = 0; valid && i < 8; ++i )
+        {
+            const vec4 corner = inverse * vec4( i & 1 ? 1 : -1,
+                                                i & 2 ? -1 : 1,
+                                                i & 4 ? 1 : -1, 1 );
+            valid = corner.w() != 0;
+            _corners.points[ i ] = vec3( corner.x(), corner.y(),
+                                         corner.z( )) / corner.w();
+        }
+        _corners.valid = valid;
+        state = Corners::KNOWN;
+        _corners.state.store( state, std::memory_order_release );
     }
 
-    switch( _test_aabb( _top_plane, middle, extent ))
+    while( state != Corners::KNOWN )
     {
-        case VISIBILITY_FULL: break;
-        case VISIBILITY_PARTIAL: result = VISIBILITY_PARTIAL; break;
-        case VISIBILITY_NONE: return VISIBILITY_NONE;
+        std::this_thread::yield();
+        state = _corners.state.load( std::memory_order_acquire );
     }
+    return _corners.valid ? _corners.points : 0;
+}
+
+template < class T > inline typename FrustumCuller< T >::vec3
+FrustumCuller< T >::_edge( const size_t index ) const
+{
+    // corner index pairs of the edges with distinct directions: the lateral
+    // edges, and two edges each of the near and far faces
+    static const size_t edges[ 8 ][ 2 ] = { { 0, 4 }, { 1, 5 }, { 2, 6 },
+                                            { 3, 7 }, { 0, 1 }, { 0, 2 },
+                                            { 4, 5 }, { 4, 6 } };
+    return _corners.points[ edges[ index ][ 1 ]] -
+           _corners.points[ edges[ index ][ 0 ]];
+}
 
-    switch( _test_aabb( _near_plane, middle, extent ))
+template < class T >
+inline void FrustumCuller< T >::_project( const vec3& axis, T& min,
+                                          T& max ) const
+{
+    min = max = axis.dot( _corners.points[ 0 ] );
+    for( size_t i = 1; i < 8; ++i )
     {
-        case VISIBILITY_FULL: break;
-        case VISIBILITY_PARTIAL: result = VISIBILITY_PARTIAL; break;
-        case VISIBILITY_NONE: return VISIBILITY_NONE;
+        const T d = axis.dot( _corners.points[ i ] );
+        min = d < min ? d : min;
+        max = d > max ? d : max;
     }
+}
 
-    switch( _test_aabb( _far_plane, middle, extent ))
+template < class T >
+Visibility FrustumCuller< T >::test_aabb_exact( const AABB< T >& aabb ) const
+{
+    size_t plane_tests;
+    return _test_aabb_exact( aabb, plane_tests );
+}
+
+template < class T >
+Visibility FrustumCuller< T >::_test_aabb_exact( const AABB< T >& aabb,
+                                                 size_t& plane_tests ) const
+{
+    const Visibility visibility = _test_aabb( aabb, plane_tests );
+    if( visibility != VISIBILITY_PARTIAL || !_get_corners( ))
+        return visibility;
+
+    // The frustum planes found no separating axis, try the box faces and the
+    // cross products of box and frustum edges
+    const vec3 center = aabb.getCenter();
+    const vec3 extent = aabb.getDimension() * .5;
+    T min, max;
+    for( size_t i = 0; i < 3; ++i )
     {
-        case VISIBILITY_FULL: break;
-        case VISIBILITY_PARTIAL: result = VISIBILITY_PARTIAL; break;
-        case VISIBILITY_NONE: return VISIBILITY_NONE;
+        const vec3 axis = i == 0 ? vec3::UNIT_X : i == 1 ? vec3::UNIT_Y :
+                                                           vec3::UNIT_Z;
+        _project( axis, min, max );
+        if( center[ i ] + extent[ i ] < min || center[ i ] - extent[ i ] > max )
+            return VISIBILITY_NONE;
+
+        for( size_t j = 0; j < 8; ++j )
+        {
+            const vec3 edge = _edge( j );
+            const vec3 cross = axis.cross( edge );
+            if( cross.squared_length() <=
+                std::numeric_limits< T >::epsilon() * edge.squared_length( ))
+            {
+                continue;
+            }
+
+            const T c = cross.dot( center );
+            const T r = extent.x() * fabs( cross.x( )) +
+                        extent.y() * fabs( cross.y( )) +
+                        extent.z() * fabs( cross.z( ));
+            _project( cross, min, max );
+            if( c + r < min || c - r > max )
+                return VISIBILITY_NONE;
+        }
     }
+    return VISIBILITY_PARTIAL;
+}
 
-    return result;
+template < class T >
+void FrustumCuller< T >::test_aabbs( const AABB< T >* aabbs, const size_t n,
+                                     Visibility* result,
+                                     const bool exact ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "FrustumCuller::test_aabbs" );
+    if( _statistics )
+    {
+        CullingStatistics::Pass pass( *_statistics );
+        size_t plane_tests;
+        for( size_t i = 0; i < n; ++i )
+        {
+            result[ i ] = exact ? _test_aabb_exact( aabbs[ i ], plane_tests ) :
+                                  _test_aabb( aabbs[ i ], plane_tests );
+            pass.add( result[ i ], plane_tests );
+        }
+    }
+    else if( exact )
+        for( size_t i = 0; i < n; ++i )
+            result[ i ] = test_aabb_exact( aabbs[ i ] );
+    else
+        for( size_t i = 0; i < n; ++i )
+            result[ i ] = test_aabb( aabbs[ i ] );
+}
+
+template < class T >
+void FrustumCuller< T >::test_aabbs( const AABB< T >* aabbs, const size_t n,
+                                     Visibility* result,
+                                     const ExecutionPolicy& policy,
+                                     const bool exact ) const
+{
+    parallel_for( policy, n, [&]( const size_t begin, const size_t end )
+    {
+        test_aabbs( aabbs + begin, end - begin, result + begin, exact );
+    }, exact ? 256 : 32 );
+}
+
+template < class T >
+inline T FrustumCuller< T >::_get_projection_scale( const vec2& viewport ) const
+{
+    // geometric mean of the horizontal and vertical pixels per unit at unit
+    // depth, making pi * radius^2 the area of the projected ellipse
+    return std::sqrt( _scale.x() * _scale.y() * viewport.x() *
+                      viewport.y( )) * T( .5 );
+}
+
+template < class T >
+inline T FrustumCuller< T >::_project_radius( const vec4& sphere,
+                                              const T scale ) const
+{
+    // affine, e.g., orthographic, projections have no eye point
+    if( _w_row.x() == 0 && _w_row.y() == 0 && _w_row.z() == 0 )
+        return sphere.w() * scale / _w_row.w();
+
+    const T w = _w_row.x() * sphere.x() + _w_row.y() * sphere.y() +
+                _w_row.z() * sphere.z() + _w_row.w();
+    if( w <= sphere.w( ))
+        return scale == 0 ? 0 : std::numeric_limits< T >::max();
+    return sphere.w() * scale / w;
+}
+
+template < class T >
+T FrustumCuller< T >::get_projected_radius( const vec4& sphere,
+                                            const vec2& viewport ) const
+{
+    return _project_radius( sphere, _get_projection_scale( viewport ));
+}
+
+template < class T >
+Visibility FrustumCuller< T >::test_sphere( const vec4& sphere,
+                                            const vec2& viewport,
+                                            T& radius ) const
+{
+    const Visibility visibility = test_sphere( sphere );
+    radius = visibility == VISIBILITY_NONE ? 0 :
+                 get_projected_radius( sphere, viewport );
+    return visibility;
+}
+
+template < class T >
+Visibility FrustumCuller< T >::test_aabb( const AABB< T >& aabb,
+                                          const vec2& viewport,
+                                          T& radius ) const
+{
+    const Visibility visibility = test_aabb( aabb );
+    radius = visibility == VISIBILITY_NONE ? 0 :
+                 get_projected_radius( vec4( aabb.getCenter(),
+                                             aabb.getDimension().length() *
+                                                 T( .5 )), viewport );
+    return visibility;
+}
+
+template < class T >
+void FrustumCuller< T >::test_spheres( const vec4* spheres, const size_t n,
+                                       const vec2& viewport,
+                                       Visibility* visibility,
+                                       T* radius ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "FrustumCuller::test_spheres" );
+    const T scale = _get_projection_scale( viewport );
+    if( _statistics )
+    {
+        CullingStatistics::Pass pass( *_statistics );
+        size_t plane_tests;
+        for( size_t i = 0; i < n; ++i )
+        {
+            visibility[ i ] = _test_sphere( spheres[ i ], plane_tests );
+            radius[ i ] = visibility[ i ] == VISIBILITY_NONE ? 0 :
+                              _project_radius( spheres[ i ], scale );
+            pass.add( visibility[ i ], plane_tests );
+        }
+        return;
+    }
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        visibility[ i ] = test_sphere( spheres[ i ] );
+        radius[ i ] = visibility[ i ] == VISIBILITY_NONE ? 0 :
+                          _project_radius( spheres[ i ], scale );
+    }
+}
+
+template < class T >
+void FrustumCuller< T >::test_aabbs( const AABB< T >* aabbs, const size_t n,
+                                     const vec2& viewport,
+                                     Visibility* visibility,
+                                     T* radius ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "FrustumCuller::test_aabbs" );
+    const T scale = _get_projection_scale( viewport );
+    if( _statistics )
+    {
+        CullingStatistics::Pass pass( *_statistics );
+        size_t plane_tests;
+        for( size_t i = 0; i < n; ++i )
+        {
+            const AABB< T >& aabb = aabbs[ i ];
+            visibility[ i ] = _test_aabb( aabb, plane_tests );
+            radius[ i ] = visibility[ i ] == VISIBILITY_NONE ? 0 :
+                _project_radius( vec4( aabb.getCenter(),
+                                       aabb.getDimension().length() * T( .5 )),
+                                 scale );
+            pass.add( visibility[ i ], plane_tests );
+        }
+        return;
+    }
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        const AABB< T >& aabb = aabbs[ i ];
+        visibility[ i ] = test_aabb( aabb );
+        radius[ i ] = visibility[ i ] == VISIBILITY_NONE ? 0 :
+            _project_radius( vec4( aabb.getCenter(),
+                                   aabb.getDimension().length() * T( .5 )),
+                             scale );
+    }
+}
+
+template < class T >
+bool FrustumCuller< T >::_separates( const vec3& axis,
+                                     const FrustumCuller& other ) const
+{
+    T min, max, otherMin, otherMax;
+    _project( axis, min, max );
+    other._project( axis, otherMin, otherMax );
+    return max < otherMin || otherMax < min;
+}
+
+template < class T >
+bool FrustumCuller< T >::test_frustum( const FrustumCuller& other ) const
+{
+    if( !_get_corners() || !other._get_corners( ))
+        return true;
+
+    const vec4* planes[] = { &_left_plane, &_right_plane, &_bottom_plane,
+                             &_top_plane, &_near_plane, &_far_plane };
+    const vec4* otherPlanes[] = { &other._left_plane, &other._right_plane,
+                                  &other._bottom_plane, &other._top_plane,
+                                  &other._near_plane, &other._far_plane };
+    for( size_t i = 0; i < 6; ++i )
+    {
+        const vec3 normal( planes[i]->x(), planes[i]->y(), planes[i]->z( ));
+        const vec3 otherNormal( otherPlanes[i]->x(), otherPlanes[i]->y(),
+                                otherPlanes[i]->z( ));
+        if( _separates( normal, other ) || _separates( otherNormal, other ))
+            return false;
+    }
+
+    for( size_t i = 0; i < 8; ++i )
+    {
+        const vec3 edge = _edge( i );
+        for( size_t j = 0; j < 8; ++j )
+        {
+            const vec3 otherEdge = other._edge( j );
+            const vec3 cross = edge.cross( otherEdge );
+            if( cross.squared_length() > std::numeric_limits< T >::epsilon() *
+                    edge.squared_length() * otherEdge.squared_length() &&
+                _separates( cross, other ))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template < class T >
+void FrustumCuller< T >::test_frusta( const FrustumCuller* frusta,
+                                      const size_t n, uint8_t* result ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "FrustumCuller::test_frusta" );
+    for( size_t i = 0; i < n; ++i )
+        result[ i ] = test_frustum( frusta[ i ] );
 }
 
 } // namespace vmml
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__FRUSTUM_GRID__HPP
+#define VMMLIB__FRUSTUM_GRID__HPP
+
+#include <vmmlib/aabb.hpp>
+#include <vmmlib/exception.hpp>
+#include <vmmlib/frustum.hpp>
+#include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <cmath>
+#include <vector>
+
+// - declaration -
+
+namespace vmml
+{
+/**
+ * A perspective frustum subdivided into a grid of sub-frusta.
+ *
+ * The frustum is split into x by y tiles on the near plane, and into z depth
+ * slices growing exponentially from the near to the far plane, as used for
+ * clustered shading. Neighbouring clusters share their boundary planes, so
+ * only x + 1, y + 1 and z + 1 slice planes are stored, each axis in a
+ * structure-of-arrays table: first all a, then all b, c and d plane
+ * coefficients. The positive side of slice plane i is towards cluster i.
+ *
+ * The planes are normalized and given in the space of the modelview matrix
+ * passed to setup(), i.e., in view space for an identity matrix.
+ */
+template< typename T > class FrustumGrid
+{
+public:
+    typedef Vector< 3, T >      vec3;
+    typedef Vector< 4, T >      vec4;
+    typedef Vector< 3, size_t > index3;
+
+    FrustumGrid();
+    FrustumGrid( const Frustum< T >& frustum, size_t x, size_t y, size_t z,
+                 const Matrix< 4, 4, T >& modelview =
+                     Matrix< 4, 4, T >::IDENTITY );
+
+    /** Compute all slice planes, for x, y and z of at least one. */
+    void setup( const Frustum< T >& frustum, size_t x, size_t y, size_t z,
+                const Matrix< 4, 4, T >& modelview =
+                    Matrix< 4, 4, T >::IDENTITY );
+
+    /** @return the number of clusters along the given axis (0, 1, 2). */
+    size_t get_size( size_t axis ) const { return _size[ axis ]; }
+
+    /** @return the SoA table of the get_size( axis ) + 1 slice planes. */
+    const T* get_planes( size_t axis ) const { return _planes[ axis ].data(); }
+
+    /** @return the view space depth of the given depth slice boundary. */
+    T get_slice_depth( size_t slice ) const;
+
+    /** @return the depth slice containing the positive view space depth. */
+    size_t get_slice( T depth ) const;
+
+    /**
+     * Compute the ranges of clusters touched by a sphere or box.
+     *
+     * The ranges are conservative per axis, [begin, end) along x, y and z.
+     * @return false if the ranges are empty.
+     */
+    bool get_ranges( const vec4& sphere, index3& begin, index3& end ) const;
+    bool get_ranges( const AABB< T >& aabb, index3& begin, index3& end ) const;
+
+    /** Test a sphere against a single cluster, like FrustumCuller. */
+    Visibility test_sphere( const vec4& sphere, size_t x, size_t y,
+                            size_t z ) const;
+
+private:
+    void _setup_side_planes( size_t axis, T origin, T width );
+    void _transform_planes( size_t axis, const Matrix< 4, 4, T >& m );
+    T _distance( size_t axis, size_t index, const vec3& point ) const;
+    T _extent( size_t axis, size_t index, const vec3& halfSize ) const;
+    bool _get_range( size_t axis, const vec3& center, const vec3& halfSize,
+                     T radius, size_t& begin, size_t& end ) const;
+
+    size_t _size[ 3 ];
+    std::vector< T > _planes[ 3 ];
+    T _near;
+    T _far;
+};
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef FrustumGrid< float >  FrustumGridf;
+typedef FrustumGrid< double > FrustumGridd;
+#endif
+
+} // namespace vmml
+
+// - implementation - //
+
+namespace vmml
+{
+
+template< typename T >
+FrustumGrid< T >::FrustumGrid()
+    : _near( 0 )
+    , _far( 0 )
+{
+    _size[ 0 ] = _size[ 1 ] = _size[ 2 ] = 0;
+}
+
+template< typename T >
+FrustumGrid< T >::FrustumGrid( const Frustum< T >& frustum, const size_t x,
+                               const size_t y, const size_t z,
+                               const Matrix< 4, 4, T >& modelview )
+    : _near( 0 )
+    , _far( 0 )
+{
+    _size[ 0 ] = _size[ 1 ] = _size[ 2 ] = 0;
+    setup( frustum, x, y, z, modelview );
+}
+
+template< typename T >
+void FrustumGrid< T >::setup( const Frustum< T >& frustum, const size_t x,
+                              const size_t y, const size_t z,
+                              const Matrix< 4, 4, T >& modelview )
+{
+    if( x == 0 || y == 0 || z == 0 )
+    {
+        VMMLIB_ERROR( "FrustumGrid - zero clusters along an axis",
+                      VMMLIB_HERE );
+        return;
+    }
+
+    _size[ 0 ] = x;
+    _size[ 1 ] = y;
+    _size[ 2 ] = z;
+    _near = frustum.near_plane();
+    _far = frustum.far_plane();
+
+    for( size_t axis = 0; axis < 3; ++axis )
+        _planes[ axis ].resize( 4 * ( _size[ axis ] + 1 ));
+
+    // view space planes: x and y slices contain the eye point and a line on
+    // the near plane, z slices are at exponential depths
+    _setup_side_planes( 0, frustum.left(), frustum.get_width( ));
+    _setup_side_planes( 1, frustum.bottom(), frustum.get_height( ));
+
+    const size_t n = _size[ 2 ] + 1;
+    T* plane = &_planes[ 2 ][ 0 ];
+    for( size_t i = 0; i < n; ++i )
+    {
+        plane[ i ] = 0;
+        plane[ n + i ] = 0;
+        plane[ 2 * n + i ] = -1;
+        plane[ 3 * n + i ] = -get_slice_depth( i );
+    }
+
+    for( size_t axis = 0; axis < 3; ++axis )
+        _transform_planes( axis, modelview );
+}
+
+template< typename T >
+void FrustumGrid< T >::_setup_side_planes( const size_t axis, const T origin,
+                                           const T width )
+{
+    // the normal is in a for x and in b for y slices
+    const size_t n = _size[ axis ] + 1;
+    T* normal = &_planes[ axis ][ axis * n ];
+    T* zero = &_planes[ axis ][ ( 1 - axis ) * n ];
+    T* c = &_planes[ axis ][ 2 * n ];
+    T* d = &_planes[ axis ][ 3 * n ];
+    const T step = width / T( _size[ axis ] );
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        const T offset = origin + step * T( i );
+        const T scale = 1 / std::sqrt( _near * _near + offset * offset );
+        normal[ i ] = _near * scale;
+        zero[ i ] = 0;
+        c[ i ] = offset * scale;
+        d[ i ] = 0;
+    }
+}
+
+template< typename T >
+void FrustumGrid< T >::_transform_planes( const size_t axis,
+                                          const Matrix< 4, 4, T >& m )
+{
+    // plane' = transpose( m ) * plane
+    const size_t n = _size[ axis ] + 1;
+    T* a = &_planes[ axis ][ 0 ];
+    T* b = a + n;
+    T* c = b + n;
+    T* d = c + n;
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        const T a_ = m( 0, 0 ) * a[i] + m( 1, 0 ) * b[i] + m( 2, 0 ) * c[i];
+        const T b_ = m( 0, 1 ) * a[i] + m( 1, 1 ) * b[i] + m( 2, 1 ) * c[i];
+        const T c_ = m( 0, 2 ) * a[i] + m( 1, 2 ) * b[i] + m( 2, 2 ) * c[i];
+        const T d_ = m( 0, 3 ) * a[i] + m( 1, 3 ) * b[i] + m( 2, 3 ) * c[i] +
+                     d[i];
+        const T scale = 1 / std::sqrt( a_ * a_ + b_ * b_ + c_ * c_ );
+        a[i] = a_ * scale;
+        b[i] = b_ * scale;
+        c[i] = c_ * scale;
+        d[i] = d_ * scale;
+    }
+}
+
+template< typename T >
+T FrustumGrid< T >::get_slice_depth( const size_t slice ) const
+{
+    return _near * std::exp( std::log( _far / _near ) * T( slice ) /
+                             T( _size[ 2 ] ));
+}
+
+template< typename T >
+size_t FrustumGrid< T >::get_slice( const T depth ) const
+{
+    if( depth <= _near )
+        return 0;
+    const T slice = std::log( depth / _near ) / std::log( _far / _near ) *
+                    T( _size[ 2 ] );
+    return std::min( size_t( slice ), _size[ 2 ] - 1 );
+}
+
+template< typename T >
+inline T FrustumGrid< T >::_distance( const size_t axis, const size_t index,
+                                      const vec3& point ) const
+{
+    const size_t n = _size[ axis ] + 1;
+    const T* plane = &_planes[ axis ][ index ];
+    return plane[ 0 ] * point.x() + plane[ n ] * point.y() +
+           plane[ 2 * n ] * point.z() + plane[ 3 * n ];
+}
+
+template< typename T >
+inline T FrustumGrid< T >::_extent( const size_t axis, const size_t index,
+                                    const vec3& halfSize ) const
+{
+    const size_t n = _size[ axis ] + 1;
+    const T* plane = &_planes[ axis ][ index ];
+    return std::abs( plane[ 0 ] ) * halfSize.x() +
+           std::abs( plane[ n ] ) * halfSize.y() +
+           std::abs( plane[ 2 * n ] ) * halfSize.z();
+}
+
+template< typename T >
+bool FrustumGrid< T >::_get_range( const size_t axis, const vec3& center,
+                                   const vec3& halfSize, const T radius,
+                                   size_t& begin, size_t& end ) const
+{
+    // cluster i lies on the positive side of plane i and on the negative side
+    // of plane i + 1
+    begin = _size[ axis ];
+    end = 0;
+    T distance = _distance( axis, 0, center );
+    T extent = _extent( axis, 0, halfSize ) + radius;
+    for( size_t i = 0; i < _size[ axis ]; ++i )
+    {
+        const T nextDistance = _distance( axis, i + 1, center );
+        const T nextExtent = _extent( axis, i + 1, halfSize ) + radius;
+        if( distance + extent >= 0 && nextDistance - nextExtent <= 0 )
+        {
+            begin = std::min( begin, i );
+            end = i + 1;
+        }
+        distance = nextDistance;
+        extent = nextExtent;
+    }
+    return begin < end;
+}
+
+template< typename T >
+bool FrustumGrid< T >::get_ranges( const vec4& sphere, index3& begin,
+                                   index3& end ) const
+{
+    const vec3 center( sphere.x(), sphere.y(), sphere.z( ));
+    for( size_t axis = 0; axis < 3; ++axis )
+        if( !_get_range( axis, center, vec3::ZERO, sphere.w(), begin[ axis ],
+                         end[ axis ] ))
+        {
+            return false;
+        }
+    return true;
+}
+
+template< typename T >
+bool FrustumGrid< T >::get_ranges( const AABB< T >& aabb, index3& begin,
+                                   index3& end ) const
+{
+    const vec3 center = aabb.getCenter();
+    const vec3 halfSize = aabb.getDimension() * T( .5 );
+    for( size_t axis = 0; axis < 3; ++axis )
+        if( !_get_range( axis, center, halfSize, 0, begin[ axis ],
+                         end[ axis ] ))
+        {
+            return false;
+        }
+    return true;
+}
+
+template< typename T >
+Visibility FrustumGrid< T >::test_sphere( const vec4& sphere, const size_t x,
+                                          const size_t y, const size_t z ) const
+{
+    const vec3 center( sphere.x(), sphere.y(), sphere.z( ));
+    const size_t index[ 3 ] = { x, y, z };
+
+    Visibility visibility = VISIBILITY_FULL;
+    for( size_t axis = 0; axis < 3; ++axis )
+    {
+        // distances to the lower and (negated) upper boundary plane
+        const size_t i = index[ axis ];
+        const T distances[ 2 ] = { _distance( axis, i, center ),
+                                   -_distance( axis, i + 1, center ) };
+        for( size_t j = 0; j < 2; ++j )
+        {
+            if( distances[ j ] <= -sphere.w( ))
+                return VISIBILITY_NONE;
+            if( distances[ j ] < sphere.w( ))
+                visibility = VISIBILITY_PARTIAL;
+        }
+    }
+    return visibility;
+}
+
+} // namespace vmml
+
+#endif
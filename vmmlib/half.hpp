@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__HALF__HPP
+#define VMMLIB__HALF__HPP
+
+#include <vmmlib/accumulation_type.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#ifdef __F16C__
+#  include <immintrin.h>
+#endif
+
+// - declaration -
+
+namespace vmml
+{
+
+/**
+ * An IEEE 754 binary16 floating point number for storage.
+ *
+ * Converts implicitly from and to float, so that all arithmetic promotes to
+ * float, and compound assignments round the float result once. Usable as T in
+ * Vector and Matrix to halve the memory of large data, see also
+ * accumulation_type. Conversions round to nearest even, using the F16C
+ * instructions if enabled at compile time, e.g., with -mf16c.
+ */
+class half
+{
+public:
+    half() : _bits( 0 ) {}
+    half( const float value ) : _bits( _from_float( value )) {}
+
+    operator float() const { return _to_float( _bits ); }
+
+    half& operator += ( const float value ) { return *this = *this + value; }
+    half& operator -= ( const float value ) { return *this = *this - value; }
+    half& operator *= ( const float value ) { return *this = *this * value; }
+    half& operator /= ( const float value ) { return *this = *this / value; }
+
+    /** @return the half with the given binary16 bits. */
+    static half from_bits( uint16_t bits );
+    uint16_t get_bits() const { return _bits; }
+
+private:
+    static uint16_t _from_float( float value );
+    static float _to_float( uint16_t bits );
+
+    uint16_t _bits;
+};
+
+/**
+ * A bfloat16 floating point number for storage: the upper half of a float,
+ * with its range but only eight bits of precision.
+ *
+ * Behaves like half, see there.
+ */
+class bfloat16
+{
+public:
+    bfloat16() : _bits( 0 ) {}
+    bfloat16( const float value ) : _bits( _from_float( value )) {}
+
+    operator float() const { return _to_float( _bits ); }
+
+    bfloat16& operator += ( const float value )
+        { return *this = *this + value; }
+    bfloat16& operator -= ( const float value )
+        { return *this = *this - value; }
+    bfloat16& operator *= ( const float value )
+        { return *this = *this * value; }
+    bfloat16& operator /= ( const float value )
+        { return *this = *this / value; }
+
+    /** @return the bfloat16 with the given bits. */
+    static bfloat16 from_bits( uint16_t bits );
+    uint16_t get_bits() const { return _bits; }
+
+private:
+    static uint16_t _from_float( float value );
+    static float _to_float( uint16_t bits );
+
+    uint16_t _bits;
+};
+
+template<> struct accumulation_type< half > { typedef float type; };
+template<> struct accumulation_type< bfloat16 > { typedef float type; };
+
+/**
+ * Convert n values between float and a 16 bit type. The half conversions use
+ * F16C if enabled, the others are loops the compiler vectorizes.
+ */
+inline void convert( const float* in, half* out, size_t n );
+inline void convert( const half* in, float* out, size_t n );
+inline void convert( const float* in, bfloat16* out, size_t n );
+inline void convert( const bfloat16* in, float* out, size_t n );
+
+inline std::ostream& operator << ( std::ostream& os, const half& value )
+    { return os << float( value ); }
+inline std::ostream& operator << ( std::ostream& os, const bfloat16& value )
+    { return os << float( value ); }
+
+inline std::istream& operator >> ( std::istream& is, half& value )
+{
+    float f;
+    if( is >> f )
+        value = f;
+    return is;
+}
+
+inline std::istream& operator >> ( std::istream& is, bfloat16& value )
+{
+    float f;
+    if( is >> f )
+        value = f;
+    return is;
+}
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef Vector< 2, half > Vector2h;
+typedef Vector< 3, half > Vector3h;
+typedef Vector< 4, half > Vector4h;
+typedef Matrix< 3, 3, half > Matrix3h;
+typedef Matrix< 4, 4, half > Matrix4h;
+#endif
+
+} // namespace vmml
+
+namespace std
+{
+template<> class numeric_limits< vmml::half >
+{
+public:
+    static const bool is_specialized = true;
+    static const bool is_signed = true;
+    static const bool is_integer = false;
+    static const bool is_exact = false;
+    static const bool has_infinity = true;
+    static const bool has_quiet_NaN = true;
+    static const bool has_signaling_NaN = true;
+    static const float_denorm_style has_denorm = denorm_present;
+    static const bool has_denorm_loss = false;
+    static const float_round_style round_style = round_to_nearest;
+    static const bool is_iec559 = true;
+    static const bool is_bounded = true;
+    static const bool is_modulo = false;
+    static const int digits = 11;
+    static const int digits10 = 3;
+    static const int max_digits10 = 5;
+    static const int radix = 2;
+    static const int min_exponent = -13;
+    static const int min_exponent10 = -4;
+    static const int max_exponent = 16;
+    static const int max_exponent10 = 4;
+    static const bool traps = false;
+    static const bool tinyness_before = false;
+
+    static vmml::half min() { return vmml::half::from_bits( 0x0400 ); }
+    static vmml::half lowest() { return vmml::half::from_bits( 0xfbff ); }
+    static vmml::half max() { return vmml::half::from_bits( 0x7bff ); }
+    static vmml::half epsilon() { return vmml::half::from_bits( 0x1400 ); }
+    static vmml::half round_error() { return vmml::half::from_bits( 0x3800 ); }
+    static vmml::half infinity() { return vmml::half::from_bits( 0x7c00 ); }
+    static vmml::half quiet_NaN() { return vmml::half::from_bits( 0x7e00 ); }
+    static vmml::half signaling_NaN()
+        { return vmml::half::from_bits( 0x7d00 ); }
+    static vmml::half denorm_min() { return vmml::half::from_bits( 0x0001 ); }
+};
+
+template<> class numeric_limits< vmml::bfloat16 >
+{
+public:
+    static const bool is_specialized = true;
+    static const bool is_signed = true;
+    static const bool is_integer = false;
+    static const bool is_exact = false;
+    static const bool has_infinity = true;
+    static const bool has_quiet_NaN = true;
+    static const bool has_signaling_NaN = true;
+    static const float_denorm_style has_denorm = denorm_present;
+    static const bool has_denorm_loss = false;
+    static const float_round_style round_style = round_to_nearest;
+    static const bool is_iec559 = false;
+    static const bool is_bounded = true;
+    static const bool is_modulo = false;
+    static const int digits = 8;
+    static const int digits10 = 2;
+    static const int max_digits10 = 4;
+    static const int radix = 2;
+    static const int min_exponent = -125;
+    static const int min_exponent10 = -37;
+    static const int max_exponent = 128;
+    static const int max_exponent10 = 38;
+    static const bool traps = false;
+    static const bool tinyness_before = false;
+
+    static vmml::bfloat16 min() { return vmml::bfloat16::from_bits( 0x0080 ); }
+    static vmml::bfloat16 lowest()
+        { return vmml::bfloat16::from_bits( 0xff7f ); }
+    static vmml::bfloat16 max() { return vmml::bfloat16::from_bits( 0x7f7f ); }
+    static vmml::bfloat16 epsilon()
+        { return vmml::bfloat16::from_bits( 0x3c00 ); }
+    static vmml::bfloat16 round_error()
+        { return vmml::bfloat16::from_bits( 0x3f00 ); }
+    static vmml::bfloat16 infinity()
+        { return vmml::bfloat16::from_bits( 0x7f80 ); }
+    static vmml::bfloat16 quiet_NaN()
+        { return vmml::bfloat16::from_bits( 0x7fc0 ); }
+    static vmml::bfloat16 signaling_NaN()
+        { return vmml::bfloat16::from_bits( 0x7fa0 ); }
+    static vmml::bfloat16 denorm_min()
+        { return vmml::bfloat16::from_bits( 0x0001 ); }
+};
+} // namespace std
+
+// - implementation - //
+
+namespace vmml
+{
+
+inline half half::from_bits( const uint16_t bits )
+{
+    half value;
+    value._bits = bits;
+    return value;
+}
+
+inline uint16_t half::_from_float( const float value )
+{
+#ifdef __F16C__
+    return _cvtss_sh( value, _MM_FROUND_TO_NEAREST_INT );
+#else
+    uint32_t f;
+    std::memcpy( &f, &value, sizeof( f ));
+    const uint16_t sign = ( f >> 16 ) & 0x8000;
+    f &= 0x7fffffff;
+
+    if( f >= 0x7f800000 ) // infinity, or NaN keeping its payload quiet
+        return sign | 0x7c00 | ( f > 0x7f800000 ? 0x200 | (( f >> 13 ) & 0x3ff )
+                                                : 0 );
+    if( f >= 0x477ff000 ) // rounds to 65536 or more
+        return sign | 0x7c00;
+    if( f < 0x33000000 ) // rounds to zero
+        return sign;
+
+    if( f < 0x38800000 ) // subnormal, units of 2^-24
+    {
+        const uint32_t shift = 126 - ( f >> 23 );
+        const uint32_t mantissa = ( f & 0x7fffff ) | 0x800000;
+        uint32_t result = mantissa >> shift;
+        const uint32_t rest = mantissa & (( 1u << shift ) - 1 );
+        const uint32_t halfway = 1u << ( shift - 1 );
+        if( rest > halfway || ( rest == halfway && ( result & 1 )))
+            ++result;
+        return uint16_t( sign | result );
+    }
+
+    // rebias the exponent, a carry of the rounding increments it
+    uint32_t result = f - 0x38000000;
+    const uint32_t rest = result & 0x1fff;
+    result >>= 13;
+    if( rest > 0x1000 || ( rest == 0x1000 && ( result & 1 )))
+        ++result;
+    return uint16_t( sign | result );
+#endif
+}
+
+inline float half::_to_float( const uint16_t bits )
+{
+#ifdef __F16C__
+    return _cvtsh_ss( bits );
+#else
+    const uint32_t sign = uint32_t( bits & 0x8000 ) << 16;
+    const uint32_t exponent = ( bits >> 10 ) & 0x1f;
+    uint32_t mantissa = bits & 0x3ff;
+    uint32_t f;
+
+    if( exponent == 0x1f )
+        f = sign | 0x7f800000 | ( mantissa << 13 );
+    else if( exponent > 0 )
+        f = sign | (( exponent + 112 ) << 23 ) | ( mantissa << 13 );
+    else if( mantissa == 0 )
+        f = sign;
+    else // subnormal, normalized for float
+    {
+        uint32_t e = 113;
+        for( ; !( mantissa & 0x400 ); --e )
+            mantissa <<= 1;
+        f = sign | ( e << 23 ) | (( mantissa & 0x3ff ) << 13 );
+    }
+
+    float value;
+    std::memcpy( &value, &f, sizeof( value ));
+    return value;
+#endif
+}
+
+inline bfloat16 bfloat16::from_bits( const uint16_t bits )
+{
+    bfloat16 value;
+    value._bits = bits;
+    return value;
+}
+
+inline uint16_t bfloat16::_from_float( const float value )
+{
+    uint32_t f;
+    std::memcpy( &f, &value, sizeof( f ));
+    if(( f & 0x7fffffff ) > 0x7f800000 ) // keep NaN from rounding to infinity
+        return uint16_t( f >> 16 ) | 0x40;
+
+    // round to nearest even
+    f += 0x7fff + (( f >> 16 ) & 1 );
+    return uint16_t( f >> 16 );
+}
+
+inline float bfloat16::_to_float( const uint16_t bits )
+{
+    const uint32_t f = uint32_t( bits ) << 16;
+    float value;
+    std::memcpy( &value, &f, sizeof( value ));
+    return value;
+}
+
+inline void convert( const float* in, half* out, const size_t n )
+{
+    size_t i = 0;
+#ifdef __F16C__
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m128i packed = _mm_cvtps_ph( _mm_loadu_ps( in + i ),
+                                             _MM_FROUND_TO_NEAREST_INT );
+        _mm_storel_epi64( reinterpret_cast< __m128i* >( out + i ), packed );
+    }
+#endif
+    for( ; i < n; ++i )
+        out[ i ] = in[ i ];
+}
+
+inline void convert( const half* in, float* out, const size_t n )
+{
+    size_t i = 0;
+#ifdef __F16C__
+    for( ; i + 4 <= n; i += 4 )
+        _mm_storeu_ps( out + i, _mm_cvtph_ps( _mm_loadl_epi64(
+                           reinterpret_cast< const __m128i* >( in + i ))));
+#endif
+    for( ; i < n; ++i )
+        out[ i ] = in[ i ];
+}
+
+inline void convert( const float* in, bfloat16* out, const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+        out[ i ] = in[ i ];
+}
+
+inline void convert( const bfloat16* in, float* out, const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+        out[ i ] = in[ i ];
+}
+
+} // namespace vmml
+
+#endif // include protection
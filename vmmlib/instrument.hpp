@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__INSTRUMENT__HPP
+#define VMMLIB__INSTRUMENT__HPP
+
+/**
+ * Optional instrumentation of the heavy vmmlib operations.
+ *
+ * Define VMMLIB_INSTRUMENT before including any vmmlib header to mark batch
+ * culling, large matrix products, decompositions and file I/O as regions.
+ * Entering and leaving a region calls the installed Backend: the default does
+ * nothing, CounterBackend counts calls and time per region, and IttBackend,
+ * available with VMMLIB_INSTRUMENT_ITT and ittnotify.h, emits ITT tasks for
+ * VTune. Without VMMLIB_INSTRUMENT, the markers compile to nothing.
+ */
+
+#ifdef VMMLIB_INSTRUMENT
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+#ifdef VMMLIB_INSTRUMENT_ITT
+#  ifdef __GNUC__ // warnings in the inline functions of ittnotify.h
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wattributes"
+#    pragma GCC diagnostic ignored "-Wunused-function"
+#  endif
+#  include <ittnotify.h>
+#  ifdef __GNUC__
+#    pragma GCC diagnostic pop
+#  endif
+#endif
+
+namespace vmml
+{
+namespace instrument
+{
+
+/**
+ * A named instrumentation point. Regions are static objects created by
+ * VMMLIB_INSTRUMENT_SCOPE, one per call site and template instantiation,
+ * and registered in a global list.
+ */
+class Region
+{
+public:
+    explicit Region( const char* name )
+        : _name( name ), _count( 0 ), _nanoseconds( 0 ), _handle( 0 )
+        , _next( _get_head().load( ))
+    {
+        while( !_get_head().compare_exchange_weak( _next, this ))
+            ;
+    }
+
+    const char* get_name() const { return _name; }
+
+    /** @return the number of calls, as counted by CounterBackend. */
+    uint64_t get_count() const { return _count.load(); }
+
+    /** @return the total time in ns, as measured by CounterBackend. */
+    uint64_t get_nanoseconds() const { return _nanoseconds.load(); }
+
+    void add( const uint64_t nanoseconds )
+    {
+        _count.fetch_add( 1, std::memory_order_relaxed );
+        _nanoseconds.fetch_add( nanoseconds, std::memory_order_relaxed );
+    }
+
+    void reset() { _count = 0; _nanoseconds = 0; }
+
+    /** Backend-specific data, e.g., the ITT string handle. */
+    void* get_handle() const { return _handle.load(); }
+    void set_handle( void* handle ) { _handle = handle; }
+
+    /** @return the first of all regions created so far. */
+    static Region* get_first() { return _get_head().load(); }
+    Region* get_next() const { return _next; }
+
+private:
+    static std::atomic< Region* >& _get_head()
+    {
+        static std::atomic< Region* > head( 0 );
+        return head;
+    }
+
+    const char* const _name;
+    std::atomic< uint64_t > _count;
+    std::atomic< uint64_t > _nanoseconds;
+    std::atomic< void* > _handle;
+    Region* _next;
+};
+
+/** Receives the region markers, must be thread-safe. */
+class Backend
+{
+public:
+    virtual ~Backend() {}
+
+    /** @return a token passed to end(), e.g., a time stamp. */
+    virtual uint64_t begin( Region& region ) = 0;
+    virtual void end( Region& region, uint64_t token ) = 0;
+};
+
+/** The default backend, ignoring all regions. */
+class NullBackend : public Backend
+{
+public:
+    uint64_t begin( Region& ) final { return 0; }
+    void end( Region&, uint64_t ) final {}
+};
+
+/** Counts the calls and accumulates the time spent in each region. */
+class CounterBackend : public Backend
+{
+public:
+    uint64_t begin( Region& ) final { return _now(); }
+    void end( Region& region, const uint64_t begin ) final
+        { region.add( _now() - begin ); }
+
+    /** Reset the counters of all regions. */
+    static void reset()
+    {
+        for( Region* region = Region::get_first(); region;
+             region = region->get_next( ))
+        {
+            region->reset();
+        }
+    }
+
+    /** Print the counters of all called regions. */
+    static void print( std::ostream& os )
+    {
+        for( Region* region = Region::get_first(); region;
+             region = region->get_next( ))
+        {
+            if( region->get_count() == 0 )
+                continue;
+            os << std::left << std::setw( 40 ) << region->get_name()
+               << std::right << std::setw( 12 ) << region->get_count()
+               << " calls" << std::setw( 14 )
+               << region->get_nanoseconds() / 1000 << " us" << std::endl;
+        }
+    }
+
+private:
+    static uint64_t _now()
+    {
+        return std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::steady_clock::now().time_since_epoch( )).count();
+    }
+};
+
+#ifdef VMMLIB_INSTRUMENT_ITT
+/** Emits an ITT task per region in the "vmmlib" domain. */
+class IttBackend : public Backend
+{
+public:
+    IttBackend() : _domain( __itt_domain_create( "vmmlib" )) {}
+
+    uint64_t begin( Region& region ) final
+    {
+        __itt_string_handle* handle =
+            static_cast< __itt_string_handle* >( region.get_handle( ));
+        if( !handle )
+        {
+            // concurrent creation returns the same handle for the same name
+            handle = __itt_string_handle_create( region.get_name( ));
+            region.set_handle( handle );
+        }
+        __itt_task_begin( _domain, __itt_null, __itt_null, handle );
+        return 0;
+    }
+
+    void end( Region&, uint64_t ) final { __itt_task_end( _domain ); }
+
+private:
+    __itt_domain* const _domain;
+};
+#endif
+
+inline NullBackend& get_null_backend()
+{
+    static NullBackend backend;
+    return backend;
+}
+
+inline std::atomic< Backend* >& _get_backend()
+{
+    static std::atomic< Backend* > backend( &get_null_backend( ));
+    return backend;
+}
+
+inline Backend& get_backend() { return *_get_backend().load(); }
+
+/**
+ * Install a backend, or the default one if 0. The backend must stay valid
+ * until all regions entered with it have been left.
+ */
+inline void set_backend( Backend* backend )
+{
+    _get_backend() = backend ? backend : &get_null_backend();
+}
+
+/** Marks the lifetime of the scope as the given region, if not 0. */
+class Scope
+{
+public:
+    explicit Scope( Region* region )
+        : _region( region ), _backend( get_backend( ))
+        , _token( region ? _backend.begin( *region ) : 0 )
+    {}
+
+    ~Scope()
+    {
+        if( _region )
+            _backend.end( *_region, _token );
+    }
+
+private:
+    Scope( const Scope& ) = delete;
+    Scope& operator=( const Scope& ) = delete;
+
+    Region* const _region;
+    Backend& _backend;
+    const uint64_t _token;
+};
+
+} // namespace instrument
+} // namespace vmml
+
+/** Mark the rest of the enclosing scope as the region name. */
+#define VMMLIB_INSTRUMENT_SCOPE( name ) \
+    VMMLIB_INSTRUMENT_SCOPE_IF( true, name )
+
+/** Mark the rest of the enclosing scope as region name if condition holds. */
+#define VMMLIB_INSTRUMENT_SCOPE_IF( condition, name )                        \
+    static ::vmml::instrument::Region _vmmlib_region( name );                 \
+    const ::vmml::instrument::Scope _vmmlib_scope(( condition ) ?             \
+                                                  &_vmmlib_region : 0 )
+
+#else
+
+#define VMMLIB_INSTRUMENT_SCOPE( name )
+#define VMMLIB_INSTRUMENT_SCOPE_IF( condition, name )
+
+#endif // VMMLIB_INSTRUMENT
+
+#endif // include protection
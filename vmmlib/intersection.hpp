@@ -40,8 +40,12 @@
 #ifndef VMMLIB__INTERSECTION__HPP
 #define VMMLIB__INTERSECTION__HPP
 
+#include <vmmlib/aabb.hpp>
 #include <vmmlib/vector.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace vmml
 {
 template< typename T > class Intersection
@@ -74,6 +78,17 @@ public:
      */
     bool test_sphere( const vec4& sphere, T& t ) const;
 
+    /**
+      Ray AABB Intersection - Slab method
+
+      @param[in]    aabb        Axis-aligned box
+      @param[out]   t           Intersection distance, the exit distance if
+                                the ray origin is inside the box
+
+      @return Whether the ray intersects the box
+     */
+    bool test_aabb( const AABB< T >& aabb, T& t ) const;
+
 private:
     const vec3 _origin;
     const vec3 _direction;
@@ -115,6 +130,33 @@ Intersection< T >::test_sphere( const vec4& sphere, T& t ) const
     return true;
 }
 
+template< typename T >
+bool
+Intersection< T >::test_aabb( const AABB< T >& aabb, T& t ) const
+{
+    T tNear = -std::numeric_limits< T >::max();
+    T tFar = std::numeric_limits< T >::max();
+
+    /** Intersect the ray with the pair of planes bounding each axis */
+    for( size_t i = 0; i < 3; ++i )
+    {
+        const T invDirection = T( 1 ) / _direction[ i ];
+        T t0 = ( aabb.getMin()[ i ] - _origin[ i ] ) * invDirection;
+        T t1 = ( aabb.getMax()[ i ] - _origin[ i ] ) * invDirection;
+        if( t0 > t1 )
+            std::swap( t0, t1 );
+
+        tNear = std::max( tNear, t0 );
+        tFar = std::min( tFar, t1 );
+    }
+
+    if( tNear > tFar || tFar < 0 )
+        return false;
+
+    t = tNear >= 0 ? tNear : tFar;
+    return true;
+}
+
 #ifdef VMMLIB_OLD_TYPEDEFS
 template< typename T >
 using intersection = Intersection<T>;
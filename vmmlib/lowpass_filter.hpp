@@ -41,18 +41,40 @@
 
 #include <vmmlib/vmmlib_config.hpp>
 
-#include <deque>
+#include <cstddef>
 
 namespace vmml
 {
+
+enum LowpassMode
+{
+    /**
+     * Recompute the output from the last M samples, weighting the k-th
+     * previous sample by the smooth factor to the power of k. O(M) per sample.
+     */
+    LOWPASS_WINDOW,
+
+    /**
+     * Blend each sample into the previous output, weighted by one minus the
+     * smooth factor. O(1) per sample, independent of M.
+     */
+    LOWPASS_EXPONENTIAL
+};
+
+/**
+ * Smooths a stream of values. The last M samples are kept in a fixed-size
+ * ring buffer, so adding values does not allocate.
+ */
 template< size_t M, typename T > class LowpassFilter
 {
 public:
     /**
       Constructor
       @param[in]    F   Smooth factor to use during the filter process
+      @param[in]    mode    Update formula, see LowpassMode
      */
-    LowpassFilter( const float F ) : _smooth_factor(F) {}
+    LowpassFilter( const float F, const LowpassMode mode = LOWPASS_WINDOW )
+        : _smooth_factor(F), _mode( mode ), _head( 0 ), _size( 0 ) {}
     ~LowpassFilter() {}
 
     /**
@@ -80,28 +102,48 @@ public:
      */
     void set_smooth_factor( const float& f );
 
+    /** @return the update formula. */
+    LowpassMode get_mode() const { return _mode; }
+
+    /** @return the number of samples in the window, at most M. */
+    size_t size() const { return _size; }
+
+    /** Forget all samples, the next one is passed through unfiltered. */
+    void reset() { _head = 0; _size = 0; }
+
 private:
-    std::deque< T > _data;
+    T _data[ M ]; // ring buffer, newest sample at _head
     float _smooth_factor;
+    LowpassMode _mode;
+    size_t _head;
+    size_t _size;
     T _value;
 };
 
 
 template< size_t M, typename T > T LowpassFilter< M, T >::add( const T& value )
 {
-    _data.push_front( value );
+    if( _mode == LOWPASS_EXPONENTIAL )
+    {
+        _value = _size == 0 ? value :
+                     _value * _smooth_factor + value * ( 1 - _smooth_factor );
+        _size = 1;
+        return _value;
+    }
 
-    while( _data.size() > M )
-        _data.pop_back();
+    _head = _head == 0 ? M - 1 : _head - 1;
+    _data[ _head ] = value;
+    if( _size < M )
+        ++_size;
 
-    // update
-    typename std::deque< T >::const_iterator i = _data.begin();
-    _value = *i;
+    // update, from the newest to the oldest sample
+    _value = value;
     double weight = _smooth_factor;
 
-    for( ++i ; i != _data.end(); ++i )
+    for( size_t i = 1; i < _size; ++i )
     {
-        _value = _value * (1 - weight) + (*i) * weight;
+        const T& sample = _data[( _head + i ) % M ];
+        _value = _value * (1 - weight) + sample * weight;
         weight *= _smooth_factor;
     }
 
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__LOWPASS_FILTER_BANK__HPP
+#define VMMLIB__LOWPASS_FILTER_BANK__HPP
+
+#include <vmmlib/vmmlib_config.hpp>
+#include <vmmlib/instrument.hpp>
+#include <vmmlib/lowpass_filter.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// - declaration - //
+
+namespace vmml
+{
+
+/**
+ * A bank of LowpassFilters over scalar channels, filtered in lockstep.
+ *
+ * Each call to add() takes one frame with a sample for every channel. The
+ * state is kept in structure-of-arrays layout, one contiguous row of channels
+ * per window slot, so that the filter is a sequence of element-wise loops over
+ * the channels which the compiler vectorizes. A Vector< 3, T > stream maps to
+ * three consecutive channels.
+ *
+ * Each channel computes the same output as a LowpassFilter< M, T > with the
+ * same smooth factor and mode, up to floating point rounding.
+ */
+template< size_t M, typename T > class LowpassFilterBank
+{
+public:
+    /**
+     * Create a bank of n_channels filters sharing the smooth factor F.
+     */
+    LowpassFilterBank( size_t n_channels, T F,
+                       LowpassMode mode = LOWPASS_WINDOW );
+
+    size_t get_num_channels() const { return _values.size(); }
+    LowpassMode get_mode() const { return _mode; }
+
+    /** @return the number of frames in the window, at most M. */
+    size_t size() const { return _size; }
+
+    /** Set the smooth factor of all channels. */
+    void set_smooth_factor( T f );
+
+    /** Set the smooth factor of one channel. */
+    void set_smooth_factor( size_t channel, T f );
+
+    T get_smooth_factor( size_t channel ) const { return _factors[ channel ]; }
+
+    /**
+     * Add one frame of get_num_channels() samples.
+     * @return the filtered output of all channels
+     */
+    const T* add( const T* samples );
+
+    /**
+     * Add n_frames frames of get_num_channels() samples each, stored one
+     * after the other.
+     * @return the filtered output of all channels after the last frame
+     */
+    const T* add( const T* frames, size_t n_frames );
+
+    /** @return the filtered output of all channels. */
+    const T* get() const { return _values.data(); }
+
+    /** @return the filtered output of one channel. */
+    T get( size_t channel ) const { return _values[ channel ]; }
+
+    /** Forget all frames, the next one is passed through unfiltered. */
+    void reset() { _head = 0; _size = 0; }
+
+private:
+    void _set_powers( size_t channel );
+
+    static void _blend( T* VMMLIB_RESTRICT values,
+                        const T* VMMLIB_RESTRICT samples,
+                        const T* VMMLIB_RESTRICT weights, size_t n );
+    static void _smooth( T* VMMLIB_RESTRICT values,
+                         const T* VMMLIB_RESTRICT samples,
+                         const T* VMMLIB_RESTRICT factors, size_t n );
+
+    LowpassMode _mode;
+    size_t _head;
+    size_t _size;
+    std::vector< T > _factors;
+    std::vector< T > _powers; // factor^i of all channels for window slot i
+    std::vector< T > _data;   // ring buffer of frames, newest at _head
+    std::vector< T > _values;
+};
+
+// - implementation - //
+
+template< size_t M, typename T >
+LowpassFilterBank< M, T >::LowpassFilterBank( const size_t n_channels,
+                                              const T F,
+                                              const LowpassMode mode )
+    : _mode( mode )
+    , _head( 0 )
+    , _size( 0 )
+    , _factors( n_channels, F )
+    , _powers( M * n_channels )
+    , _data( M * n_channels )
+    , _values( n_channels )
+{
+    for( size_t i = 0; i < n_channels; ++i )
+        _set_powers( i );
+}
+
+template< size_t M, typename T >
+void LowpassFilterBank< M, T >::set_smooth_factor( const T f )
+{
+    std::fill( _factors.begin(), _factors.end(), f );
+    for( size_t i = 0; i < _factors.size(); ++i )
+        _set_powers( i );
+}
+
+template< size_t M, typename T >
+void LowpassFilterBank< M, T >::set_smooth_factor( const size_t channel,
+                                                   const T f )
+{
+    _factors[ channel ] = f;
+    _set_powers( channel );
+}
+
+template< size_t M, typename T >
+void LowpassFilterBank< M, T >::_set_powers( const size_t channel )
+{
+    const size_t n = _factors.size();
+    T power = 1;
+    for( size_t i = 0; i < M; ++i )
+    {
+        _powers[ i * n + channel ] = power;
+        power *= _factors[ channel ];
+    }
+}
+
+template< size_t M, typename T >
+const T* LowpassFilterBank< M, T >::add( const T* samples )
+{
+    const size_t n = _values.size();
+    if( _mode == LOWPASS_EXPONENTIAL )
+    {
+        if( _size == 0 )
+            std::copy( samples, samples + n, _values.begin( ));
+        else
+            _smooth( _values.data(), samples, _factors.data(), n );
+        _size = 1;
+        return _values.data();
+    }
+
+    _head = _head == 0 ? M - 1 : _head - 1;
+    std::copy( samples, samples + n, _data.begin() + _head * n );
+    if( _size < M )
+        ++_size;
+
+    // update, from the newest to the oldest frame
+    std::copy( samples, samples + n, _values.begin( ));
+    for( size_t i = 1; i < _size; ++i )
+        _blend( _values.data(), &_data[(( _head + i ) % M ) * n ],
+                &_powers[ i * n ], n );
+
+    return _values.data();
+}
+
+template< size_t M, typename T >
+const T* LowpassFilterBank< M, T >::add( const T* frames,
+                                         const size_t n_frames )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "LowpassFilterBank::add" );
+    const size_t n = _values.size();
+    for( size_t i = 0; i < n_frames; ++i )
+        add( frames + i * n );
+    return _values.data();
+}
+
+template< size_t M, typename T >
+void LowpassFilterBank< M, T >::_blend( T* VMMLIB_RESTRICT values,
+                                        const T* VMMLIB_RESTRICT samples,
+                                        const T* VMMLIB_RESTRICT weights,
+                                        const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+        values[ i ] = values[ i ] * ( 1 - weights[ i ] ) +
+                      samples[ i ] * weights[ i ];
+}
+
+template< size_t M, typename T >
+void LowpassFilterBank< M, T >::_smooth( T* VMMLIB_RESTRICT values,
+                                         const T* VMMLIB_RESTRICT samples,
+                                         const T* VMMLIB_RESTRICT factors,
+                                         const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+        values[ i ] = values[ i ] * factors[ i ] +
+                      samples[ i ] * ( 1 - factors[ i ] );
+}
+
+} // namespace vmml
+
+#endif // include protection
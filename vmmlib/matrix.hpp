@@ -39,6 +39,8 @@
 #include <vmmlib/math.hpp>
 #include <vmmlib/exception.hpp>
 #include <vmmlib/enable_if.hpp>
+#include <vmmlib/execution.hpp>
+#include <vmmlib/instrument.hpp>
 
 #include <iostream>
 #include <iomanip>
@@ -113,10 +115,26 @@ public:
     // (this) matrix = left matrix_mxp * right matrix_pxn
     template< size_t P > void multiply( const Matrix< M, P, T >& left,
                                         const Matrix< P, N, T >& right );
+    // same, computing ranges of columns as given by the execution policy
+    template< size_t P > void multiply( const Matrix< M, P, T >& left,
+                                        const Matrix< P, N, T >& right,
+                                        const ExecutionPolicy& policy );
+    // same, accumulating in A, see accumulation_type
+    template< typename A, size_t P >
+    void multiply( const Matrix< M, P, T >& left,
+                   const Matrix< P, N, T >& right,
+                   const ExecutionPolicy& policy = ExecutionPolicy( ));
 
     // convolution operation (extending borders) of (this) matrix and the given kernel
     template< size_t U, size_t V >
     void convolve(const Matrix< U, V, T >& kernel);
+    template< size_t U, size_t V >
+    void convolve( const Matrix< U, V, T >& kernel,
+                   const ExecutionPolicy& policy );
+    // same, accumulating in A instead of double
+    template< typename A, size_t U, size_t V >
+    void convolve( const Matrix< U, V, T >& kernel,
+                   const ExecutionPolicy& policy = ExecutionPolicy( ));
 
     // returned matrix_mxp = (this) matrix * other matrix_nxp;
     // note: using multiply(...) it avoids a copy of the resulting matrix
@@ -232,6 +250,12 @@ public:
     void zero();
 
     double frobenius_norm() const;
+    // deterministic for any execution policy, but summed in chunks unlike
+    // frobenius_norm()
+    double frobenius_norm( const ExecutionPolicy& policy ) const;
+    // same, accumulating in A instead of double
+    template< typename A >
+    A frobenius_norm( const ExecutionPolicy& policy = ExecutionPolicy( )) const;
     double p_norm( double p ) const;
 
     template< typename TT >
@@ -253,6 +277,11 @@ public:
 
     void columnwise_sum( Vector< N, T>& summed_columns_ ) const;
     double sum_elements() const;
+    // deterministic for any execution policy, see frobenius_norm( policy )
+    double sum_elements( const ExecutionPolicy& policy ) const;
+    // same, accumulating in A instead of double
+    template< typename A >
+    A sum_elements( const ExecutionPolicy& policy = ExecutionPolicy( )) const;
 
     void sum_rows( Matrix< M/2, N, T>& other ) const;
     void sum_columns( Matrix< M, N/2, T>& other ) const;
@@ -268,6 +297,10 @@ public:
     //Kronecker Product: MxN x_kronecker OxP = M*OxN*P
     template< size_t O, size_t P >
     void kronecker_product( const Matrix< O, P, T >& right_,  Matrix< M*O, N*P, T >& result_) const;
+    template< size_t O, size_t P >
+    void kronecker_product( const Matrix< O, P, T >& right_,
+                            Matrix< M*O, N*P, T >& result_,
+                            const ExecutionPolicy& policy ) const;
 
     T get_min() const;
     T get_max() const;
@@ -526,14 +559,32 @@ inline void multiply( const Matrix< M, N, T >& left,
 template< size_t M, size_t N, typename T >
 template< size_t U, size_t V >
 void Matrix< M, N, T>::convolve(const Matrix< U, V, T >& kernel)
+{
+    convolve( kernel, ExecutionPolicy::sequential( ));
+}
+
+template< size_t M, size_t N, typename T >
+template< size_t U, size_t V >
+void Matrix< M, N, T>::convolve( const Matrix< U, V, T >& kernel,
+                                 const ExecutionPolicy& policy )
+{
+    convolve< double >( kernel, policy );
+}
+
+template< size_t M, size_t N, typename T >
+template< typename A, size_t U, size_t V >
+void Matrix< M, N, T>::convolve( const Matrix< U, V, T >& kernel,
+                                 const ExecutionPolicy& policy )
 {
     Matrix< M, N, T> temp;  // do not override original values instantly as old values are needed for calculation
 
-    for(size_t y_ = 0; y_ < N; ++y_)
+    parallel_for( policy, N, [&]( const size_t begin, const size_t end )
+    {
+    for(size_t y_ = begin; y_ < end; ++y_)
     {
         for(size_t x_ = 0; x_ < M; ++x_)
         {
-            double sum = 0.0;
+            A sum = A( 0 );
 
             for(size_t j = 0; j < V; ++j)
             {
@@ -551,12 +602,13 @@ void Matrix< M, N, T>::convolve(const Matrix< U, V, T >& kernel)
                     if(srcx < 0)       srcx = 0;
                     if(srcx >= int(M)) srcx = M-1;
 
-                    sum += kernel.at(j,i) * at(srcy,srcx);
+                    sum += A( kernel.at(j,i) ) * A( at(srcy,srcx) );
                 }
             }
-            temp.at(y_,x_) = sum;
+            temp.at(y_,x_) = T( sum );
         }
     }
+    }, M * U * V );
 
     *this = temp;
 }
@@ -1049,6 +1101,7 @@ Matrix< M, N, T >::multiply(
     const Matrix< P, N, T >& right
     )
 {
+    VMMLIB_INSTRUMENT_SCOPE_IF( M * N * P >= 512, "Matrix::multiply" );
     for( size_t row_index = 0; row_index < M; row_index++)
     {
         for( size_t col_index = 0; col_index < N; col_index++)
@@ -1065,6 +1118,56 @@ Matrix< M, N, T >::multiply(
 
 
 
+template< size_t M, size_t N, typename T >
+template< size_t P >
+void
+Matrix< M, N, T >::multiply(
+    const Matrix< M, P, T >& left,
+    const Matrix< P, N, T >& right,
+    const ExecutionPolicy& policy
+    )
+{
+    multiply< T >( left, right, policy );
+}
+
+
+
+template< size_t M, size_t N, typename T >
+template< typename A, size_t P >
+void
+Matrix< M, N, T >::multiply(
+    const Matrix< M, P, T >& left,
+    const Matrix< P, N, T >& right,
+    const ExecutionPolicy& policy
+    )
+{
+    VMMLIB_INSTRUMENT_SCOPE_IF( M * N * P >= 512, "Matrix::multiply" );
+    parallel_for( policy, N, [&]( const size_t begin, const size_t end )
+    {
+        A column[ M ];
+        for( size_t col_index = begin; col_index < end; ++col_index )
+        {
+            for( size_t row_index = 0; row_index < M; ++row_index )
+                column[ row_index ] = A( 0 );
+
+            for( size_t p = 0; p < P; ++p )
+            {
+                const T* leftColumn = left.array + p * M;
+                const A factor( right.array[ col_index * P + p ] );
+                for( size_t row_index = 0; row_index < M; ++row_index )
+                    column[ row_index ] += A( leftColumn[ row_index ] ) *
+                                           factor;
+            }
+
+            T* result = array + col_index * M;
+            for( size_t row_index = 0; row_index < M; ++row_index )
+                result[ row_index ] = T( column[ row_index ] );
+        }
+    }, M * P );
+}
+
+
+
 template< size_t M, size_t N, typename T >
 template< size_t P >
 Matrix< M, P, T >
@@ -2259,6 +2362,30 @@ Matrix< M, N, T >::frobenius_norm( ) const
     return std::sqrt(norm);
 }
 
+template< size_t M, size_t N, typename T >
+double
+Matrix< M, N, T >::frobenius_norm( const ExecutionPolicy& policy ) const
+{
+    return frobenius_norm< double >( policy );
+}
+
+template< size_t M, size_t N, typename T >
+template< typename A >
+A
+Matrix< M, N, T >::frobenius_norm( const ExecutionPolicy& policy ) const
+{
+    const A norm = parallel_reduce( policy, M * N, A( 0 ),
+        [&]( const size_t begin, const size_t end )
+        {
+            A sum = A( 0 );
+            for( size_t i = begin; i < end; ++i )
+                sum += A( array[ i ] ) * A( array[ i ] );
+            return sum;
+        },
+        []( const A a, const A b ) { return a + b; });
+    return std::sqrt( norm );
+}
+
 template< size_t M, size_t N, typename T >
 double
 Matrix< M, N, T >::p_norm( double p ) const
@@ -2298,8 +2425,20 @@ template< size_t O, size_t P >
 void
 Matrix< M, N, T >::kronecker_product( const Matrix< O, P, T >& right_, Matrix< M*O, N*P, T >& result_ ) const
 {
-    //build product for every column
-    for (size_t m = 0; m < M; ++m )
+    kronecker_product( right_, result_, ExecutionPolicy::sequential( ));
+}
+
+template< size_t M, size_t N, typename T  >
+template< size_t O, size_t P >
+void
+Matrix< M, N, T >::kronecker_product( const Matrix< O, P, T >& right_,
+                                      Matrix< M*O, N*P, T >& result_,
+                                      const ExecutionPolicy& policy ) const
+{
+    //build product for every column, in ranges of rows of this matrix
+    parallel_for( policy, M, [&]( const size_t begin, const size_t end )
+    {
+    for (size_t m = begin; m < end; ++m )
     {
         for ( size_t n = 0; n < N; ++n )
         {
@@ -2312,6 +2451,7 @@ Matrix< M, N, T >::kronecker_product( const Matrix< O, P, T >& right_, Matrix< M
             }
         }
     }
+    }, N * O * P );
 }
 
 
@@ -2549,6 +2689,29 @@ Matrix< M, N, T >::sum_elements( ) const
     return sum;
 }
 
+template< size_t M, size_t N, typename T >
+double
+Matrix< M, N, T >::sum_elements( const ExecutionPolicy& policy ) const
+{
+    return sum_elements< double >( policy );
+}
+
+template< size_t M, size_t N, typename T >
+template< typename A >
+A
+Matrix< M, N, T >::sum_elements( const ExecutionPolicy& policy ) const
+{
+    return parallel_reduce( policy, M * N, A( 0 ),
+        [&]( const size_t begin, const size_t end )
+        {
+            A sum = A( 0 );
+            for( size_t i = begin; i < end; ++i )
+                sum += A( array[ i ] );
+            return sum;
+        },
+        []( const A a, const A b ) { return a + b; });
+}
+
 template< size_t M, size_t N, typename T >
 template< size_t R>
 typename enable_if< R == M && R == N>::type*
@@ -2608,6 +2771,7 @@ template< size_t M, size_t N, typename T >
 void
 Matrix< M, N, T >::write_to_raw( const std::string& dir_, const std::string& filename_ ) const
 {
+    VMMLIB_INSTRUMENT_SCOPE( "Matrix::write_to_raw" );
     int dir_length = dir_.size() -1;
     int last_separator = dir_.find_last_of( "/");
     std::string path = dir_;
@@ -2638,6 +2802,7 @@ template< size_t M, size_t N, typename T >
 void
 Matrix< M, N, T >::read_from_raw( const std::string& dir_, const std::string& filename_ )
 {
+    VMMLIB_INSTRUMENT_SCOPE( "Matrix::read_from_raw" );
     int dir_length = dir_.size() -1;
     int last_separator = dir_.find_last_of( "/");
     std::string path = dir_;
@@ -2686,6 +2851,7 @@ template< size_t M, size_t N, typename T >
 void
 Matrix< M, N, T >::write_csv_file( const std::string& dir_, const std::string& filename_ ) const
 {
+    VMMLIB_INSTRUMENT_SCOPE( "Matrix::write_csv_file" );
     int dir_length = dir_.size() -1;
     int last_separator = dir_.find_last_of( "/");
     std::string path = dir_;
@@ -2715,6 +2881,7 @@ template< size_t M, size_t N, typename T >
 void
 Matrix< M, N, T >::read_csv_file( const std::string& dir_, const std::string& filename_ )
 {
+    VMMLIB_INSTRUMENT_SCOPE( "Matrix::read_csv_file" );
     int dir_length = dir_.size() -1;
     int last_separator = dir_.find_last_of( "/");
     std::string path = dir_;
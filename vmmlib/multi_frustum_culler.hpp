@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__MULTI_FRUSTUM_CULLER__HPP
+#define VMMLIB__MULTI_FRUSTUM_CULLER__HPP
+
+#include <vmmlib/aabb.hpp>
+#include <vmmlib/culling_statistics.hpp>
+#include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/instrument.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// - declaration -
+
+namespace vmml
+{
+
+/**
+ * Frustum culling against up to 64 views in one pass.
+ *
+ * The planes of all K frusta are stored as structure of arrays, so that a
+ * primitive is tested against all views in loops over K which the compiler
+ * vectorizes. The results are bit masks with bit i set for view i: one mask
+ * of the views seeing the primitive at all, and optionally one of the views
+ * seeing it fully. Per view, the results are the same as of a FrustumCuller
+ * set up with the same matrix.
+ */
+template< typename T, size_t K >
+class MultiFrustumCuller
+{
+public:
+    typedef Vector< 3, T >    vec3;
+    typedef Vector< 4, T >    vec4;
+
+    MultiFrustumCuller();
+
+    /** Set up one view using its 4x4 projection*modelView matrix. */
+    void setup( size_t view, const Matrix< 4, 4, T >& proj_modelview );
+
+    /**
+     * Test a sphere against all views.
+     * @param full optional output of the mask of fully visible views
+     * @return the mask of (partially or fully) visible views
+     */
+    uint64_t test_sphere( const vec4& sphere, uint64_t* full = 0 ) const;
+
+    /** Test an AABB against all views, like test_sphere(). */
+    uint64_t test_aabb( const AABB< T >& aabb, uint64_t* full = 0 ) const;
+
+    /**
+     * Test n spheres, writing the masks of visible and, optionally, fully
+     * visible views to visible and full.
+     */
+    void test_spheres( const vec4* spheres, size_t n, uint64_t* visible,
+                       uint64_t* full = 0 ) const;
+
+    /** Test n AABBs like test_spheres(). */
+    void test_aabbs( const AABB< T >* aabbs, size_t n, uint64_t* visible,
+                     uint64_t* full = 0 ) const;
+
+    /** @return the visibility in one view from the result masks. */
+    static Visibility get_visibility( uint64_t visible, uint64_t full,
+                                      size_t view );
+
+    /**
+     * Set the statistics counting the batch tests, or 0 to disable counting.
+     * Each primitive counts as tested once per view, with six plane tests.
+     */
+    void set_statistics( CullingStatistics* statistics )
+        { _statistics = statistics; }
+
+    /** @return the statistics counting the batch tests, or 0. */
+    CullingStatistics* get_statistics() const { return _statistics; }
+
+    static const size_t NUM_VIEWS = K;
+
+private:
+    static_assert( K > 0 && K <= 64, "MultiFrustumCuller supports 1 to 64 "
+                   "views" );
+
+    static uint64_t _get_mask( const T* values, T threshold, bool inclusive );
+    static size_t _count_bits( uint64_t mask );
+    static void _count( CullingStatistics::Pass& pass, uint64_t visible,
+                        uint64_t full );
+
+    // _planes[ plane ][ coefficient ][ view ], planes in FrustumCuller order
+    T _planes[ 6 ][ 4 ][ K ];
+
+    CullingStatistics* _statistics;
+};
+
+// - implementation - //
+
+template< typename T, size_t K >
+MultiFrustumCuller< T, K >::MultiFrustumCuller()
+    : _statistics( 0 )
+{
+    // planes accepting everything until set up
+    for( size_t i = 0; i < 6; ++i )
+        for( size_t k = 0; k < K; ++k )
+        {
+            _planes[ i ][ 0 ][ k ] = 0;
+            _planes[ i ][ 1 ][ k ] = 0;
+            _planes[ i ][ 2 ][ k ] = 0;
+            _planes[ i ][ 3 ][ k ] = std::numeric_limits< T >::max();
+        }
+}
+
+template< typename T, size_t K >
+void MultiFrustumCuller< T, K >::setup( const size_t view,
+                                        const Matrix< 4, 4, T >& matrix )
+{
+    // same plane extraction as in FrustumCuller::setup()
+    const vec4 row0 = matrix.get_row( 0 );
+    const vec4 row1 = matrix.get_row( 1 );
+    const vec4 row2 = matrix.get_row( 2 );
+    const vec4 row3 = matrix.get_row( 3 );
+    const vec4 planes[ 6 ] = { row3 + row0, row3 - row0, row3 + row1,
+                               row3 - row1, row3 + row2, row3 - row2 };
+
+    for( size_t i = 0; i < 6; ++i )
+    {
+        const vec3 normal = planes[ i ].template get_sub_vector< 3 >();
+        const T scale = 1.0 / normal.length();
+        for( size_t j = 0; j < 4; ++j )
+            _planes[ i ][ j ][ view ] = planes[ i ][ j ] * scale;
+    }
+}
+
+template< typename T, size_t K >
+inline uint64_t MultiFrustumCuller< T, K >::_get_mask( const T* values,
+                                                      const T threshold,
+                                                      const bool inclusive )
+{
+    uint64_t mask = 0;
+    for( size_t k = 0; k < K; ++k )
+    {
+        const bool bit = inclusive ? values[ k ] >= threshold :
+                                     values[ k ] > threshold;
+        mask |= uint64_t( bit ) << k;
+    }
+    return mask;
+}
+
+template< typename T, size_t K >
+uint64_t MultiFrustumCuller< T, K >::test_sphere( const vec4& sphere,
+                                                  uint64_t* full ) const
+{
+    // the smallest signed distance of the center to the planes of each view
+    T distance[ K ];
+    for( size_t k = 0; k < K; ++k )
+        distance[ k ] = std::numeric_limits< T >::max();
+
+    for( size_t i = 0; i < 6; ++i )
+    {
+        const T* a = _planes[ i ][ 0 ];
+        const T* b = _planes[ i ][ 1 ];
+        const T* c = _planes[ i ][ 2 ];
+        const T* d = _planes[ i ][ 3 ];
+        for( size_t k = 0; k < K; ++k )
+        {
+            const T planeDistance = a[ k ] * sphere.x() + b[ k ] * sphere.y() +
+                                    c[ k ] * sphere.z() + d[ k ];
+            distance[ k ] = planeDistance < distance[ k ] ? planeDistance :
+                                                            distance[ k ];
+        }
+    }
+
+    if( full )
+        *full = _get_mask( distance, sphere.w(), true );
+    return _get_mask( distance, -sphere.w(), false );
+}
+
+template< typename T, size_t K >
+uint64_t MultiFrustumCuller< T, K >::test_aabb( const AABB< T >& aabb,
+                                                uint64_t* full ) const
+{
+    const vec3 center = aabb.getCenter();
+    const vec3 extent = aabb.getDimension() * T( .5 );
+
+    // the smallest signed distances of the nearest and the farthest box
+    // corner to the planes of each view
+    T nearest[ K ];
+    T farthest[ K ];
+    for( size_t k = 0; k < K; ++k )
+        nearest[ k ] = farthest[ k ] = std::numeric_limits< T >::max();
+
+    for( size_t i = 0; i < 6; ++i )
+    {
+        const T* a = _planes[ i ][ 0 ];
+        const T* b = _planes[ i ][ 1 ];
+        const T* c = _planes[ i ][ 2 ];
+        const T* d = _planes[ i ][ 3 ];
+        for( size_t k = 0; k < K; ++k )
+        {
+            const T distance = a[ k ] * center.x() + b[ k ] * center.y() +
+                               c[ k ] * center.z() + d[ k ];
+            const T radius = extent.x() * std::abs( a[ k ] ) +
+                             extent.y() * std::abs( b[ k ] ) +
+                             extent.z() * std::abs( c[ k ] );
+            const T min_distance = distance - radius;
+            const T max_distance = distance + radius;
+            nearest[ k ] = min_distance < nearest[ k ] ? min_distance
+                                                       : nearest[ k ];
+            farthest[ k ] = max_distance < farthest[ k ] ? max_distance
+                                                         : farthest[ k ];
+        }
+    }
+
+    if( full )
+        *full = _get_mask( nearest, 0, true );
+    return _get_mask( farthest, 0, false );
+}
+
+template< typename T, size_t K >
+void MultiFrustumCuller< T, K >::test_spheres( const vec4* spheres,
+                                               const size_t n,
+                                               uint64_t* visible,
+                                               uint64_t* full ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "MultiFrustumCuller::test_spheres" );
+    if( _statistics )
+    {
+        CullingStatistics::Pass pass( *_statistics );
+        for( size_t i = 0; i < n; ++i )
+        {
+            uint64_t fullMask;
+            visible[ i ] = test_sphere( spheres[ i ], &fullMask );
+            if( full )
+                full[ i ] = fullMask;
+            _count( pass, visible[ i ], fullMask );
+        }
+        return;
+    }
+
+    for( size_t i = 0; i < n; ++i )
+        visible[ i ] = test_sphere( spheres[ i ], full ? full + i : 0 );
+}
+
+template< typename T, size_t K >
+void MultiFrustumCuller< T, K >::test_aabbs( const AABB< T >* aabbs,
+                                             const size_t n,
+                                             uint64_t* visible,
+                                             uint64_t* full ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "MultiFrustumCuller::test_aabbs" );
+    if( _statistics )
+    {
+        CullingStatistics::Pass pass( *_statistics );
+        for( size_t i = 0; i < n; ++i )
+        {
+            uint64_t fullMask;
+            visible[ i ] = test_aabb( aabbs[ i ], &fullMask );
+            if( full )
+                full[ i ] = fullMask;
+            _count( pass, visible[ i ], fullMask );
+        }
+        return;
+    }
+
+    for( size_t i = 0; i < n; ++i )
+        visible[ i ] = test_aabb( aabbs[ i ], full ? full + i : 0 );
+}
+
+template< typename T, size_t K >
+inline size_t MultiFrustumCuller< T, K >::_count_bits( uint64_t mask )
+{
+    size_t count = 0;
+    for( ; mask; ++count )
+        mask &= mask - 1;
+    return count;
+}
+
+template< typename T, size_t K >
+inline void MultiFrustumCuller< T, K >::_count( CullingStatistics::Pass& pass,
+                                               const uint64_t visible,
+                                               const uint64_t full )
+{
+    const size_t nVisible = _count_bits( visible );
+    const size_t nFull = _count_bits( full );
+    pass.add( VISIBILITY_FULL, 6, nFull );
+    pass.add( VISIBILITY_PARTIAL, 6, nVisible - nFull );
+    pass.add( VISIBILITY_NONE, 6, K - nVisible );
+}
+
+template< typename T, size_t K >
+Visibility MultiFrustumCuller< T, K >::get_visibility( const uint64_t visible,
+                                                       const uint64_t full,
+                                                       const size_t view )
+{
+    const uint64_t bit = uint64_t( 1 ) << view;
+    return full & bit ? VISIBILITY_FULL :
+           visible & bit ? VISIBILITY_PARTIAL : VISIBILITY_NONE;
+}
+
+} // namespace vmml
+
+#endif // include protection
@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__ORIENTED_BOUNDING_BOX__HPP
+#define VMMLIB__ORIENTED_BOUNDING_BOX__HPP
+
+#include <vmmlib/aabb.hpp>
+#include <vmmlib/instrument.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace vmml
+{
+/**
+ * An oriented bounding box.
+ *
+ * The box is given by its center, three orthonormal axes stored as the columns
+ * of a 3x3 matrix, and the half extents along these axes. A default
+ * constructed box is a point at the origin.
+ */
+template< typename T > class OBB
+{
+public:
+    typedef Vector< 3, T >    vec3;
+    typedef Matrix< 3, 3, T > mat3;
+
+    /** Create a box of zero size at the origin. */
+    OBB();
+    OBB( const vec3& center, const mat3& axes, const vec3& halfExtents );
+    explicit OBB( const AABB< T >& aabb );
+
+    /**
+     * @return a box fitted to n points given as xyz coordinates, stride
+     *         elements apart.
+     *
+     * The axes are the eigenvectors of the covariance matrix of the points, the
+     * extents are the ranges of the points along these axes.
+     */
+    static OBB fromPoints( const T* xyz, size_t n, size_t stride = 3 );
+
+    void set( const vec3& center, const mat3& axes, const vec3& halfExtents );
+
+    const vec3& getCenter() const { return _center; }
+    const mat3& getAxes() const { return _axes; }
+    vec3 getAxis( size_t index ) const { return _axes.get_column( index ); }
+    const vec3& getHalfExtents() const { return _halfExtents; }
+
+    /** @return the eight corners, in the bit order of the axes. */
+    void getCorners( vec3 corners[ 8 ] ) const;
+
+    /** @return the smallest axis-aligned box containing this box. */
+    AABB< T > getAABB() const;
+
+    /**
+     * @return this box transformed by an affine matrix.
+     *
+     * The result is exact for rigid transformations and scales along the box
+     * axes. Otherwise the image of the box is not a box, and the result is a
+     * box containing it.
+     */
+    OBB transform( const Matrix< 4, 4, T >& matrix ) const;
+
+    /** @return true if the point is inside or on the box. */
+    bool isIn( const vec3& point ) const;
+
+    /** @return true if the boxes overlap, using the separating axis test. */
+    bool intersects( const OBB& other ) const;
+
+    bool operator==( const OBB& other ) const;
+    bool operator!=( const OBB& other ) const;
+
+private:
+    static void _computeEigenvectors( mat3 a, mat3& vectors );
+
+    vec3 _center;
+    mat3 _axes;
+    vec3 _halfExtents;
+};
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef OBB< float >  OBBf;
+typedef OBB< double > OBBd;
+#endif
+
+template< typename T >
+inline std::ostream& operator << ( std::ostream& os, const OBB< T >& obb )
+{
+    return os << obb.getCenter() << " +- " << obb.getHalfExtents()
+              << " along " << obb.getAxis( 0 ) << obb.getAxis( 1 )
+              << obb.getAxis( 2 );
+}
+
+template< typename T > OBB< T >::OBB()
+    : _center( vec3::ZERO )
+    , _halfExtents( vec3::ZERO )
+{}
+
+template< typename T >
+OBB< T >::OBB( const vec3& center, const mat3& axes, const vec3& halfExtents )
+    : _center( center )
+    , _axes( axes )
+    , _halfExtents( halfExtents )
+{}
+
+template< typename T > OBB< T >::OBB( const AABB< T >& aabb )
+    : _center( aabb.getCenter( ))
+    , _halfExtents( aabb.getDimension() * T( .5 ))
+{}
+
+template< typename T >
+void OBB< T >::set( const vec3& center, const mat3& axes,
+                    const vec3& halfExtents )
+{
+    _center = center;
+    _axes = axes;
+    _halfExtents = halfExtents;
+}
+
+template< typename T >
+OBB< T > OBB< T >::fromPoints( const T* xyz, const size_t n,
+                               const size_t stride )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "OBB::fromPoints" );
+    if( n == 0 )
+        return OBB();
+
+    vec3 mean( vec3::ZERO );
+    for( size_t i = 0; i < n; ++i )
+        mean += vec3( xyz + i * stride );
+    mean /= T( n );
+
+    // same as Matrix::symmetric_covariance of the centered points, without
+    // storing them in a matrix
+    T cov[ 6 ] = { 0, 0, 0, 0, 0, 0 };
+    for( size_t i = 0; i < n; ++i )
+    {
+        const vec3 p = vec3( xyz + i * stride ) - mean;
+        cov[ 0 ] += p.x() * p.x();
+        cov[ 1 ] += p.x() * p.y();
+        cov[ 2 ] += p.x() * p.z();
+        cov[ 3 ] += p.y() * p.y();
+        cov[ 4 ] += p.y() * p.z();
+        cov[ 5 ] += p.z() * p.z();
+    }
+    mat3 covariance;
+    covariance( 0, 0 ) = cov[ 0 ];
+    covariance( 0, 1 ) = covariance( 1, 0 ) = cov[ 1 ];
+    covariance( 0, 2 ) = covariance( 2, 0 ) = cov[ 2 ];
+    covariance( 1, 1 ) = cov[ 3 ];
+    covariance( 1, 2 ) = covariance( 2, 1 ) = cov[ 4 ];
+    covariance( 2, 2 ) = cov[ 5 ];
+
+    mat3 axes;
+    _computeEigenvectors( covariance, axes );
+
+    // right-handed axes
+    const vec3 axis0 = axes.get_column( 0 );
+    const vec3 axis1 = axes.get_column( 1 );
+    axes.set_column( 2, axis0.cross( axis1 ));
+
+    vec3 min( std::numeric_limits< T >::max( ));
+    vec3 max( -std::numeric_limits< T >::max( ));
+    for( size_t i = 0; i < n; ++i )
+    {
+        const vec3 p = vec3( xyz + i * stride ) - mean;
+        for( size_t j = 0; j < 3; ++j )
+        {
+            const T d = p.x() * axes( 0, j ) + p.y() * axes( 1, j ) +
+                        p.z() * axes( 2, j );
+            min[ j ] = d < min[ j ] ? d : min[ j ];
+            max[ j ] = d > max[ j ] ? d : max[ j ];
+        }
+    }
+
+    const vec3 middle = ( min + max ) * T( .5 );
+    return OBB( mean + axes * middle, axes, ( max - min ) * T( .5 ));
+}
+
+template< typename T >
+void OBB< T >::_computeEigenvectors( mat3 a, mat3& vectors )
+{
+    // cyclic Jacobi method, converges in a few sweeps for 3x3 matrices
+    vectors = mat3::IDENTITY;
+    for( size_t sweep = 0; sweep < 32; ++sweep )
+    {
+        const T offDiagonal = a( 0, 1 ) * a( 0, 1 ) + a( 0, 2 ) * a( 0, 2 ) +
+                              a( 1, 2 ) * a( 1, 2 );
+        const T diagonal = a( 0, 0 ) * a( 0, 0 ) + a( 1, 1 ) * a( 1, 1 ) +
+                           a( 2, 2 ) * a( 2, 2 );
+        if( offDiagonal <= diagonal * std::numeric_limits< T >::epsilon() *
+                                      std::numeric_limits< T >::epsilon( ))
+        {
+            return;
+        }
+
+        for( size_t p = 0; p < 2; ++p )
+        {
+            for( size_t q = p + 1; q < 3; ++q )
+            {
+                if( a( p, q ) == 0 )
+                    continue;
+
+                // rotation zeroing a( p, q )
+                const T theta = ( a( q, q ) - a( p, p )) / ( 2 * a( p, q ));
+                const T t = ( theta < 0 ? T( -1 ) : T( 1 )) /
+                          ( std::abs( theta ) + std::sqrt( theta * theta + 1 ));
+                const T c = 1 / std::sqrt( t * t + 1 );
+                const T s = t * c;
+
+                for( size_t k = 0; k < 3; ++k )
+                {
+                    const T akp = a( k, p );
+                    const T akq = a( k, q );
+                    a( k, p ) = c * akp - s * akq;
+                    a( k, q ) = s * akp + c * akq;
+                }
+                for( size_t k = 0; k < 3; ++k )
+                {
+                    const T apk = a( p, k );
+                    const T aqk = a( q, k );
+                    a( p, k ) = c * apk - s * aqk;
+                    a( q, k ) = s * apk + c * aqk;
+                }
+                for( size_t k = 0; k < 3; ++k )
+                {
+                    const T vkp = vectors( k, p );
+                    const T vkq = vectors( k, q );
+                    vectors( k, p ) = c * vkp - s * vkq;
+                    vectors( k, q ) = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+template< typename T >
+void OBB< T >::getCorners( vec3 corners[ 8 ] ) const
+{
+    const vec3 axes[3] = { getAxis( 0 ) * _halfExtents.x(),
+                           getAxis( 1 ) * _halfExtents.y(),
+                           getAxis( 2 ) * _halfExtents.z() };
+    for( size_t i = 0; i < 8; ++i )
+        corners[ i ] = _center + ( i & 1 ? axes[0] : -axes[0] ) +
+                                 ( i & 2 ? axes[1] : -axes[1] ) +
+                                 ( i & 4 ? axes[2] : -axes[2] );
+}
+
+template< typename T >
+AABB< T > OBB< T >::getAABB() const
+{
+    vec3 extent;
+    for( size_t i = 0; i < 3; ++i )
+        extent[ i ] = std::abs( _axes( i, 0 )) * _halfExtents.x() +
+                      std::abs( _axes( i, 1 )) * _halfExtents.y() +
+                      std::abs( _axes( i, 2 )) * _halfExtents.z();
+    return AABB< T >( _center - extent, _center + extent );
+}
+
+template< typename T >
+OBB< T > OBB< T >::transform( const Matrix< 4, 4, T >& matrix ) const
+{
+    mat3 linear;
+    matrix.get_sub_matrix( linear, 0, 0 );
+
+    // images of the half axes, orthonormalized to the new axes
+    const vec3 images[3] = { linear * ( getAxis( 0 ) * _halfExtents.x( )),
+                             linear * ( getAxis( 1 ) * _halfExtents.y( )),
+                             linear * ( getAxis( 2 ) * _halfExtents.z( )) };
+    vec3 axes[3];
+    axes[0] = linear * getAxis( 0 );
+    axes[0].normalize();
+    axes[1] = linear * getAxis( 1 );
+    axes[1] -= axes[0] * axes[0].dot( axes[1] );
+    axes[1].normalize();
+    axes[2] = axes[0].cross( axes[1] );
+
+    mat3 resultAxes;
+    vec3 halfExtents;
+    for( size_t i = 0; i < 3; ++i )
+    {
+        resultAxes.set_column( i, axes[i] );
+        halfExtents[ i ] = std::abs( axes[i].dot( images[0] )) +
+                           std::abs( axes[i].dot( images[1] )) +
+                           std::abs( axes[i].dot( images[2] ));
+    }
+
+    return OBB( matrix * _center, resultAxes, halfExtents );
+}
+
+template< typename T >
+bool OBB< T >::isIn( const vec3& point ) const
+{
+    const vec3 d = point - _center;
+    for( size_t i = 0; i < 3; ++i )
+        if( std::abs( d.dot( getAxis( i ))) > _halfExtents[ i ] )
+            return false;
+    return true;
+}
+
+template< typename T >
+bool OBB< T >::intersects( const OBB< T >& other ) const
+{
+    // Gottschalk et al., "OBBTree: A Hierarchical Structure for Rapid
+    // Interference Detection", tests the 15 potential separating axes
+    const vec3 a[3] = { getAxis( 0 ), getAxis( 1 ), getAxis( 2 ) };
+    const vec3 b[3] = { other.getAxis( 0 ), other.getAxis( 1 ),
+                        other.getAxis( 2 ) };
+    const vec3& ea = _halfExtents;
+    const vec3& eb = other._halfExtents;
+
+    // rotation of other into this frame, with an epsilon against false
+    // separation of near-parallel edges
+    T R[3][3];
+    T absR[3][3];
+    for( size_t i = 0; i < 3; ++i )
+        for( size_t j = 0; j < 3; ++j )
+        {
+            R[i][j] = a[i].dot( b[j] );
+            absR[i][j] = std::abs( R[i][j] ) +
+                         std::numeric_limits< T >::epsilon() * 16;
+        }
+
+    const vec3 d = other._center - _center;
+    const T t[3] = { d.dot( a[0] ), d.dot( a[1] ), d.dot( a[2] ) };
+
+    // axes of this box
+    for( size_t i = 0; i < 3; ++i )
+    {
+        const T rb = eb[0] * absR[i][0] + eb[1] * absR[i][1] +
+                     eb[2] * absR[i][2];
+        if( std::abs( t[i] ) > ea[i] + rb )
+            return false;
+    }
+
+    // axes of the other box
+    for( size_t j = 0; j < 3; ++j )
+    {
+        const T ra = ea[0] * absR[0][j] + ea[1] * absR[1][j] +
+                     ea[2] * absR[2][j];
+        if( std::abs( t[0] * R[0][j] + t[1] * R[1][j] + t[2] * R[2][j] ) >
+            ra + eb[j] )
+        {
+            return false;
+        }
+    }
+
+    // cross products of the axes of both boxes
+    for( size_t i = 0; i < 3; ++i )
+    {
+        const size_t i1 = ( i + 1 ) % 3;
+        const size_t i2 = ( i + 2 ) % 3;
+        for( size_t j = 0; j < 3; ++j )
+        {
+            const size_t j1 = ( j + 1 ) % 3;
+            const size_t j2 = ( j + 2 ) % 3;
+            const T ra = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j];
+            const T rb = eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+            if( std::abs( t[i2] * R[i1][j] - t[i1] * R[i2][j] ) > ra + rb )
+                return false;
+        }
+    }
+    return true;
+}
+
+template< typename T >
+bool OBB< T >::operator==( const OBB< T >& other ) const
+{
+    return _center == other._center && _axes == other._axes &&
+           _halfExtents == other._halfExtents;
+}
+
+template< typename T >
+bool OBB< T >::operator!=( const OBB< T >& other ) const
+{
+    return !( *this == other );
+}
+
+} // namespace vmml
+
+#endif
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__OCCLUSION_BUFFER__HPP
+#define VMMLIB__OCCLUSION_BUFFER__HPP
+
+#include <vmmlib/aabb.hpp>
+#include <vmmlib/execution.hpp>
+#include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/instrument.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// - declaration -
+
+namespace vmml
+{
+
+/**
+ * A software depth buffer for occlusion culling.
+ *
+ * Occluder triangles are rasterized into a small depth buffer, which also
+ * keeps the farthest depth of each TILE_SIZE x TILE_SIZE tile. Bounding boxes
+ * are then tested against it: a box is occluded if its nearest depth is
+ * behind the stored depth everywhere within its screen-space bounds. Tiles
+ * entirely in front of the box are accepted without looking at their pixels.
+ *
+ * Depths are window depths in [0, 1] as computed by the matrix given to
+ * setup(). Occluder triangles crossing the near plane are skipped, and boxes
+ * crossing it are never occluded, which keeps the test conservative apart
+ * from the usual pixel-center sampling of the occluders.
+ *
+ * Rasterization can be restricted to a range of tile rows. Disjoint ranges
+ * write disjoint parts of the buffer, so threads can rasterize the same
+ * occluders into their own band concurrently, as add_occluders() does with
+ * an ExecutionPolicy.
+ *
+ * Use as a second stage after frustum culling, see test_aabb().
+ */
+template< typename T > class OcclusionBuffer
+{
+public:
+    typedef Vector< 3, T > vec3;
+    typedef Vector< 4, T > vec4;
+
+    static const size_t TILE_SIZE = 8;
+
+    /** Create a cleared buffer of the given size in pixels. */
+    OcclusionBuffer( size_t width, size_t height );
+
+    /** Set the projection*modelView matrix and clear the buffer. */
+    void setup( const Matrix< 4, 4, T >& proj_modelview );
+
+    /** Reset all depths to the far plane. */
+    void clear();
+
+    size_t get_width() const { return _width; }
+    size_t get_height() const { return _height; }
+    size_t get_num_tile_rows() const { return _tile_rows; }
+
+    /** @return the depth stored for the given pixel. */
+    T get_depth( size_t x, size_t y ) const { return _depth[ y * _width + x ]; }
+
+    /**
+     * Rasterize an occluder triangle.
+     *
+     * Only the tile rows in [tile_row_begin, tile_row_end) are written.
+     */
+    void add_occluder( const vec3& a, const vec3& b, const vec3& c,
+                       size_t tile_row_begin = 0,
+                       size_t tile_row_end =
+                           std::numeric_limits< size_t >::max( ));
+
+    /** Rasterize the faces of a box as occluder. */
+    void add_occluder( const AABB< T >& aabb, size_t tile_row_begin = 0,
+                       size_t tile_row_end =
+                           std::numeric_limits< size_t >::max( ));
+
+    /**
+     * Rasterize n_triangles occluder triangles, given by three indices each
+     * into an array of xyz vertex coordinates.
+     */
+    void add_occluders( const T* xyz, const unsigned* indices,
+                        size_t n_triangles, size_t tile_row_begin = 0,
+                        size_t tile_row_end =
+                           std::numeric_limits< size_t >::max( ));
+
+    /**
+     * Rasterize occluder triangles like add_occluders(), in bands of tile rows
+     * run by the policy. The result does not depend on the policy.
+     */
+    void add_occluders( const T* xyz, const unsigned* indices,
+                        size_t n_triangles, const ExecutionPolicy& policy );
+
+    /** @return true if the box is hidden behind the occluders. */
+    bool is_occluded( const AABB< T >& aabb ) const;
+
+    /**
+     * @return the visibility of the box from the frustum culler, or
+     *         VISIBILITY_NONE if it is occluded.
+     */
+    Visibility test_aabb( const FrustumCuller< T >& culler,
+                          const AABB< T >& aabb ) const;
+
+private:
+    bool _project( const vec3& point, vec3& window ) const;
+    void _rasterize( const vec3& a, const vec3& b, const vec3& c,
+                     size_t row_begin, size_t row_end );
+    void _update_tiles( size_t x_begin, size_t x_end, size_t y_begin,
+                        size_t y_end );
+
+    Matrix< 4, 4, T > _matrix;
+    size_t _width;
+    size_t _height;
+    size_t _tile_columns;
+    size_t _tile_rows;
+    std::vector< T > _depth;
+    std::vector< T > _tile_depth; // farthest depth per tile
+};
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef OcclusionBuffer< float >  OcclusionBufferf;
+typedef OcclusionBuffer< double > OcclusionBufferd;
+#endif
+
+// - implementation - //
+
+template< typename T >
+const size_t OcclusionBuffer< T >::TILE_SIZE;
+
+template< typename T >
+OcclusionBuffer< T >::OcclusionBuffer( const size_t width,
+                                       const size_t height )
+    : _width( width )
+    , _height( height )
+    , _tile_columns(( width + TILE_SIZE - 1 ) / TILE_SIZE )
+    , _tile_rows(( height + TILE_SIZE - 1 ) / TILE_SIZE )
+    , _depth( width * height, T( 1 ))
+    , _tile_depth( _tile_columns * _tile_rows, T( 1 ))
+{}
+
+template< typename T >
+void OcclusionBuffer< T >::setup( const Matrix< 4, 4, T >& proj_modelview )
+{
+    _matrix = proj_modelview;
+    clear();
+}
+
+template< typename T >
+void OcclusionBuffer< T >::clear()
+{
+    std::fill( _depth.begin(), _depth.end(), T( 1 ));
+    std::fill( _tile_depth.begin(), _tile_depth.end(), T( 1 ));
+}
+
+template< typename T >
+bool OcclusionBuffer< T >::_project( const vec3& point, vec3& window ) const
+{
+    const vec4 clip = _matrix * vec4( point, 1 );
+    if( clip.w() <= std::numeric_limits< T >::epsilon( ))
+        return false;
+
+    const T scale = T( .5 ) / clip.w();
+    window.x() = ( clip.x() * scale + T( .5 )) * T( _width );
+    window.y() = ( clip.y() * scale + T( .5 )) * T( _height );
+    window.z() = clip.z() * scale + T( .5 );
+    return true;
+}
+
+template< typename T >
+void OcclusionBuffer< T >::add_occluder( const vec3& a, const vec3& b,
+                                         const vec3& c,
+                                         const size_t tile_row_begin,
+                                         const size_t tile_row_end )
+{
+    vec3 window[ 3 ];
+    if( !_project( a, window[ 0 ] ) || !_project( b, window[ 1 ] ) ||
+        !_project( c, window[ 2 ] ))
+    {
+        return;
+    }
+
+    const size_t end = std::min( tile_row_end, _tile_rows );
+    if( tile_row_begin >= end )
+        return;
+    _rasterize( window[ 0 ], window[ 1 ], window[ 2 ],
+                tile_row_begin * TILE_SIZE,
+                std::min( end * TILE_SIZE, _height ));
+}
+
+template< typename T >
+void OcclusionBuffer< T >::add_occluder( const AABB< T >& aabb,
+                                         const size_t tile_row_begin,
+                                         const size_t tile_row_end )
+{
+    // corner i has the max coordinate along the axes of its set bits
+    T xyz[ 24 ];
+    for( size_t i = 0; i < 8; ++i )
+        for( size_t j = 0; j < 3; ++j )
+            xyz[ 3 * i + j ] = i & ( 1 << j ) ? aabb.getMax()[ j ] :
+                                                aabb.getMin()[ j ];
+
+    static const unsigned faces[ 36 ] = { 0, 1, 3,  0, 3, 2,   // z min
+                                          4, 5, 7,  4, 7, 6,   // z max
+                                          0, 1, 5,  0, 5, 4,   // y min
+                                          2, 3, 7,  2, 7, 6,   // y max
+                                          0, 2, 6,  0, 6, 4,   // x min
+                                          1, 3, 7,  1, 7, 5 }; // x max
+    add_occluders( xyz, faces, 12, tile_row_begin, tile_row_end );
+}
+
+template< typename T >
+void OcclusionBuffer< T >::add_occluders( const T* xyz,
+                                          const unsigned* indices,
+                                          const size_t n_triangles,
+                                          const size_t tile_row_begin,
+                                          const size_t tile_row_end )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "OcclusionBuffer::add_occluders" );
+    for( size_t i = 0; i < n_triangles; ++i )
+        add_occluder( vec3( xyz + 3 * indices[ 3 * i ] ),
+                      vec3( xyz + 3 * indices[ 3 * i + 1 ] ),
+                      vec3( xyz + 3 * indices[ 3 * i + 2 ] ),
+                      tile_row_begin, tile_row_end );
+}
+
+template< typename T >
+void OcclusionBuffer< T >::add_occluders( const T* xyz,
+                                          const unsigned* indices,
+                                          const size_t n_triangles,
+                                          const ExecutionPolicy& policy )
+{
+    // every band sets up all triangles, but only fills its own rows
+    parallel_for( policy, _tile_rows,
+                  [&]( const size_t begin, const size_t end )
+    {
+        add_occluders( xyz, indices, n_triangles, begin, end );
+    }, n_triangles * TILE_SIZE * 4 );
+}
+
+template< typename T >
+void OcclusionBuffer< T >::_rasterize( const vec3& a, const vec3& b_,
+                                       const vec3& c_, const size_t row_begin,
+                                       const size_t row_end )
+{
+    T area = ( b_.x() - a.x( )) * ( c_.y() - a.y( )) -
+             ( b_.y() - a.y( )) * ( c_.x() - a.x( ));
+    if( area == 0 )
+        return;
+
+    // occluders are double-sided, use counter-clockwise order
+    const bool flip = area < 0;
+    const vec3& b = flip ? c_ : b_;
+    const vec3& c = flip ? b_ : c_;
+    area = std::abs( area );
+
+    const T minX = std::min( a.x(), std::min( b.x(), c.x( )));
+    const T maxX = std::max( a.x(), std::max( b.x(), c.x( )));
+    const T minY = std::min( a.y(), std::min( b.y(), c.y( )));
+    const T maxY = std::max( a.y(), std::max( b.y(), c.y( )));
+    if( maxX < 0 || maxY < T( row_begin ) || minX >= T( _width ) ||
+        minY >= T( row_end ))
+    {
+        return;
+    }
+
+    const size_t xBegin = size_t( std::max( minX, T( 0 )));
+    const size_t xEnd = std::min( size_t( std::ceil( maxX )) + 1, _width );
+    const size_t yBegin = std::max( size_t( std::max( minY, T( 0 ))),
+                                    row_begin );
+    const size_t yEnd = std::min( size_t( std::ceil( maxY )) + 1, row_end );
+
+    // edge functions at pixel centers, stepped along rows, and depth
+    // interpolated with the normalized edge functions as barycentrics
+    const T invArea = 1 / area;
+    const T e0dx = ( b.y() - c.y( )), e0dy = ( c.x() - b.x( ));
+    const T e1dx = ( c.y() - a.y( )), e1dy = ( a.x() - c.x( ));
+    const T e2dx = ( a.y() - b.y( )), e2dy = ( b.x() - a.x( ));
+
+    for( size_t y = yBegin; y < yEnd; ++y )
+    {
+        const T px = T( xBegin ) + T( .5 );
+        const T py = T( y ) + T( .5 );
+        T e0 = e0dx * ( px - b.x( )) + e0dy * ( py - b.y( ));
+        T e1 = e1dx * ( px - c.x( )) + e1dy * ( py - c.y( ));
+        T e2 = e2dx * ( px - a.x( )) + e2dy * ( py - a.y( ));
+
+        T* row = &_depth[ y * _width ];
+        for( size_t x = xBegin; x < xEnd; ++x )
+        {
+            const T z = ( e0 * a.z() + e1 * b.z() + e2 * c.z( )) * invArea;
+            const bool inside = ( e0 >= 0 ) & ( e1 >= 0 ) & ( e2 >= 0 );
+            row[ x ] = inside && z < row[ x ] ? z : row[ x ];
+            e0 += e0dx;
+            e1 += e1dx;
+            e2 += e2dx;
+        }
+    }
+    _update_tiles( xBegin, xEnd, yBegin, yEnd );
+}
+
+template< typename T >
+void OcclusionBuffer< T >::_update_tiles( const size_t x_begin,
+                                          const size_t x_end,
+                                          const size_t y_begin,
+                                          const size_t y_end )
+{
+    if( x_begin >= x_end || y_begin >= y_end )
+        return;
+
+    for( size_t ty = y_begin / TILE_SIZE; ty <= ( y_end - 1 ) / TILE_SIZE;
+         ++ty )
+    {
+        const size_t yEnd = std::min(( ty + 1 ) * TILE_SIZE, _height );
+        for( size_t tx = x_begin / TILE_SIZE; tx <= ( x_end - 1 ) / TILE_SIZE;
+             ++tx )
+        {
+            const size_t xEnd = std::min(( tx + 1 ) * TILE_SIZE, _width );
+            T farthest = 0;
+            for( size_t y = ty * TILE_SIZE; y < yEnd; ++y )
+                for( size_t x = tx * TILE_SIZE; x < xEnd; ++x )
+                {
+                    const T depth = _depth[ y * _width + x ];
+                    farthest = depth > farthest ? depth : farthest;
+                }
+            _tile_depth[ ty * _tile_columns + tx ] = farthest;
+        }
+    }
+}
+
+template< typename T >
+bool OcclusionBuffer< T >::is_occluded( const AABB< T >& aabb ) const
+{
+    T minX = std::numeric_limits< T >::max();
+    T minY = minX;
+    T minZ = minX;
+    T maxX = -minX;
+    T maxY = -minX;
+    for( size_t i = 0; i < 8; ++i )
+    {
+        const vec3 corner( i & 1 ? aabb.getMax().x() : aabb.getMin().x(),
+                           i & 2 ? aabb.getMax().y() : aabb.getMin().y(),
+                           i & 4 ? aabb.getMax().z() : aabb.getMin().z( ));
+        vec3 window;
+        if( !_project( corner, window ))
+            return false;
+
+        minX = std::min( minX, window.x( ));
+        minY = std::min( minY, window.y( ));
+        minZ = std::min( minZ, window.z( ));
+        maxX = std::max( maxX, window.x( ));
+        maxY = std::max( maxY, window.y( ));
+    }
+
+    // all pixels overlapping the screen-space bounds
+    const size_t xBegin = size_t( std::max( minX, T( 0 )));
+    const size_t yBegin = size_t( std::max( minY, T( 0 )));
+    const size_t xEnd = size_t( std::min( std::ceil( maxX ), T( _width )));
+    const size_t yEnd = size_t( std::min( std::ceil( maxY ), T( _height )));
+    if( maxX <= 0 || maxY <= 0 || xBegin >= xEnd || yBegin >= yEnd )
+        return false;
+
+    for( size_t ty = yBegin / TILE_SIZE; ty <= ( yEnd - 1 ) / TILE_SIZE; ++ty )
+    {
+        for( size_t tx = xBegin / TILE_SIZE; tx <= ( xEnd - 1 ) / TILE_SIZE;
+             ++tx )
+        {
+            if( _tile_depth[ ty * _tile_columns + tx ] < minZ )
+                continue;
+
+            const size_t y0 = std::max( ty * TILE_SIZE, yBegin );
+            const size_t y1 = std::min(( ty + 1 ) * TILE_SIZE, yEnd );
+            const size_t x0 = std::max( tx * TILE_SIZE, xBegin );
+            const size_t x1 = std::min(( tx + 1 ) * TILE_SIZE, xEnd );
+            for( size_t y = y0; y < y1; ++y )
+                for( size_t x = x0; x < x1; ++x )
+                    if( _depth[ y * _width + x ] >= minZ )
+                        return false;
+        }
+    }
+    return true;
+}
+
+template< typename T >
+Visibility OcclusionBuffer< T >::test_aabb( const FrustumCuller< T >& culler,
+                                            const AABB< T >& aabb ) const
+{
+    const Visibility visibility = culler.test_aabb( aabb );
+    if( visibility == VISIBILITY_NONE || is_occluded( aabb ))
+        return VISIBILITY_NONE;
+    return visibility;
+}
+
+} // namespace vmml
+
+#endif // include protection
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__ONE_EURO_FILTER__HPP
+#define VMMLIB__ONE_EURO_FILTER__HPP
+
+#include <vmmlib/math.hpp>
+#include <vmmlib/quaternion.hpp>
+#include <vmmlib/vector.hpp>
+
+#include <cmath>
+#include <limits>
+
+// - declaration - //
+
+namespace vmml
+{
+
+/** The type of the derivative of a OneEuroFilter value of type V. */
+template< typename V, typename T > struct one_euro_derivative
+{
+    typedef V type;
+};
+
+template< typename T > struct one_euro_derivative< Quaternion< T >, T >
+{
+    typedef Vector< 3, T > type;
+};
+
+/**
+ * An adaptive low pass filter following the speed of the signal.
+ *
+ * Implements the 1 Euro filter (G. Casiez, N. Roussel and D. Vogel, "1 Euro
+ * Filter: A Simple Speed-based Low-pass Filter for Noisy Input in Interactive
+ * Systems", CHI 2012): the cutoff frequency rises with the filtered speed of
+ * the signal, so that slow motion is smoothed to remove jitter while fast
+ * motion is followed with little lag.
+ *
+ * V is the value type: a scalar T, a Vector< M, T > or a unit Quaternion< T >.
+ * The signed derivative of the signal is low pass filtered, and the speed is
+ * its magnitude, so that jitter at rest averages out instead of raising the
+ * cutoff. The derivative of quaternions is the angular velocity vector in
+ * radians per second, and they are blended along the shorter arc. O(1) per
+ * sample, without allocation.
+ */
+template< typename V, typename T = float > class OneEuroFilter
+{
+public:
+    /** The type of the derivative of V. */
+    typedef typename one_euro_derivative< V, T >::type derivative_type;
+
+    /**
+     * @param min_cutoff cutoff frequency in Hz when the signal is at rest
+     * @param beta increase of the cutoff frequency per unit of speed
+     * @param d_cutoff cutoff frequency in Hz for filtering the speed
+     */
+    OneEuroFilter( T min_cutoff, T beta, T d_cutoff = 1 );
+
+    /**
+     * Add a sample taken dt seconds after the previous one and return the
+     * filtered value. The first sample after construction or reset() is
+     * passed through, later samples with dt <= 0 are ignored.
+     */
+    const V& add( const V& value, T dt );
+
+    const V& get() const { return _value; }
+    const V* operator->() const { return &_value; }
+    const V& operator*() const { return _value; }
+
+    /** @return the filtered derivative of the signal per second. */
+    const derivative_type& get_derivative() const { return _derivative; }
+
+    /** @return the magnitude of the filtered derivative. */
+    T get_speed() const { return _speed; }
+
+    /** @return the current cutoff frequency in Hz. */
+    T get_cutoff() const { return _min_cutoff + _beta * _speed; }
+
+    void set_min_cutoff( const T min_cutoff ) { _min_cutoff = min_cutoff; }
+    void set_beta( const T beta ) { _beta = beta; }
+    void set_d_cutoff( const T d_cutoff ) { _d_cutoff = d_cutoff; }
+
+    /** Forget the filter state. */
+    void reset()
+        { _empty = true; _derivative = derivative_type(); _speed = 0; }
+
+private:
+    static T _alpha( T cutoff, T dt );
+
+    static T _get_derivative( T a, T b, T dt ) { return ( b - a ) / dt; }
+    template< size_t M >
+    static Vector< M, T > _get_derivative( const Vector< M, T >& a,
+                                           const Vector< M, T >& b, T dt )
+        { return ( b - a ) / dt; }
+    static Vector< 3, T > _get_derivative( const Quaternion< T >& a,
+                                           const Quaternion< T >& b, T dt );
+
+    static T _length( T a ) { return std::abs( a ); }
+    template< size_t M >
+    static T _length( const Vector< M, T >& a ) { return a.length(); }
+
+    static T _blend( T a, T b, T alpha ) { return a + ( b - a ) * alpha; }
+    template< size_t M >
+    static Vector< M, T > _blend( const Vector< M, T >& a,
+                                  const Vector< M, T >& b, T alpha )
+        { return a + ( b - a ) * alpha; }
+    static Quaternion< T > _blend( const Quaternion< T >& a,
+                                   const Quaternion< T >& b, T alpha )
+        { return Quaternion< T >::nlerp( alpha, a, b ); }
+
+    T _min_cutoff;
+    T _beta;
+    T _d_cutoff;
+    bool _empty;
+    derivative_type _derivative;
+    T _speed; // length of _derivative
+    V _previous; // last sample
+    V _value;
+};
+
+// - implementation - //
+
+template< typename V, typename T >
+OneEuroFilter< V, T >::OneEuroFilter( const T min_cutoff, const T beta,
+                                      const T d_cutoff )
+    : _min_cutoff( min_cutoff )
+    , _beta( beta )
+    , _d_cutoff( d_cutoff )
+    , _empty( true )
+    , _derivative()
+    , _speed( 0 )
+    , _previous()
+    , _value()
+{}
+
+template< typename V, typename T >
+T OneEuroFilter< V, T >::_alpha( const T cutoff, const T dt )
+{
+    // smoothing factor of an exponential filter with the given cutoff
+    const T tau = 1 / ( 2 * T( M_PI ) * cutoff );
+    return 1 / ( 1 + tau / dt );
+}
+
+template< typename V, typename T >
+Vector< 3, T > OneEuroFilter< V, T >::_get_derivative( const Quaternion< T >& a,
+                                                       const Quaternion< T >& b,
+                                                       const T dt )
+{
+    // logarithm of the rotation from a to b along the shorter arc
+    Quaternion< T > delta = a.get_conjugate() * b;
+    if( delta.w() < 0 )
+        delta = -delta;
+
+    const Vector< 3, T > axis( delta.x(), delta.y(), delta.z( ));
+    const T sine = axis.length();
+    if( sine <= std::numeric_limits< T >::epsilon( ))
+        return axis * ( 2 / dt );
+    return axis * ( 2 * std::atan2( sine, delta.w( )) / ( sine * dt ));
+}
+
+template< typename V, typename T >
+const V& OneEuroFilter< V, T >::add( const V& value, const T dt )
+{
+    if( _empty || dt <= 0 )
+    {
+        if( _empty )
+            _value = _previous = value;
+        _empty = false;
+        return _value;
+    }
+
+    const derivative_type derivative = _get_derivative( _previous, value, dt );
+    _previous = value;
+    _derivative += ( derivative - _derivative ) * _alpha( _d_cutoff, dt );
+    _speed = _length( _derivative );
+
+    _value = _blend( _value, value, _alpha( get_cutoff(), dt ));
+    return _value;
+}
+
+} // namespace vmml
+
+#endif // include protection
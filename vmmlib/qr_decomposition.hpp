@@ -34,6 +34,7 @@
 
 #include <vmmlib/matrix.hpp>
 #include <vmmlib/vector.hpp>
+#include <vmmlib/instrument.hpp>
 #include <vmmlib/exception.hpp>
 
 #include <cmath>
@@ -56,6 +57,7 @@ void qr_decompose_gram_schmidt(
     Matrix< N, N, T >& R
     )
 {
+    VMMLIB_INSTRUMENT_SCOPE( "qr_decompose_gram_schmidt" );
     Q   = 0.0;
     R   = 0.0;
 
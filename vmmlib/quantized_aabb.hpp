@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__QUANTIZED_AABB__HPP
+#define VMMLIB__QUANTIZED_AABB__HPP
+
+#include <vmmlib/aabb.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// - declaration - //
+
+namespace vmml
+{
+
+/**
+ * An axis-aligned bounding box quantized relative to a parent box.
+ *
+ * The bounds are stored as integer offsets of type Q, dividing each axis of
+ * the parent box into numeric_limits< Q >::max() steps. With 16 bit offsets a
+ * box takes 12 instead of 24 bytes for float, with 8 bit offsets 6 bytes.
+ * The parent box is not stored, it is typically the bounds of the parent node
+ * in a hierarchy and known during traversal.
+ *
+ * Encoding rounds conservatively: the decoded box always contains the encoded
+ * box, as long as the latter lies within the parent. Decoded boxes can be used
+ * with AABB, FrustumCuller::test_aabb() and Intersection::test_aabb().
+ */
+template< typename T, typename Q = uint16_t > class QuantizedAABB
+{
+public:
+    /** Create an empty bounding box. */
+    QuantizedAABB();
+
+    /** Create the quantized bounds of aabb relative to parent. */
+    QuantizedAABB( const AABB< T >& aabb, const AABB< T >& parent );
+
+    void set( const AABB< T >& aabb, const AABB< T >& parent );
+
+    /** @return the bounding box relative to the parent used for encoding. */
+    AABB< T > decode( const AABB< T >& parent ) const;
+
+    /** Decode n boxes relative to the same parent. */
+    static void decode( const QuantizedAABB* boxes, size_t n,
+                        const AABB< T >& parent, AABB< T >* result );
+
+    /**
+     * Decode n boxes relative to the same parent into separate arrays of their
+     * min and max coordinates, as used by AABB::intersects().
+     */
+    static void decode( const QuantizedAABB* boxes, size_t n,
+                        const AABB< T >& parent, T* minX, T* minY, T* minZ,
+                        T* maxX, T* maxY, T* maxZ );
+
+    /** @return the quantized min corner. */
+    const Q* getMin() const { return _min; }
+
+    /** @return the quantized max corner. */
+    const Q* getMax() const { return _max; }
+
+    bool operator==( const QuantizedAABB& other ) const;
+    bool operator!=( const QuantizedAABB& other ) const;
+
+    static const Q STEPS = std::numeric_limits< Q >::max();
+
+private:
+    Q _min[3];
+    Q _max[3];
+};
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef QuantizedAABB< float >  QuantizedAABBf;
+typedef QuantizedAABB< double > QuantizedAABBd;
+#endif
+
+// - implementation - //
+
+template< typename T, typename Q >
+const Q QuantizedAABB< T, Q >::STEPS;
+
+template< typename T, typename Q >
+QuantizedAABB< T, Q >::QuantizedAABB()
+{
+    for( size_t i = 0; i < 3; ++i )
+    {
+        _min[ i ] = STEPS;
+        _max[ i ] = 0;
+    }
+}
+
+template< typename T, typename Q >
+QuantizedAABB< T, Q >::QuantizedAABB( const AABB< T >& aabb,
+                                      const AABB< T >& parent )
+{
+    set( aabb, parent );
+}
+
+template< typename T, typename Q >
+void QuantizedAABB< T, Q >::set( const AABB< T >& aabb,
+                                 const AABB< T >& parent )
+{
+    const Vector< 3, T >& parentMin = parent.getMin();
+    const Vector< 3, T >& parentMax = parent.getMax();
+
+    for( size_t i = 0; i < 3; ++i )
+    {
+        const T extent = parentMax[ i ] - parentMin[ i ];
+        if( extent <= 0 )
+        {
+            _min[ i ] = 0;
+            _max[ i ] = STEPS;
+            continue;
+        }
+
+        // decode() computes min from the parent min and max from the parent
+        // max, so that both parent bounds are reproduced exactly
+        const T step = extent / T( STEPS );
+        const T lo = std::floor(( aabb.getMin()[i] - parentMin[i] ) / step );
+        const T hi = std::floor(( parentMax[i] - aabb.getMax()[i] ) / step );
+        Q qMin = lo <= 0 ? Q( 0 ) : lo >= T( STEPS ) ? STEPS : Q( lo );
+        Q qMax = hi <= 0 ? STEPS : hi >= T( STEPS ) ? Q( 0 ) : Q( STEPS - hi );
+
+        // compensate the rounding error of the division
+        while( qMin > 0 &&
+               parentMin[ i ] + T( qMin ) * step > aabb.getMin()[ i ] )
+        {
+            --qMin;
+        }
+        while( qMax < STEPS &&
+               parentMax[ i ] - T( STEPS - qMax ) * step < aabb.getMax()[ i ])
+        {
+            ++qMax;
+        }
+        _min[ i ] = qMin;
+        _max[ i ] = qMax;
+    }
+}
+
+template< typename T, typename Q >
+AABB< T > QuantizedAABB< T, Q >::decode( const AABB< T >& parent ) const
+{
+    AABB< T > result;
+    decode( this, 1, parent, &result );
+    return result;
+}
+
+template< typename T, typename Q >
+void QuantizedAABB< T, Q >::decode( const QuantizedAABB* boxes, const size_t n,
+                                    const AABB< T >& parent, AABB< T >* result )
+{
+    const Vector< 3, T >& parentMin = parent.getMin();
+    const Vector< 3, T >& parentMax = parent.getMax();
+    const Vector< 3, T > step = ( parentMax - parentMin ) / T( STEPS );
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        Vector< 3, T >& min = result[ i ].getMin();
+        Vector< 3, T >& max = result[ i ].getMax();
+        for( size_t j = 0; j < 3; ++j )
+        {
+            min[ j ] = parentMin[ j ] + T( boxes[ i ]._min[ j ] ) * step[ j ];
+            max[ j ] = parentMax[ j ] -
+                       T( STEPS - boxes[ i ]._max[ j ] ) * step[ j ];
+        }
+    }
+}
+
+template< typename T, typename Q >
+void QuantizedAABB< T, Q >::decode( const QuantizedAABB* boxes, const size_t n,
+                                    const AABB< T >& parent, T* minX, T* minY,
+                                    T* minZ, T* maxX, T* maxY, T* maxZ )
+{
+    const Vector< 3, T >& parentMin = parent.getMin();
+    const Vector< 3, T >& parentMax = parent.getMax();
+    const Vector< 3, T > step = ( parentMax - parentMin ) / T( STEPS );
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        const QuantizedAABB& box = boxes[ i ];
+        minX[ i ] = parentMin.x() + T( box._min[0] ) * step.x();
+        minY[ i ] = parentMin.y() + T( box._min[1] ) * step.y();
+        minZ[ i ] = parentMin.z() + T( box._min[2] ) * step.z();
+        maxX[ i ] = parentMax.x() - T( STEPS - box._max[0] ) * step.x();
+        maxY[ i ] = parentMax.y() - T( STEPS - box._max[1] ) * step.y();
+        maxZ[ i ] = parentMax.z() - T( STEPS - box._max[2] ) * step.z();
+    }
+}
+
+template< typename T, typename Q >
+bool QuantizedAABB< T, Q >::operator==( const QuantizedAABB& other ) const
+{
+    for( size_t i = 0; i < 3; ++i )
+        if( _min[ i ] != other._min[ i ] || _max[ i ] != other._max[ i ] )
+            return false;
+    return true;
+}
+
+template< typename T, typename Q >
+bool QuantizedAABB< T, Q >::operator!=( const QuantizedAABB& other ) const
+{
+    return !( *this == other );
+}
+
+} // namespace vmml
+
+#endif
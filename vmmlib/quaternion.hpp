@@ -95,6 +95,12 @@ public:
 
     template< size_t D > void set( const Matrix< D, D, T >& rotation_matrix_ );
 
+    // same result as set( rotation_matrix_ ), but selects the best conditioned
+    // solution arithmetically instead of branching. Vectorizes well in loops
+    // over arrays of matrices, see QuaternionBatch::set().
+    template< size_t D >
+    void set_branchless( const Matrix< D, D, T >& rotation_matrix_ );
+
     void set( T ww, T xx, T yy, T zz);
     void set( Vector< 3, T >& xyz, T w );
 
@@ -180,9 +186,24 @@ public:
     Quaternion rotate_y( T theta, const Vector< 3, T >& a );
     Quaternion rotate_z( T theta, const Vector< 3, T >& a );
 
+    // rotate a vector by this unit quaternion, cheaper than q * v * q^-1
+    Vector< 3, T > rotate( const Vector< 3, T >& a ) const;
+
     static Quaternion slerp( T a, const Quaternion& p,
         const Quaternion& q, const T epsilon = 1e-13 );
 
+    // normalized linear interpolation along the shorter arc. Cheap, but not
+    // constant speed. p and q must be unit quaternions.
+    static Quaternion nlerp( T a, const Quaternion& p, const Quaternion& q );
+
+    // fast slerp approximation: nlerp with a polynomial correction of the
+    // interpolation parameter (after A. Kapoulkine, "Approximating slerp").
+    // The error of the rotation angle is below 8e-4 rad (0.045 degrees) for
+    // any input and below 8e-5 rad for inputs less than 90 degrees apart.
+    // p and q must be unit quaternions.
+    static Quaternion fast_slerp( T a, const Quaternion& p,
+                                  const Quaternion& q );
+
     Matrix< 3, 3, T > get_rotation_matrix() const;
 
     template< size_t D > void get_rotation_matrix( Matrix< D, D, T >& result ) const;
@@ -308,7 +329,7 @@ void Quaternion< T >::set( const Matrix< D, D, T >& M )
             z() = M( 0,2 ) + M( 2,0 );
             z() *= s;
 
-            w() = M( 1,2 ) - M( 2,1 );
+            w() = M( 2,1 ) - M( 1,2 );
             w() *= s;
         }
         else if ( largest == 1 )
@@ -337,7 +358,7 @@ void Quaternion< T >::set( const Matrix< D, D, T >& M )
 
             z() = 0.25 / s;
 
-            w() = M( 0,1 ) - M( 1,0 );
+            w() = M( 1,0 ) - M( 0,1 );
             w() *= s;
         }
         else
@@ -350,6 +371,49 @@ void Quaternion< T >::set( const Matrix< D, D, T >& M )
 
 
 
+template < typename T > template< size_t D >
+inline void Quaternion< T >::set_branchless( const Matrix< D, D, T >& M )
+{
+    // direct column-major access keeps this inlinable into batch loops
+    const T* m = M.array;
+    const T m00 = m[ 0 ],     m10 = m[ 1 ],         m20 = m[ 2 ];
+    const T m01 = m[ D ],     m11 = m[ D + 1 ],     m21 = m[ D + 2 ];
+    const T m02 = m[ 2 * D ], m12 = m[ 2 * D + 1 ], m22 = m[ 2 * D + 2 ];
+
+    // four times the squares of w, x, y and z
+    const T tw = T( 1 ) + m00 + m11 + m22;
+    const T tx = T( 1 ) + m00 - m11 - m22;
+    const T ty = T( 1 ) - m00 + m11 - m22;
+    const T tz = T( 1 ) - m00 - m11 + m22;
+
+    const T dx = m21 - m12;
+    const T dy = m02 - m20;
+    const T dz = m10 - m01;
+    const T sxy = m01 + m10;
+    const T sxz = m02 + m20;
+    const T syz = m12 + m21;
+
+    // solve for the largest component, the others follow from the
+    // off-diagonal elements. The cases are blended with exclusive 0/1
+    // weights, compilers turn selects into branches too eagerly.
+    const T t = std::max( std::max( tw, tx ), std::max( ty, tz ));
+    const bool isW = tw == t;
+    const bool isX = !isW & ( tx == t );
+    const bool isY = !isW & !isX & ( ty == t );
+    const T cw = isW;
+    const T cx = isX;
+    const T cy = isY;
+    const T cz = T( 1 ) - cw - cx - cy;
+    const T s = T( 0.5 ) / std::sqrt( t );
+
+    x() = s * ( cw * dx + cx * t   + cy * sxy + cz * sxz );
+    y() = s * ( cw * dy + cx * sxy + cy * t   + cz * syz );
+    z() = s * ( cw * dz + cx * sxz + cy * syz + cz * t );
+    w() = s * ( cw * t  + cx * dx  + cy * dy  + cz * dz );
+}
+
+
+
 template < typename T >
 void Quaternion< T >::zero()
 {
@@ -882,6 +946,20 @@ Quaternion< T > Quaternion< T >::rotate_z( T theta, const Vector< 3, T >& a )
 
 
 
+template< typename T >
+Vector< 3, T > Quaternion< T >::rotate( const Vector< 3, T >& a ) const
+{
+    // v' = v + w * t + xyz x t, with t = 2 * xyz x v
+    const Vector< 3, T > t( 2 * ( y() * a.z() - z() * a.y( )),
+                            2 * ( z() * a.x() - x() * a.z( )),
+                            2 * ( x() * a.y() - y() * a.x( )));
+    return Vector< 3, T >( a.x() + w() * t.x() + y() * t.z() - z() * t.y(),
+                           a.y() + w() * t.y() + z() * t.x() - x() * t.z(),
+                           a.z() + w() * t.z() + x() * t.y() - y() * t.x( ));
+}
+
+
+
 template < typename T >
 Matrix< 3, 3, T >
 Quaternion< T >::get_rotation_matrix() const
@@ -963,6 +1041,36 @@ slerp( T a, const Quaternion< T >& p, const Quaternion< T >& q, const T epsilon
 }
 
 
+template< typename T >
+Quaternion< T > Quaternion< T >::
+nlerp( T a, const Quaternion< T >& p, const Quaternion< T >& q )
+{
+    const T b = p.dot( q ) < 0 ? -a : a;
+    Quaternion< T > result = p * ( 1 - a ) + q * b;
+    result.normalize();
+    return result;
+}
+
+
+template< typename T >
+Quaternion< T > Quaternion< T >::
+fast_slerp( T a, const Quaternion< T >& p, const Quaternion< T >& q )
+{
+    const T cosine = p.dot( q );
+    const T d = std::abs( cosine );
+
+    // correct the nlerp parameter towards the constant speed of slerp
+    const T A = 1.0904 + d * ( -3.2452 + d * ( 3.55645 - d * 1.43519 ));
+    const T B = 0.848013 + d * ( -1.06021 + d * 0.215638 );
+    const T k = A * ( a - 0.5 ) * ( a - 0.5 ) + B;
+    const T b = a + a * ( a - 0.5 ) * ( a - 1 ) * k;
+
+    Quaternion< T > result = p * ( 1 - b ) + q * ( cosine < 0 ? -b : b );
+    result.normalize();
+    return result;
+}
+
+
 template < typename T >
 Quaternion< T >& Quaternion< T >::operator=(const Quaternion& other)
 {
@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__QUATERNION_BATCH__HPP
+#define VMMLIB__QUATERNION_BATCH__HPP
+
+#include <vmmlib/vmmlib_config.hpp>
+#include <vmmlib/exception.hpp>
+#include <vmmlib/instrument.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// - declaration - //
+
+namespace vmml
+{
+
+/**
+ * An array of quaternions in structure-of-arrays layout.
+ *
+ * All x, y, z and w components are stored in separate contiguous arrays, so
+ * that the batch operations below are simple element-wise loops which the
+ * compiler vectorizes to process 4 (SSE) or 8 (AVX) quaternions per
+ * instruction. Results are identical to the corresponding Quaternion member
+ * functions up to floating point rounding.
+ */
+template< typename T > class QuaternionBatch
+{
+public:
+    explicit QuaternionBatch( size_t size_ = 0 );
+
+    size_t size() const { return _x.size(); }
+    void resize( size_t size_ );
+
+    void set( size_t index, const Quaternion< T >& q );
+    Quaternion< T > get( size_t index ) const;
+
+    // copies count quaternions from AoS layout, resizes to count
+    void set( const Quaternion< T >* quaternions, size_t count );
+
+    // converts count rotation matrices (top-left 3x3) using
+    // Quaternion::set_branchless(), resizes to count
+    template< size_t D >
+    void set( const Matrix< D, D, T >* matrices, size_t count );
+    // copies the first count quaternions to AoS layout
+    void get( Quaternion< T >* quaternions, size_t count ) const;
+
+    T* x() { return _x.data(); }
+    T* y() { return _y.data(); }
+    T* z() { return _z.data(); }
+    T* w() { return _w.data(); }
+    const T* x() const { return _x.data(); }
+    const T* y() const { return _y.data(); }
+    const T* z() const { return _z.data(); }
+    const T* w() const { return _w.data(); }
+
+    // (this)[i] = left[i] * right[i], resizes to the size of left. (this) may
+    // be left or right, which must have the same size.
+    void multiply( const QuaternionBatch& left, const QuaternionBatch& right );
+
+    // (this)[i] = Quaternion::slerp( a[i], p[i], q[i] ), resp. fast_slerp,
+    // resizes to the size of p, which must be the size of q. All quaternions
+    // must be unit quaternions.
+    void slerp( const QuaternionBatch& p, const QuaternionBatch& q,
+                const T* a );
+    void fast_slerp( const QuaternionBatch& p, const QuaternionBatch& q,
+                     const T* a );
+
+    // normalizes all quaternions, zero quaternions are left unchanged
+    void normalize();
+
+    // rotates the vector ( x[i], y[i], z[i] ) by quaternion i, in place. The
+    // three arrays must not overlap.
+    void rotate( T* x_, T* y_, T* z_ ) const;
+
+    // computes the rotation matrix of each quaternion, D >= 3. Only the
+    // top-left 3x3 part of the result matrices is written.
+    template< size_t D >
+    void get_rotation_matrices( Matrix< D, D, T >* result ) const;
+
+private:
+    static void _multiply( const T* VMMLIB_RESTRICT ax, const T* VMMLIB_RESTRICT ay,
+                           const T* VMMLIB_RESTRICT az, const T* VMMLIB_RESTRICT aw,
+                           const T* VMMLIB_RESTRICT bx, const T* VMMLIB_RESTRICT by,
+                           const T* VMMLIB_RESTRICT bz, const T* VMMLIB_RESTRICT bw,
+                           T* VMMLIB_RESTRICT rx, T* VMMLIB_RESTRICT ry,
+                           T* VMMLIB_RESTRICT rz, T* VMMLIB_RESTRICT rw,
+                           size_t count );
+    template< bool fast >
+    static void _slerp( const T* VMMLIB_RESTRICT px, const T* VMMLIB_RESTRICT py,
+                        const T* VMMLIB_RESTRICT pz, const T* VMMLIB_RESTRICT pw,
+                        const T* VMMLIB_RESTRICT qx, const T* VMMLIB_RESTRICT qy,
+                        const T* VMMLIB_RESTRICT qz, const T* VMMLIB_RESTRICT qw,
+                        const T* VMMLIB_RESTRICT a,
+                        T* VMMLIB_RESTRICT rx, T* VMMLIB_RESTRICT ry,
+                        T* VMMLIB_RESTRICT rz, T* VMMLIB_RESTRICT rw,
+                        size_t count );
+    static void _rotate( const T* VMMLIB_RESTRICT qx, const T* VMMLIB_RESTRICT qy,
+                         const T* VMMLIB_RESTRICT qz, const T* VMMLIB_RESTRICT qw,
+                         T* VMMLIB_RESTRICT x_, T* VMMLIB_RESTRICT y_,
+                         T* VMMLIB_RESTRICT z_, size_t count );
+
+    std::vector< T > _x;
+    std::vector< T > _y;
+    std::vector< T > _z;
+    std::vector< T > _w;
+};
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef QuaternionBatch< float >  QuaternionBatchf;
+typedef QuaternionBatch< double > QuaternionBatchd;
+#endif
+
+/** Rotate count vectors in SoA layout by the same quaternion, in place. */
+template< typename T >
+void rotate( const Quaternion< T >& q, T* x, T* y, T* z, size_t count );
+
+// - implementation - //
+
+template< typename T >
+QuaternionBatch< T >::QuaternionBatch( const size_t size_ )
+{
+    resize( size_ );
+}
+
+template< typename T >
+void QuaternionBatch< T >::resize( const size_t size_ )
+{
+    _x.resize( size_, 0 );
+    _y.resize( size_, 0 );
+    _z.resize( size_, 0 );
+    _w.resize( size_, 1 );
+}
+
+template< typename T >
+void QuaternionBatch< T >::set( const size_t index, const Quaternion< T >& q )
+{
+    _x[ index ] = q.x();
+    _y[ index ] = q.y();
+    _z[ index ] = q.z();
+    _w[ index ] = q.w();
+}
+
+template< typename T >
+Quaternion< T > QuaternionBatch< T >::get( const size_t index ) const
+{
+    return Quaternion< T >( _x[ index ], _y[ index ], _z[ index ],
+                            _w[ index ] );
+}
+
+template< typename T >
+void QuaternionBatch< T >::set( const Quaternion< T >* quaternions,
+                                const size_t count )
+{
+    resize( count );
+    for( size_t i = 0; i < count; ++i )
+        set( i, quaternions[ i ] );
+}
+
+template< typename T > template< size_t D >
+void QuaternionBatch< T >::set( const Matrix< D, D, T >* matrices,
+                                const size_t count )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "QuaternionBatch::set" );
+    resize( count );
+    T* VMMLIB_RESTRICT x_ = x();
+    T* VMMLIB_RESTRICT y_ = y();
+    T* VMMLIB_RESTRICT z_ = z();
+    T* VMMLIB_RESTRICT w_ = w();
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        Quaternion< T > q;
+        q.set_branchless( matrices[ i ] );
+        x_[ i ] = q.x();
+        y_[ i ] = q.y();
+        z_[ i ] = q.z();
+        w_[ i ] = q.w();
+    }
+}
+
+template< typename T >
+void QuaternionBatch< T >::get( Quaternion< T >* quaternions,
+                                const size_t count ) const
+{
+    for( size_t i = 0; i < count; ++i )
+        quaternions[ i ] = get( i );
+}
+
+template< typename T >
+void QuaternionBatch< T >::multiply( const QuaternionBatch& left,
+                                     const QuaternionBatch& right )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "QuaternionBatch::multiply" );
+    if( left.size() != right.size( ))
+    {
+        VMMLIB_ERROR( "QuaternionBatch::multiply - size mismatch",
+                      VMMLIB_HERE );
+        return;
+    }
+    if( this == &left || this == &right )
+    {
+        // the kernel requires non-overlapping arrays
+        QuaternionBatch result;
+        result.multiply( left, right );
+        std::swap( *this, result );
+        return;
+    }
+
+    resize( left.size( ));
+    _multiply( left.x(), left.y(), left.z(), left.w(),
+               right.x(), right.y(), right.z(), right.w(),
+               x(), y(), z(), w(), size( ));
+}
+
+template< typename T >
+void QuaternionBatch< T >::_multiply( const T* VMMLIB_RESTRICT ax,
+                                      const T* VMMLIB_RESTRICT ay,
+                                      const T* VMMLIB_RESTRICT az,
+                                      const T* VMMLIB_RESTRICT aw,
+                                      const T* VMMLIB_RESTRICT bx,
+                                      const T* VMMLIB_RESTRICT by,
+                                      const T* VMMLIB_RESTRICT bz,
+                                      const T* VMMLIB_RESTRICT bw,
+                                      T* VMMLIB_RESTRICT rx,
+                                      T* VMMLIB_RESTRICT ry,
+                                      T* VMMLIB_RESTRICT rz,
+                                      T* VMMLIB_RESTRICT rw,
+                                      const size_t count )
+{
+    for( size_t i = 0; i < count; ++i )
+    {
+        const T x0 = ax[i], y0 = ay[i], z0 = az[i], w0 = aw[i];
+        const T x1 = bx[i], y1 = by[i], z1 = bz[i], w1 = bw[i];
+
+        rx[i] = w0 * x1 + x0 * w1 + y0 * z1 - z0 * y1;
+        ry[i] = w0 * y1 + y0 * w1 + z0 * x1 - x0 * z1;
+        rz[i] = w0 * z1 + z0 * w1 + x0 * y1 - y0 * x1;
+        rw[i] = w0 * w1 - x0 * x1 - y0 * y1 - z0 * z1;
+    }
+}
+
+template< typename T >
+void QuaternionBatch< T >::slerp( const QuaternionBatch& p,
+                                  const QuaternionBatch& q, const T* a )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "QuaternionBatch::slerp" );
+    if( p.size() != q.size( ))
+    {
+        VMMLIB_ERROR( "QuaternionBatch::slerp - size mismatch", VMMLIB_HERE );
+        return;
+    }
+    if( this == &p || this == &q )
+    {
+        QuaternionBatch result;
+        result.slerp( p, q, a );
+        std::swap( *this, result );
+        return;
+    }
+
+    resize( p.size( ));
+    _slerp< false >( p.x(), p.y(), p.z(), p.w(), q.x(), q.y(), q.z(), q.w(),
+                     a, x(), y(), z(), w(), size( ));
+}
+
+template< typename T >
+void QuaternionBatch< T >::fast_slerp( const QuaternionBatch& p,
+                                       const QuaternionBatch& q, const T* a )
+{
+    VMMLIB_INSTRUMENT_SCOPE( "QuaternionBatch::fast_slerp" );
+    if( p.size() != q.size( ))
+    {
+        VMMLIB_ERROR( "QuaternionBatch::fast_slerp - size mismatch", VMMLIB_HERE );
+        return;
+    }
+    if( this == &p || this == &q )
+    {
+        QuaternionBatch result;
+        result.fast_slerp( p, q, a );
+        std::swap( *this, result );
+        return;
+    }
+
+    resize( p.size( ));
+    _slerp< true >( p.x(), p.y(), p.z(), p.w(), q.x(), q.y(), q.z(), q.w(),
+                    a, x(), y(), z(), w(), size( ));
+}
+
+template< typename T > template< bool fast >
+void QuaternionBatch< T >::_slerp( const T* VMMLIB_RESTRICT px,
+                                   const T* VMMLIB_RESTRICT py,
+                                   const T* VMMLIB_RESTRICT pz,
+                                   const T* VMMLIB_RESTRICT pw,
+                                   const T* VMMLIB_RESTRICT qx,
+                                   const T* VMMLIB_RESTRICT qy,
+                                   const T* VMMLIB_RESTRICT qz,
+                                   const T* VMMLIB_RESTRICT qw,
+                                   const T* VMMLIB_RESTRICT a,
+                                   T* VMMLIB_RESTRICT rx,
+                                   T* VMMLIB_RESTRICT ry,
+                                   T* VMMLIB_RESTRICT rz,
+                                   T* VMMLIB_RESTRICT rw, const size_t count )
+{
+    // all cases are computed and selected without branches, so that the
+    // loop stays vectorizable
+    for( size_t i = 0; i < count; ++i )
+    {
+        const T cosine = px[i] * qx[i] + py[i] * qy[i] +
+                         pz[i] * qz[i] + pw[i] * qw[i];
+        const T d = std::abs( cosine );
+        const T t = a[i];
+        T c0, c1;
+
+        if( fast )
+        {
+            const T A = 1.0904 + d * ( -3.2452 + d * ( 3.55645 - d * 1.43519 ));
+            const T B = 0.848013 + d * ( -1.06021 + d * 0.215638 );
+            const T k = A * ( t - 0.5 ) * ( t - 0.5 ) + B;
+            c1 = t + t * ( t - 0.5 ) * ( t - 1 ) * k;
+            c0 = 1 - c1;
+        }
+        else
+        {
+            // linear interpolation for very small angles
+            const bool linear = d > T( 1 ) - std::numeric_limits< T >::epsilon();
+            const T sine = std::sqrt( linear ? T( 1 ) : 1 - d * d );
+            const T angle = std::atan2( sine, d );
+            c0 = linear ? 1 - t : std::sin(( 1 - t ) * angle ) / sine;
+            c1 = linear ? t : std::sin( t * angle ) / sine;
+        }
+        c1 = cosine < 0 ? -c1 : c1;
+
+        const T x_ = c0 * px[i] + c1 * qx[i];
+        const T y_ = c0 * py[i] + c1 * qy[i];
+        const T z_ = c0 * pz[i] + c1 * qz[i];
+        const T w_ = c0 * pw[i] + c1 * qw[i];
+        const T scale = T( 1 ) / std::sqrt( x_ * x_ + y_ * y_ + z_ * z_ +
+                                            w_ * w_ );
+        rx[i] = x_ * scale;
+        ry[i] = y_ * scale;
+        rz[i] = z_ * scale;
+        rw[i] = w_ * scale;
+    }
+}
+
+template< typename T >
+void QuaternionBatch< T >::normalize()
+{
+    const size_t count = size();
+    T* qx = x(); T* qy = y(); T* qz = z(); T* qw = w();
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        const T x_ = qx[i], y_ = qy[i], z_ = qz[i], w_ = qw[i];
+        const T squared = x_ * x_ + y_ * y_ + z_ * z_ + w_ * w_;
+        // select instead of branch to keep the loop vectorizable
+        const T scale = T( 1 ) / std::sqrt( squared > 0 ? squared : T( 1 ));
+        qx[i] = x_ * scale;
+        qy[i] = y_ * scale;
+        qz[i] = z_ * scale;
+        qw[i] = w_ * scale;
+    }
+}
+
+template< typename T >
+void QuaternionBatch< T >::rotate( T* x_, T* y_, T* z_ ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "QuaternionBatch::rotate" );
+    _rotate( x(), y(), z(), w(), x_, y_, z_, size( ));
+}
+
+template< typename T >
+void QuaternionBatch< T >::_rotate( const T* VMMLIB_RESTRICT qx,
+                                    const T* VMMLIB_RESTRICT qy,
+                                    const T* VMMLIB_RESTRICT qz,
+                                    const T* VMMLIB_RESTRICT qw,
+                                    T* VMMLIB_RESTRICT x_,
+                                    T* VMMLIB_RESTRICT y_,
+                                    T* VMMLIB_RESTRICT z_, const size_t count )
+{
+    for( size_t i = 0; i < count; ++i )
+    {
+        // v' = v + w * t + q.xyz x t, with t = 2 * q.xyz x v
+        const T vx = x_[i], vy = y_[i], vz = z_[i];
+        const T tx = 2 * ( qy[i] * vz - qz[i] * vy );
+        const T ty = 2 * ( qz[i] * vx - qx[i] * vz );
+        const T tz = 2 * ( qx[i] * vy - qy[i] * vx );
+
+        x_[i] = vx + qw[i] * tx + qy[i] * tz - qz[i] * ty;
+        y_[i] = vy + qw[i] * ty + qz[i] * tx - qx[i] * tz;
+        z_[i] = vz + qw[i] * tz + qx[i] * ty - qy[i] * tx;
+    }
+}
+
+template< typename T > template< size_t D >
+void QuaternionBatch< T >::get_rotation_matrices( Matrix< D, D, T >* result )
+    const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "QuaternionBatch::get_rotation_matrices" );
+    const size_t count = size();
+    const T* qx = x(); const T* qy = y(); const T* qz = z(); const T* qw = w();
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        const T x2 = qx[i] * qx[i], y2 = qy[i] * qy[i], z2 = qz[i] * qz[i];
+        const T w2 = qw[i] * qw[i];
+        const T xy = qx[i] * qy[i], xz = qx[i] * qz[i], yz = qy[i] * qz[i];
+        const T wx = qw[i] * qx[i], wy = qw[i] * qy[i], wz = qw[i] * qz[i];
+
+        Matrix< D, D, T >& m = result[ i ];
+        m( 0, 0 ) = w2 + x2 - y2 - z2;
+        m( 0, 1 ) = 2 * ( xy - wz );
+        m( 0, 2 ) = 2 * ( xz + wy );
+        m( 1, 0 ) = 2 * ( xy + wz );
+        m( 1, 1 ) = w2 - x2 + y2 - z2;
+        m( 1, 2 ) = 2 * ( yz - wx );
+        m( 2, 0 ) = 2 * ( xz - wy );
+        m( 2, 1 ) = 2 * ( yz + wx );
+        m( 2, 2 ) = w2 - x2 - y2 + z2;
+    }
+}
+
+template< typename T >
+void rotate( const Quaternion< T >& q, T* x, T* y, T* z, const size_t count )
+{
+    const T qx = q.x(), qy = q.y(), qz = q.z(), qw = q.w();
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        const T vx = x[i], vy = y[i], vz = z[i];
+        const T tx = 2 * ( qy * vz - qz * vy );
+        const T ty = 2 * ( qz * vx - qx * vz );
+        const T tz = 2 * ( qx * vy - qy * vx );
+
+        x[i] = vx + qw * tx + qy * tz - qz * ty;
+        y[i] = vy + qw * ty + qz * tx - qx * tz;
+        z[i] = vz + qw * tz + qx * ty - qy * tx;
+    }
+}
+
+} // namespace vmml
+
+#endif
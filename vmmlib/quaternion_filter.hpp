@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__QUATERNION_FILTER__HPP
+#define VMMLIB__QUATERNION_FILTER__HPP
+
+#include <vmmlib/quaternion.hpp>
+
+// - declaration - //
+
+namespace vmml
+{
+
+/**
+ * Smooths a stream of unit quaternions.
+ *
+ * Like the LOWPASS_EXPONENTIAL mode of LowpassFilter, each sample is blended
+ * into the previous output, weighted by one minus the smooth factor.
+ * The blend interpolates along the shorter arc with Quaternion::fast_slerp(),
+ * so q and -q are the same orientation and the output stays normalized. O(1)
+ * per sample, without allocation.
+ */
+template< typename T > class QuaternionFilter
+{
+public:
+    /** @param F smooth factor in [0, 1), larger values smooth more */
+    explicit QuaternionFilter( const T F )
+        : _smooth_factor( F ), _empty( true ) {}
+
+    /**
+     * Add a unit quaternion and return the filtered orientation.
+     * The first sample after construction or reset() is passed through.
+     */
+    const Quaternion< T >& add( const Quaternion< T >& value );
+
+    const Quaternion< T >& get() const { return _value; }
+    const Quaternion< T >* operator->() const { return &_value; }
+    const Quaternion< T >& operator*() const { return _value; }
+
+    void set_smooth_factor( const T f ) { _smooth_factor = f; }
+    T get_smooth_factor() const { return _smooth_factor; }
+
+    /** Forget the filter state. */
+    void reset() { _empty = true; }
+
+private:
+    T _smooth_factor;
+    bool _empty;
+    Quaternion< T > _value;
+};
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef QuaternionFilter< float >  QuaternionFilterf;
+typedef QuaternionFilter< double > QuaternionFilterd;
+#endif
+
+// - implementation - //
+
+template< typename T > const Quaternion< T >&
+QuaternionFilter< T >::add( const Quaternion< T >& value )
+{
+    if( _empty )
+        _value = value;
+    else
+        _value = Quaternion< T >::fast_slerp( 1 - _smooth_factor, _value,
+                                              value );
+    _empty = false;
+    return _value;
+}
+
+} // namespace vmml
+
+#endif // include protection
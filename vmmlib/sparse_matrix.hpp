@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2006-2015, Visualization and Multimedia Lab,
+ *                          University of Zurich <http://vmml.ifi.uzh.ch>,
+ *                          Eyescale Software GmbH,
+ *                          Blue Brain Project, EPFL
+ *
+ * This file is part of VMMLib <https://github.com/VMML/vmmlib/>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.  Redistributions in binary
+ * form must reproduce the above copyright notice, this list of conditions and
+ * the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.  Neither the name of the Visualization and Multimedia
+ * Lab, University of Zurich nor the names of its contributors may be used to
+ * endorse or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VMMLIB__SPARSE_MATRIX__HPP
+#define VMMLIB__SPARSE_MATRIX__HPP
+
+#include <vmmlib/accumulation_type.hpp>
+#include <vmmlib/exception.hpp>
+#include <vmmlib/execution.hpp>
+#include <vmmlib/instrument.hpp>
+#include <vmmlib/matrix.hpp>
+#include <vmmlib/vector.hpp>
+#include <vmmlib/vmmlib_config.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// - declaration -
+
+namespace vmml
+{
+
+/**
+ * A matrix in compressed sparse row (CSR) format.
+ *
+ * Stores the values and column indices of the non-zero elements row by row,
+ * and the offset of each row into them, for matrices with mostly zero
+ * elements, e.g., thresholded Matrix factors. The dimensions are given at run
+ * time. The CSR arrays of a matrix are the compressed sparse column (CSC)
+ * arrays of its transpose, see get_transposed().
+ *
+ * Products accumulate in accumulation_type< T >.
+ */
+template< typename T >
+class SparseMatrix
+{
+public:
+    typedef typename accumulation_type< T >::type accumulator_type;
+
+    /** One element for building a matrix. */
+    struct Triplet
+    {
+        Triplet( const size_t row_, const size_t column_, const T value_ )
+            : row( row_ ), column( column_ ), value( value_ ) {}
+
+        size_t row;
+        size_t column;
+        T value;
+    };
+
+    /** Create an empty rows x columns matrix. */
+    explicit SparseMatrix( size_t rows = 0, size_t columns = 0 );
+
+    /**
+     * Create a rows x columns matrix from triplets in any order, summing the
+     * values of triplets for the same element. Triplets out of bounds are an
+     * error, leaving an empty matrix.
+     */
+    SparseMatrix( size_t rows, size_t columns,
+                  const std::vector< Triplet >& triplets );
+
+    /** Create a matrix of the elements of a Matrix larger than threshold. */
+    template< size_t M, size_t N >
+    explicit SparseMatrix( const Matrix< M, N, T >& matrix, T threshold = 0 );
+
+    size_t get_rows() const { return _rows; }
+    size_t get_columns() const { return _columns; }
+
+    /** @return the number of stored elements. */
+    size_t nnz() const { return _values.size(); }
+
+    /** @return the element at the given row and column. */
+    T get( size_t row, size_t column ) const;
+
+    /** @return the offsets of the rows into the column indices and values. */
+    const std::vector< size_t >& get_row_offsets() const { return _offsets; }
+    const std::vector< size_t >& get_column_indices() const
+        { return _indices; }
+    const std::vector< T >& get_values() const { return _values; }
+
+    /** @return the transposed matrix. */
+    SparseMatrix get_transposed() const;
+
+    /** Write the matrix to a dense Matrix of the same size. */
+    template< size_t M, size_t N >
+    void get_dense( Matrix< M, N, T >& result ) const;
+
+    /**
+     * result = this * x, for x and result with get_columns() and get_rows()
+     * elements. Ranges of rows run as given by the execution policy.
+     */
+    void multiply( const T* VMMLIB_RESTRICT x, T* VMMLIB_RESTRICT result,
+                   const ExecutionPolicy& policy = ExecutionPolicy( )) const;
+
+    template< size_t M, size_t N >
+    void multiply( const Vector< N, T >& x, Vector< M, T >& result,
+                   const ExecutionPolicy& policy = ExecutionPolicy( )) const;
+
+    /** result = this * right, like multiply() for each column of right. */
+    template< size_t M, size_t N, size_t P >
+    void multiply( const Matrix< N, P, T >& right, Matrix< M, P, T >& result,
+                   const ExecutionPolicy& policy = ExecutionPolicy( )) const;
+
+    /**
+     * result = transpose( this ) * x, for x and result with get_rows() and
+     * get_columns() elements. Scatters into result sequentially; multiply the
+     * transposed matrix to run in parallel.
+     */
+    void multiply_transposed( const T* VMMLIB_RESTRICT x,
+                              T* VMMLIB_RESTRICT result ) const;
+
+    template< size_t M, size_t N >
+    void multiply_transposed( const Vector< M, T >& x,
+                              Vector< N, T >& result ) const;
+
+    friend std::ostream& operator << ( std::ostream& os,
+                                       const SparseMatrix& matrix )
+    {
+        os << matrix._rows << "x" << matrix._columns << ", " << matrix.nnz()
+           << " non-zeros" << std::endl;
+        for( size_t row = 0; row < matrix._rows; ++row )
+            for( size_t i = matrix._offsets[ row ];
+                 i < matrix._offsets[ row + 1 ]; ++i )
+            {
+                os << "(" << row << ", " << matrix._indices[ i ] << ") "
+                   << matrix._values[ i ] << std::endl;
+            }
+        return os;
+    }
+
+private:
+    bool _check_size( size_t rows, size_t columns ) const;
+
+    size_t _rows;
+    size_t _columns;
+    std::vector< size_t > _offsets; // rows + 1 entries
+    std::vector< size_t > _indices;
+    std::vector< T > _values;
+};
+
+#ifndef VMMLIB_NO_TYPEDEFS
+typedef SparseMatrix< float > SparseMatrixf;
+typedef SparseMatrix< double > SparseMatrixd;
+#endif
+
+// - implementation - //
+
+template< typename T >
+SparseMatrix< T >::SparseMatrix( const size_t rows, const size_t columns )
+    : _rows( rows )
+    , _columns( columns )
+    , _offsets( rows + 1, 0 )
+{}
+
+template< typename T >
+SparseMatrix< T >::SparseMatrix( const size_t rows, const size_t columns,
+                                 const std::vector< Triplet >& triplets )
+    : _rows( rows )
+    , _columns( columns )
+    , _offsets( rows + 1, 0 )
+{
+    // leave an empty matrix if VMMLIB_ERROR does not throw
+    for( const Triplet& triplet : triplets )
+    {
+        if( triplet.row >= rows || triplet.column >= columns )
+        {
+            VMMLIB_ERROR( "SparseMatrix - triplet index out of bounds",
+                          VMMLIB_HERE );
+            return;
+        }
+    }
+
+    // counting sort by row, then sort and merge the columns of each row
+    for( const Triplet& triplet : triplets )
+        ++_offsets[ triplet.row + 1 ];
+    for( size_t row = 0; row < rows; ++row )
+        _offsets[ row + 1 ] += _offsets[ row ];
+
+    std::vector< std::pair< size_t, T > > elements( triplets.size( ));
+    std::vector< size_t > next( _offsets.begin(), _offsets.end() - 1 );
+    for( const Triplet& triplet : triplets )
+        elements[ next[ triplet.row ]++ ] =
+            std::make_pair( triplet.column, triplet.value );
+
+    _indices.reserve( elements.size( ));
+    _values.reserve( elements.size( ));
+    size_t begin = 0;
+    for( size_t row = 0; row < rows; ++row )
+    {
+        const size_t end = _offsets[ row + 1 ];
+        std::sort( elements.begin() + begin, elements.begin() + end,
+                   []( const std::pair< size_t, T >& a,
+                       const std::pair< size_t, T >& b )
+                       { return a.first < b.first; });
+
+        _offsets[ row ] = _indices.size();
+        for( size_t i = begin; i < end; ++i )
+        {
+            if( i > begin && elements[ i ].first == _indices.back( ))
+                _values.back() += elements[ i ].second;
+            else
+            {
+                _indices.push_back( elements[ i ].first );
+                _values.push_back( elements[ i ].second );
+            }
+        }
+        begin = end;
+    }
+    _offsets[ rows ] = _indices.size();
+}
+
+template< typename T >
+template< size_t M, size_t N >
+SparseMatrix< T >::SparseMatrix( const Matrix< M, N, T >& matrix,
+                                 const T threshold )
+    : _rows( M )
+    , _columns( N )
+    , _offsets( M + 1, 0 )
+{
+    // same elements as Matrix::nnz( threshold ) counts
+    for( size_t row = 0; row < M; ++row )
+    {
+        for( size_t column = 0; column < N; ++column )
+        {
+            const T value = matrix.array[ column * M + row ];
+            if( value > threshold || value < -threshold )
+            {
+                _indices.push_back( column );
+                _values.push_back( value );
+            }
+        }
+        _offsets[ row + 1 ] = _indices.size();
+    }
+}
+
+template< typename T >
+T SparseMatrix< T >::get( const size_t row, const size_t column ) const
+{
+    const std::vector< size_t >::const_iterator begin =
+        _indices.begin() + _offsets[ row ];
+    const std::vector< size_t >::const_iterator end =
+        _indices.begin() + _offsets[ row + 1 ];
+    const std::vector< size_t >::const_iterator i =
+        std::lower_bound( begin, end, column );
+    return i != end && *i == column ? _values[ i - _indices.begin() ] : T( 0 );
+}
+
+template< typename T >
+SparseMatrix< T > SparseMatrix< T >::get_transposed() const
+{
+    SparseMatrix transposed( _columns, _rows );
+    for( const size_t column : _indices )
+        ++transposed._offsets[ column + 1 ];
+    for( size_t column = 0; column < _columns; ++column )
+        transposed._offsets[ column + 1 ] += transposed._offsets[ column ];
+
+    // rows are visited in order, keeping the new rows sorted
+    transposed._indices.resize( nnz( ));
+    transposed._values.resize( nnz( ));
+    std::vector< size_t > next( transposed._offsets.begin(),
+                                transposed._offsets.end() - 1 );
+    for( size_t row = 0; row < _rows; ++row )
+        for( size_t i = _offsets[ row ]; i < _offsets[ row + 1 ]; ++i )
+        {
+            const size_t j = next[ _indices[ i ]]++;
+            transposed._indices[ j ] = row;
+            transposed._values[ j ] = _values[ i ];
+        }
+    return transposed;
+}
+
+template< typename T >
+bool SparseMatrix< T >::_check_size( const size_t rows,
+                                     const size_t columns ) const
+{
+    if( rows == _rows && columns == _columns )
+        return true;
+    VMMLIB_ERROR( "SparseMatrix - matrix size mismatch", VMMLIB_HERE );
+    return false;
+}
+
+template< typename T >
+template< size_t M, size_t N >
+void SparseMatrix< T >::get_dense( Matrix< M, N, T >& result ) const
+{
+    if( !_check_size( M, N ))
+        return;
+
+    result.zero();
+    for( size_t row = 0; row < M; ++row )
+        for( size_t i = _offsets[ row ]; i < _offsets[ row + 1 ]; ++i )
+            result.array[ _indices[ i ] * M + row ] = _values[ i ];
+}
+
+template< typename T >
+void SparseMatrix< T >::multiply( const T* VMMLIB_RESTRICT x,
+                                  T* VMMLIB_RESTRICT result,
+                                  const ExecutionPolicy& policy ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "SparseMatrix::multiply" );
+    const size_t* offsets = _offsets.data();
+    const size_t* indices = _indices.data();
+    const T* values = _values.data();
+    parallel_for( policy, _rows, [&]( const size_t begin, const size_t end )
+    {
+        for( size_t row = begin; row < end; ++row )
+        {
+            accumulator_type sum = accumulator_type( 0 );
+            for( size_t i = offsets[ row ]; i < offsets[ row + 1 ]; ++i )
+                sum += accumulator_type( values[ i ] ) *
+                       accumulator_type( x[ indices[ i ]] );
+            result[ row ] = T( sum );
+        }
+    }, _rows ? nnz() / _rows + 1 : 1 );
+}
+
+template< typename T >
+template< size_t M, size_t N >
+void SparseMatrix< T >::multiply( const Vector< N, T >& x,
+                                  Vector< M, T >& result,
+                                  const ExecutionPolicy& policy ) const
+{
+    if( _check_size( M, N ))
+        multiply( x.array, result.array, policy );
+}
+
+template< typename T >
+template< size_t M, size_t N, size_t P >
+void SparseMatrix< T >::multiply( const Matrix< N, P, T >& right,
+                                  Matrix< M, P, T >& result,
+                                  const ExecutionPolicy& policy ) const
+{
+    if( !_check_size( M, N ))
+        return;
+
+    // the columns of the column-major matrices are dense vectors
+    VMMLIB_INSTRUMENT_SCOPE( "SparseMatrix::multiply" );
+    parallel_for( policy, M, [&]( const size_t begin, const size_t end )
+    {
+        accumulator_type sums[ P ];
+        for( size_t row = begin; row < end; ++row )
+        {
+            for( size_t column = 0; column < P; ++column )
+                sums[ column ] = accumulator_type( 0 );
+
+            for( size_t i = _offsets[ row ]; i < _offsets[ row + 1 ]; ++i )
+            {
+                const accumulator_type value( _values[ i ] );
+                const T* source = right.array + _indices[ i ];
+                for( size_t column = 0; column < P; ++column )
+                    sums[ column ] += value *
+                                      accumulator_type( source[ column * N ]);
+            }
+
+            for( size_t column = 0; column < P; ++column )
+                result.array[ column * M + row ] = T( sums[ column ] );
+        }
+    }, ( nnz() / M + 1 ) * P );
+}
+
+template< typename T >
+void SparseMatrix< T >::multiply_transposed( const T* VMMLIB_RESTRICT x,
+                                             T* VMMLIB_RESTRICT result ) const
+{
+    VMMLIB_INSTRUMENT_SCOPE( "SparseMatrix::multiply_transposed" );
+    std::vector< accumulator_type > sums( _columns, accumulator_type( 0 ));
+    for( size_t row = 0; row < _rows; ++row )
+    {
+        const accumulator_type factor( x[ row ] );
+        for( size_t i = _offsets[ row ]; i < _offsets[ row + 1 ]; ++i )
+            sums[ _indices[ i ]] += accumulator_type( _values[ i ] ) * factor;
+    }
+    for( size_t column = 0; column < _columns; ++column )
+        result[ column ] = T( sums[ column ] );
+}
+
+template< typename T >
+template< size_t M, size_t N >
+void SparseMatrix< T >::multiply_transposed( const Vector< M, T >& x,
+                                             Vector< N, T >& result ) const
+{
+    if( _check_size( M, N ))
+        multiply_transposed( x.array, result.array );
+}
+
+} // namespace vmml
+
+#endif // include protection
@@ -34,6 +34,7 @@
 #define VMMLIB__VECTOR__HPP
 
 #include <vmmlib/vmmlib_config.hpp>
+#include <vmmlib/accumulation_type.hpp>
 #include <vmmlib/math.hpp>
 #include <vmmlib/enable_if.hpp>
 #include <vmmlib/exception.hpp>
@@ -225,6 +226,8 @@ public:
     // note: there's also a free function:
     // T dot( const vector<>, const vector<> );
     inline T dot( const Vector& other ) const;
+    // same, accumulating in A, see accumulation_type
+    template< typename A > inline A dot( const Vector& other ) const;
 
 
     // normalize the vector
@@ -1127,6 +1130,18 @@ inline T Vector< M, T >::dot( const Vector< M, T >& other ) const
 }
 
 
+template< size_t M, typename T >
+template< typename A >
+inline A Vector< M, T >::dot( const Vector< M, T >& other ) const
+{
+    A tmp = A( 0 );
+    for( size_t index = 0; index < M; ++index )
+        tmp += A( array[ index ] ) * A( other.array[ index ] );
+
+    return tmp;
+}
+
+
 template< size_t M, typename T >
 inline T Vector< M, T >::normalize()
 {
@@ -37,12 +37,29 @@
 #define VMMLIB__VMMLIB__HPP
 
 #include <vmmlib/aabb.hpp>
+#include <vmmlib/accumulation_type.hpp>
+#include <vmmlib/affine_transform.hpp>
+#include <vmmlib/culling_statistics.hpp>
+#include <vmmlib/dual_quaternion.hpp>
+#include <vmmlib/execution.hpp>
 #include <vmmlib/frustum.hpp>
 #include <vmmlib/frustum_culler.hpp>
+#include <vmmlib/frustum_grid.hpp>
+#include <vmmlib/half.hpp>
+#include <vmmlib/instrument.hpp>
 #include <vmmlib/intersection.hpp>
 #include <vmmlib/lowpass_filter.hpp>
+#include <vmmlib/lowpass_filter_bank.hpp>
 #include <vmmlib/matrix.hpp>
+#include <vmmlib/multi_frustum_culler.hpp>
+#include <vmmlib/obb.hpp>
+#include <vmmlib/occlusion_buffer.hpp>
+#include <vmmlib/one_euro_filter.hpp>
+#include <vmmlib/quantized_aabb.hpp>
 #include <vmmlib/quaternion.hpp>
+#include <vmmlib/quaternion_batch.hpp>
+#include <vmmlib/quaternion_filter.hpp>
+#include <vmmlib/sparse_matrix.hpp>
 #include <vmmlib/vector.hpp>
 #include <vmmlib/version.hpp>
 
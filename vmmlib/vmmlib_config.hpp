@@ -56,6 +56,15 @@ typedef SSIZE_T ssize_t;
 #  define VMMLIB_THROW_EXCEPTIONS
 #endif
 
+// Marks the array arguments of batch kernels as not aliasing each other,
+// which lets the compiler vectorize loops over many arrays without runtime
+// overlap checks.
+#if defined( __GNUC__ ) || defined( _MSC_VER )
+#  define VMMLIB_RESTRICT __restrict
+#else
+#  define VMMLIB_RESTRICT
+#endif
+
 // Define VMMLIB_NO_TYPEDEFS to prevent creating typedefs for common types (e.g. Vector2i)
 //#define VMMLIB_NO_TYPEDEFS
 